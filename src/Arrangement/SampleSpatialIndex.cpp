@@ -0,0 +1,55 @@
+#include "SampleSpatialIndex.h"
+
+#include <algorithm>
+
+void SampleSpatialIndex::setSample(int id, float startFrame, float endFrame, float lowestFreqRatio,
+                                   float highestFreqRatio)
+{
+    if (id < 0)
+    {
+        return;
+    }
+
+    if (id >= (int)frequencyBands.size())
+    {
+        frequencyBands.resize((size_t)id + 1, {0.0f, 0.0f});
+    }
+
+    frequencyBands[(size_t)id] = {lowestFreqRatio, highestFreqRatio};
+    timeRanges.setRange(id, startFrame, endFrame);
+}
+
+void SampleSpatialIndex::removeSample(int id)
+{
+    timeRanges.removeRange(id);
+}
+
+void SampleSpatialIndex::clear()
+{
+    timeRanges = TimeRangeIndex();
+    frequencyBands.clear();
+}
+
+void SampleSpatialIndex::findSamples(float startFrame, float endFrame, std::vector<int> &ids)
+{
+    timeRanges.findOverlapping(startFrame, endFrame, ids);
+    std::sort(ids.begin(), ids.end());
+}
+
+void SampleSpatialIndex::findSamples(float startFrame, float endFrame, float lowestFreqRatio, float highestFreqRatio,
+                                     std::vector<int> &ids)
+{
+    findSamples(startFrame, endFrame, ids);
+
+    ids.erase(std::remove_if(ids.begin(), ids.end(),
+                             [this, lowestFreqRatio, highestFreqRatio](int id) {
+                                 const FrequencyBand &band = frequencyBands[(size_t)id];
+                                 return band.lowest > highestFreqRatio || band.highest < lowestFreqRatio;
+                             }),
+              ids.end());
+}
+
+int SampleSpatialIndex::size() const
+{
+    return timeRanges.size();
+}
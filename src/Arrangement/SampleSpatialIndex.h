@@ -0,0 +1,79 @@
+#ifndef DEF_SAMPLE_SPATIAL_INDEX_HPP
+#define DEF_SAMPLE_SPATIAL_INDEX_HPP
+
+#include <vector>
+
+#include "../OpenGL/TimeRangeIndex.h"
+
+/**
+ * @brief      Finds the samples of the arrangement that are under a point or inside an area
+ *             without looking at all of them. Samples are indexed by their time range, and
+ *             each one keeps the frequency band its filters let through so that the candidates
+ *             found by time can be ruled out by frequency.
+ *             Frequencies are given as position ratios between 0 and 1, as returned by
+ *             UnitConverter::freqToPositionRatio.
+ *             Samples are identified by their index in the arrangement.
+ */
+class SampleSpatialIndex
+{
+  public:
+    /**
+     * @brief      Adds a sample or updates its position and filters.
+     *
+     * @param[in]  id                The sample index
+     * @param[in]  startFrame        The first frame of the sample in the arrangement
+     * @param[in]  endFrame          The last frame of the sample in the arrangement
+     * @param[in]  lowestFreqRatio   The position ratio of the high pass filter frequency
+     * @param[in]  highestFreqRatio  The position ratio of the low pass filter frequency
+     */
+    void setSample(int id, float startFrame, float endFrame, float lowestFreqRatio, float highestFreqRatio);
+
+    /**
+     * @brief      Removes a sample. Does nothing if it isn't in the index.
+     */
+    void removeSample(int id);
+
+    /**
+     * @brief      Removes all the samples.
+     */
+    void clear();
+
+    /**
+     * @brief      Lists the samples overlapping a time range, whatever their frequencies.
+     *
+     * @param[in]  startFrame  The first frame of the searched range
+     * @param[in]  endFrame    The last frame of the searched range
+     * @param      ids         The vector the sample indexes are written to, in increasing order.
+     */
+    void findSamples(float startFrame, float endFrame, std::vector<int> &ids);
+
+    /**
+     * @brief      Lists the samples overlapping a time range and a frequency band, bounds included.
+     *
+     * @param[in]  startFrame        The first frame of the searched range
+     * @param[in]  endFrame          The last frame of the searched range
+     * @param[in]  lowestFreqRatio   The lowest frequency position ratio of the searched band
+     * @param[in]  highestFreqRatio  The highest frequency position ratio of the searched band
+     * @param      ids               The vector the sample indexes are written to, in increasing order.
+     */
+    void findSamples(float startFrame, float endFrame, float lowestFreqRatio, float highestFreqRatio,
+                     std::vector<int> &ids);
+
+    /**
+     * @brief      Gets the number of samples in the index.
+     */
+    int size() const;
+
+  private:
+    struct FrequencyBand
+    {
+        float lowest;
+        float highest;
+    };
+
+    TimeRangeIndex timeRanges;
+    // frequency band of each sample index
+    std::vector<FrequencyBand> frequencyBands;
+};
+
+#endif // DEF_SAMPLE_SPATIAL_INDEX_HPP
@@ -957,6 +957,46 @@ std::vector<std::shared_ptr<Task>> SampleFilterRepeatChange::getOppositeTasks()
     return tasks;
 }
 
+/////////////////////////////////////////////
+
+SampleLinearPhaseChange::SampleLinearPhaseChange(int id, bool enabled)
+{
+    sampleId = id;
+    previousLinearPhase = false;
+    newLinearPhase = enabled;
+    recordableInHistory = false;
+}
+
+SampleLinearPhaseChange::SampleLinearPhaseChange(int id, bool previousEnabled, bool newEnabled)
+{
+    sampleId = id;
+    previousLinearPhase = previousEnabled;
+    newLinearPhase = newEnabled;
+    recordableInHistory = true;
+}
+
+std::string SampleLinearPhaseChange::marshal()
+{
+    json taskj = {{"object", "task"},
+                  {"task", "sample_linear_phase_change"},
+                  {"sample_id", sampleId},
+                  {"previous_linear_phase", previousLinearPhase},
+                  {"new_linear_phase", newLinearPhase},
+                  {"is_completed", isCompleted()},
+                  {"failed", hasFailed()},
+                  {"recordable_in_history", recordableInHistory},
+                  {"is_part_of_reversion", isPartOfReversion}};
+    return taskj.dump();
+}
+
+std::vector<std::shared_ptr<Task>> SampleLinearPhaseChange::getOppositeTasks()
+{
+    std::vector<std::shared_ptr<Task>> tasks;
+    auto task = std::make_shared<SampleLinearPhaseChange>(sampleId, previousLinearPhase);
+    tasks.push_back(task);
+    return tasks;
+}
+
 /////////////////////////////////////////////
 std::string QuittingTask::marshal()
 {
@@ -930,6 +930,48 @@ class SampleFilterRepeatChange : public Task
     bool isBroadcastRequest;
 };
 
+/**
+ * @brief      Switches a sample between the IIR filters and the linear phase FFT filter.
+ */
+class SampleLinearPhaseChange : public Task
+{
+  public:
+    /**
+     * @brief      Constructs a new instance. It will try to set this value
+     *             and will not be recorded in history.
+     *
+     * @param[in]  id       The identifier of the sample
+     * @param[in]  enabled  True to use the linear phase filter
+     */
+    SampleLinearPhaseChange(int id, bool enabled);
+
+    /**
+     * @brief      Constructs a new instance that will be recorded in history
+     *             once completed.
+     *
+     * @param[in]  id               The identifier of the sample
+     * @param[in]  previousEnabled  If the linear phase filter was used before
+     * @param[in]  newEnabled       If the linear phase filter is to be used
+     */
+    SampleLinearPhaseChange(int id, bool previousEnabled, bool newEnabled);
+
+    /**
+    Dumps the task data to a string as json
+    */
+    std::string marshal() override;
+
+    /**
+      Get the opposite task with flipped old and new value
+     */
+    std::vector<std::shared_ptr<Task>> getOppositeTasks() override;
+
+    // the identifier of the sample that we modify
+    int sampleId;
+
+    // is the linear phase filter used before and after the change ?
+    bool previousLinearPhase, newLinearPhase;
+};
+
 /**
  * @brief      This class describes a quitting task. It will
  *             exit the software and close the window.
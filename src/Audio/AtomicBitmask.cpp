@@ -0,0 +1,32 @@
+#include "AtomicBitmask.h"
+
+AtomicBitmask::AtomicBitmask()
+{
+    clear();
+}
+
+void AtomicBitmask::set(size_t id)
+{
+    if (id > SAMPLE_MAX_PLAYERS_USED)
+    {
+        return;
+    }
+    bits[id >> 6].fetch_or(uint64_t(1) << (id & 63), std::memory_order_relaxed);
+}
+
+void AtomicBitmask::reset(size_t id)
+{
+    if (id > SAMPLE_MAX_PLAYERS_USED)
+    {
+        return;
+    }
+    bits[id >> 6].fetch_and(~(uint64_t(1) << (id & 63)), std::memory_order_relaxed);
+}
+
+void AtomicBitmask::clear()
+{
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        bits[i].store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef DEF_ATOMIC_BITMASK_HPP
+#define DEF_ATOMIC_BITMASK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <set>
+
+#include "../Config.h"
+
+/**
+ * @brief      A fixed size set of sample player ids stored as bits, one per possible
+ *             player (up to SAMPLE_MAX_PLAYERS_USED). Membership tests are a single
+ *             relaxed atomic load, so the audio thread can query it for each player of
+ *             each block without locking. Writes are meant to be done by a single thread.
+ */
+class AtomicBitmask
+{
+  public:
+    AtomicBitmask();
+
+    /**
+     * @brief      Tells if the id is in the set. Safe to call from any thread, never blocks.
+     *
+     * @param[in]  id    The sample player id.
+     *
+     * @return     True if the bit is set, false otherwise or if out of bounds.
+     */
+    bool test(size_t id) const
+    {
+        if (id > SAMPLE_MAX_PLAYERS_USED)
+        {
+            return false;
+        }
+        return (bits[id >> 6].load(std::memory_order_relaxed) >> (id & 63)) & 1;
+    }
+
+    /**
+     * @brief      Adds the id to the set. Ignored if out of bounds.
+     */
+    void set(size_t id);
+
+    /**
+     * @brief      Removes the id from the set. Ignored if out of bounds.
+     */
+    void reset(size_t id);
+
+    /**
+     * @brief      Removes all ids from the set.
+     */
+    void clear();
+
+  private:
+    std::array<std::atomic<uint64_t>, SAMPLE_BITMASK_SIZE> bits;
+};
+
+#endif // DEF_ATOMIC_BITMASK_HPP
@@ -3,6 +3,7 @@
 #include "../Config.h"
 #include "FftRunner.h"
 #include "UnitConverter.h"
+#include <iomanip>
 #include <regex>
 #include <stdexcept>
 
@@ -61,16 +62,70 @@ std::string AudioFileBufferRef::hashDigest()
     std::stringstream ss;
     for (int i = 0; i < SHA_DIGEST_LENGTH; i++)
     {
-        ss << std::hex << hash[i];
+        // bytes must be printed as numbers and not as characters
+        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
     }
     std::string fullDigest;
     ss >> fullDigest;
     return fullDigest;
 }
 
+bool AudioFileBufferRef::hasAudio() const
+{
+    return data != nullptr || compressedData != nullptr;
+}
+
+int AudioFileBufferRef::getNumChannels() const
+{
+    if (data != nullptr)
+    {
+        return data->getNumChannels();
+    }
+    if (compressedData != nullptr)
+    {
+        return compressedData->getNumChannels();
+    }
+    return 0;
+}
+
+int AudioFileBufferRef::getNumSamples() const
+{
+    if (data != nullptr)
+    {
+        return data->getNumSamples();
+    }
+    if (compressedData != nullptr)
+    {
+        return compressedData->getNumSamples();
+    }
+    return 0;
+}
+
+const void *AudioFileBufferRef::getAudioIdentity() const
+{
+    if (data != nullptr)
+    {
+        return data.get();
+    }
+    return compressedData.get();
+}
+
+void AudioFileBufferRef::copyFrames(DecodedBlockCache &cache, float *dest, int channel, int startFrame,
+                                    int numFrames) const
+{
+    if (data != nullptr)
+    {
+        juce::FloatVectorOperations::copy(dest, data->getReadPointer(channel, startFrame), numFrames);
+    }
+    else if (compressedData != nullptr)
+    {
+        compressedData->copyFrames(cache, dest, channel, startFrame, numFrames);
+    }
+}
+
 //////////////////////////////////////////////////
 
-AudioFilesBufferStore::AudioFilesBufferStore() : allowUnusedBufferRelease(true)
+AudioFilesBufferStore::AudioFilesBufferStore() : allowUnusedBufferRelease(true), inMemoryCompression(false)
 {
     formatManager.registerBasicFormats();
 }
@@ -84,15 +139,20 @@ AudioFileBufferRef AudioFilesBufferStore::loadSample(std::string filePath)
     // safety measure for double slashes (windows and linux style)
     fullPath = fullPath.replace("//", "/");
     fullPath = fullPath.replace("\\\\", "\\");
+    std::string pathKey = fullPath.toStdString();
 
     // check cache and return cached item if present
     {
         juce::ScopedLock l(lock);
 
-        auto foundItem = audioBuffersCache.find(fullPath.toStdString());
-        if (foundItem != audioBuffersCache.end())
+        auto foundPath = digestsPerPath.find(pathKey);
+        if (foundPath != digestsPerPath.end())
         {
-            return foundItem->second;
+            auto foundItem = audioBuffersCache.find(foundPath->second);
+            if (foundItem != audioBuffersCache.end())
+            {
+                return getBufferAlias(foundItem->second, pathKey);
+            }
         }
     }
 
@@ -102,38 +162,80 @@ AudioFileBufferRef AudioFilesBufferStore::loadSample(std::string filePath)
     // abort if a failure happened
     if (reader.get() == nullptr)
     {
-        throw std::runtime_error(std::string() + "Unable to open reader for file: " + fullPath.toStdString());
+        throw std::runtime_error(std::string() + "Unable to open reader for file: " + pathKey);
     }
 
     // abort if size is not in allowed bounds
     auto duration = (float)reader->lengthInSamples / reader->sampleRate;
     if (duration >= SAMPLE_MAX_DURATION_SEC || reader->lengthInSamples <= SAMPLE_MIN_DURATION_FRAMES)
     {
-        throw std::runtime_error(std::string() + "File had unsupported length: " + fullPath.toStdString());
+        throw std::runtime_error(std::string() + "File had unsupported length: " + pathKey);
     }
 
     // load the audio data
     auto bufferPtr = std::make_shared<juce::AudioSampleBuffer>(reader->numChannels, reader->lengthInSamples);
     reader->read(bufferPtr.get(), 0, reader->lengthInSamples, 0, true, true);
 
+    // create the buffer object, which hashes the audio content
+    AudioFileBufferRef bufferBox(bufferPtr, pathKey, nullptr);
+    std::string digest = bufferBox.hashDigest();
+
+    // if the same audio was already loaded from another path, share it instead of processing it again
+    {
+        juce::ScopedLock l(lock);
+
+        auto foundItem = audioBuffersCache.find(digest);
+        if (foundItem != audioBuffersCache.end())
+        {
+            std::cout << "Audio of " << pathKey << " is already loaded from " << foundItem->second.fileFullPath
+                      << std::endl;
+            digestsPerPath[pathKey] = digest;
+            return getBufferAlias(foundItem->second, pathKey);
+        }
+    }
+
     // compute the short time FFTs
     auto rawShortTimeDfts = fftProcessing->performFft(bufferPtr);
 
     // apply the transformation to store FFTs
-    std::shared_ptr<std::vector<float>> storedFfts = copyRawFFTsToStorageFormat(rawShortTimeDfts);
+    bufferBox.storedFftData = copyRawFFTsToStorageFormat(rawShortTimeDfts);
+    bufferBox.hitGrid = std::make_shared<const SpectrogramHitGrid>(
+        *bufferBox.storedFftData, FftRunner::getNumFftFromNumSamples(bufferPtr->getNumSamples()),
+        bufferPtr->getNumChannels());
 
-    // finally, create the buffer object
-    AudioFileBufferRef bufferBox(bufferPtr, fullPath.toStdString(), storedFfts);
+    // swap the float data for its compressed version if asked to (hash and FFTs are computed from floats)
+    bool compress;
+    {
+        juce::ScopedLock l(lock);
+        compress = inMemoryCompression;
+    }
+    if (compress)
+    {
+        auto compressedBuffer = std::make_shared<const CompressedAudioBuffer>(*bufferPtr);
+        std::cout << "Compressed audio buffer of " << pathKey << " to "
+                  << (100 * compressedBuffer->getNumBytes()) /
+                         ((size_t)bufferPtr->getNumChannels() * (size_t)bufferPtr->getNumSamples() * sizeof(float))
+                  << "% of its size" << std::endl;
+        bufferBox.compressedData = compressedBuffer;
+        bufferBox.data = nullptr;
+    }
 
     // register in cache
     {
         juce::ScopedLock l(lock);
 
-        audioBuffersCache.insert(std::pair<std::string, AudioFileBufferRef>(fullPath.toStdString(), bufferBox));
+        digestsPerPath[pathKey] = digest;
+        // if another thread loaded the same audio in the meantime, insert keeps and returns its buffer
+        auto insertedItem = audioBuffersCache.insert(std::pair<std::string, AudioFileBufferRef>(digest, bufferBox));
+        return getBufferAlias(insertedItem.first->second, pathKey);
     }
+}
 
-    // return buffer
-    return bufferBox;
+AudioFileBufferRef AudioFilesBufferStore::getBufferAlias(const AudioFileBufferRef &cachedBuffer, std::string path)
+{
+    AudioFileBufferRef alias = cachedBuffer;
+    alias.fileFullPath = path;
+    return alias;
 }
 
 std::shared_ptr<std::vector<float>> AudioFilesBufferStore::copyRawFFTsToStorageFormat(
@@ -157,37 +259,35 @@ std::shared_ptr<std::vector<float>> AudioFilesBufferStore::copyRawFFTsToStorageF
     // max fftIndex in the FFTW output
     int maxFftIndex = FFT_OUTPUT_NO_FREQS - 1;
 
+    // the interpolation between the fft bins is the same for every fft, so it's computed once
+    std::vector<size_t> belowIndexes(FFT_STORAGE_SCOPE_SIZE);
+    std::vector<size_t> aboveIndexes(FFT_STORAGE_SCOPE_SIZE);
+    std::vector<float> interpolationPositions(FFT_STORAGE_SCOPE_SIZE);
+    for (size_t j = 0; j < FFT_STORAGE_SCOPE_SIZE; j++)
+    {
+        // map the index to magnify important frequencies
+        float logIndexFft = UnitConverter::magnifyFftIndexAt((int)j);
+
+        // try to do a linear interpolation between the two indexes
+        size_t belowIndex = (size_t)std::floor(logIndexFft);
+        size_t aboveIndex = (size_t)std::ceil(logIndexFft);
+        interpolationPositions[j] = logIndexFft - std::floor(logIndexFft);
+
+        // tried to prevent reading irrelevant data due to ceiling
+        belowIndexes[j] = juce::jmin(belowIndex, (size_t)maxFftIndex);
+        aboveIndexes[j] = juce::jmin(aboveIndex, (size_t)maxFftIndex);
+    }
+
     // proceed to iterate over transforming FFTs
     for (size_t i = 0; i < (size_t)numFFT; i++)
     {
-        size_t srcFftPosition = i * FFT_OUTPUT_NO_FREQS;
-        size_t dstFftPosition = i * FFT_STORAGE_SCOPE_SIZE;
+        const float *srcFft = rawFFTs->data() + (i * FFT_OUTPUT_NO_FREQS);
+        float *dstFft = storedFFTs->data() + (i * FFT_STORAGE_SCOPE_SIZE);
 
         for (size_t j = 0; j < FFT_STORAGE_SCOPE_SIZE; j++)
         {
-
-            // map the index to magnify important frequencies
-            float logIndexFft = UnitConverter::magnifyFftIndex(j);
-
-            // try to do a linear interpolation between the two indexes
-            size_t belowIndex = (size_t)std::floor(logIndexFft);
-            size_t aboveIndex = (size_t)std::ceil(logIndexFft);
-            float interpolationPosition = logIndexFft - std::floor(logIndexFft);
-
-            // tried to prevent reading irrelevant data due to ceiling
-            if (aboveIndex > (size_t)maxFftIndex)
-            {
-                aboveIndex = (size_t)maxFftIndex;
-            }
-
-            if (belowIndex > (size_t)maxFftIndex)
-            {
-                belowIndex = (size_t)maxFftIndex;
-            }
-
-            (*storedFFTs)[dstFftPosition + j] =
-                ((*rawFFTs)[srcFftPosition + belowIndex] * (1.0f - interpolationPosition)) +
-                ((*rawFFTs)[srcFftPosition + aboveIndex] * (interpolationPosition));
+            dstFft[j] = (srcFft[belowIndexes[j]] * (1.0f - interpolationPositions[j])) +
+                        (srcFft[aboveIndexes[j]] * interpolationPositions[j]);
         }
     }
 
@@ -202,25 +302,36 @@ void AudioFilesBufferStore::releaseUnusedBuffers()
         if (allowUnusedBufferRelease)
         {
             // to avoid deleting a container we're iterating
-            std::vector<std::string> filesToDelete;
+            std::vector<std::string> digestsToDelete;
 
             // iterate over cached items, and remove all those who have
             // less than two copies around
             for (auto it = audioBuffersCache.begin(); it != audioBuffersCache.end(); it++)
             {
-                if (it->second.data.use_count() == 1)
+                long useCount = it->second.data != nullptr ? it->second.data.use_count()
+                                                           : it->second.compressedData.use_count();
+                if (useCount == 1)
                 {
-                    std::cout << "Unused buffer to be cleared: " << it->first << std::endl;
-                    filesToDelete.push_back(it->first);
+                    std::cout << "Unused buffer to be cleared: " << it->second.fileFullPath << std::endl;
+                    digestsToDelete.push_back(it->first);
                 }
             }
 
-            for (size_t i = 0; i < filesToDelete.size(); i++)
+            for (size_t i = 0; i < digestsToDelete.size(); i++)
+            {
+                audioBuffersCache.erase(digestsToDelete[i]);
+            }
+
+            // forget about the paths of the cleared buffers
+            for (auto it = digestsPerPath.begin(); it != digestsPerPath.end();)
             {
-                auto fileToDelete = audioBuffersCache.find(filesToDelete[i]);
-                if (fileToDelete != audioBuffersCache.end())
+                if (audioBuffersCache.find(it->second) == audioBuffersCache.end())
                 {
-                    audioBuffersCache.erase(fileToDelete);
+                    it = digestsPerPath.erase(it);
+                }
+                else
+                {
+                    it++;
                 }
             }
         }
@@ -241,4 +352,12 @@ void AudioFilesBufferStore::enableUnusedBuffersRelease()
         juce::ScopedLock l(lock);
         allowUnusedBufferRelease = true;
     }
-}
\ No newline at end of file
+}
+
+void AudioFilesBufferStore::setInMemoryCompression(bool enabled)
+{
+    {
+        juce::ScopedLock l(lock);
+        inMemoryCompression = enabled;
+    }
+}
@@ -1,7 +1,9 @@
 #ifndef DEF_AUDIO_FILES_BUFFER_STORE_HPP
 #define DEF_AUDIO_FILES_BUFFER_STORE_HPP
 
+#include "CompressedAudioBuffer.h"
 #include "FftRunner.h"
+#include "SpectrogramHitGrid.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_gui_extra/juce_gui_extra.h>
@@ -40,16 +42,54 @@ struct AudioFileBufferRef
      */
     std::string hashDigest();
 
-    std::shared_ptr<juce::AudioSampleBuffer> data; /**< pointer to the data */
+    /**
+     * @brief Tells if the audio data is set, either as floats or compressed.
+     */
+    bool hasAudio() const;
+
+    /**
+     * @brief Get the number of channels of the audio data, 0 if it is not set.
+     */
+    int getNumChannels() const;
+
+    /**
+     * @brief Get the number of frames of the audio data, 0 if it is not set.
+     */
+    int getNumSamples() const;
+
+    /**
+     * @brief Get a pointer that identifies the audio data, whatever its representation.
+     */
+    const void *getAudioIdentity() const;
+
+    /**
+     * @brief Copies frames of a channel, whether the audio data is stored as floats or compressed.
+     *
+     * @param cache The cache of decoded blocks of the calling thread, unused for float data.
+     * @param dest Where to copy the frames.
+     * @param channel The channel to copy from.
+     * @param startFrame The first frame to copy.
+     * @param numFrames The number of frames to copy.
+     */
+    void copyFrames(DecodedBlockCache &cache, float *dest, int channel, int startFrame, int numFrames) const;
+
+    std::shared_ptr<juce::AudioSampleBuffer> data; /**< pointer to the data, null if compressed */
     std::string fileFullPath;                      /**< full path to the file on disk */
     unsigned char hash[SHA_DIGEST_LENGTH];         /**< hash of the audio content (used for fallback object storage) */
     std::shared_ptr<std::vector<float>> storedFftData; /**< Disscrete Short time FFTs stored. Each FFT has a storage
                                                           size that may differ from raw FFT output size. */
+
+    // the audio data if it is kept compressed in memory, in which case data is null
+    std::shared_ptr<const CompressedAudioBuffer> compressedData;
+
+    // coarse copy of the stored FFTs the user interface hit tests with
+    std::shared_ptr<const SpectrogramHitGrid> hitGrid;
 };
 
 /**
  * @brief Describes a class that is storing audio buffer for files
- *        and cache them based on file path. It has a callback to
+ *        and cache them based on their content, so that identical files
+ *        under different paths share the same buffer. It has a callback to
  *        free the buffer that are not referenced anymore outside
  *        of the store, and this behaviour can be paused and resumed
  *        for whenever the user wants to reload a project and have the
@@ -103,14 +143,31 @@ class AudioFilesBufferStore
      */
     std::shared_ptr<std::vector<float>> copyRawFFTsToStorageFormat(std::shared_ptr<std::vector<float>> rawFFTs);
 
+    /**
+     * @brief      Enable or disable the compression of the audio buffers loaded from now on.
+     *             Compressed buffers are decoded block by block when played, which takes
+     *             a bit of cpu time in exchange of memory (see CompressedAudioBuffer).
+     *
+     * @param[in]  enabled  True to compress the buffers.
+     */
+    void setInMemoryCompression(bool enabled);
+
   private:
     juce::AudioFormatManager formatManager;
     bool allowUnusedBufferRelease;
+    bool inMemoryCompression;
     juce::CriticalSection lock;
 
     juce::SharedResourcePointer<FftRunner> fftProcessing; /**< Object that maintains threads to run ffts */
 
-    std::map<std::string, AudioFileBufferRef> audioBuffersCache; /**< map of full disk paths to audio buffers */
+    /**
+     * @brief      Copy a cached buffer reference for a path it was loaded from. It shares
+     *             the audio data and FFTs of the cached one.
+     */
+    AudioFileBufferRef getBufferAlias(const AudioFileBufferRef &cachedBuffer, std::string path);
+
+    std::map<std::string, AudioFileBufferRef> audioBuffersCache; /**< map of audio content digests to audio buffers */
+    std::map<std::string, std::string> digestsPerPath; /**< map of full disk paths to their audio content digest */
 };
 
 #endif // DEF_AUDIO_FILES_BUFFER_STORE_HPP
\ No newline at end of file
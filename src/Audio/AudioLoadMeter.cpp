@@ -0,0 +1,76 @@
+#include "AudioLoadMeter.h"
+
+AudioLoadMeter::AudioLoadMeter() : windowFrames(0)
+{
+}
+
+void AudioLoadMeter::reset()
+{
+    uint32_t deadlineMisses = load.deadlineMisses;
+    load = AudioCallbackLoad();
+    load.deadlineMisses = deadlineMisses;
+    window = AudioCallbackLoad();
+    windowFrames = 0;
+}
+
+void AudioLoadMeter::recordPlayerCost(int playerId, float micros, int filterStages)
+{
+    // find the histogram bucket, each one covering twice the duration of the previous one
+    size_t bucket = 0;
+    float bucketLimit = AUDIO_LOAD_HISTOGRAM_FIRST_BUCKET_US;
+    while (micros > bucketLimit && bucket < AUDIO_LOAD_HISTOGRAM_SIZE - 1)
+    {
+        bucketLimit *= 2.0f;
+        bucket++;
+    }
+    window.playerCostHistogram[bucket]++;
+
+    if (micros > window.costliestPlayerMicros)
+    {
+        window.costliestPlayerId = playerId;
+        window.costliestPlayerMicros = micros;
+        window.costliestPlayerFilterStages = filterStages;
+    }
+}
+
+bool AudioLoadMeter::recordCallback(float micros, int numFrames, double sampleRate)
+{
+    // we can't compute a deadline before the device sample rate is known
+    if (sampleRate <= 0.0 || numFrames <= 0)
+    {
+        return false;
+    }
+
+    float deadlineMicros = float((double(numFrames) * 1000000.0) / sampleRate);
+
+    load.callbackMicros = micros;
+    load.loadPercent = (100.0f * micros) / deadlineMicros;
+    if (micros > deadlineMicros)
+    {
+        load.deadlineMisses++;
+    }
+
+    window.worstCallbackMicros = juce::jmax(window.worstCallbackMicros, micros);
+    window.peakLoadPercent = juce::jmax(window.peakLoadPercent, load.loadPercent);
+
+    // once the window is complete, make its aggregated values the published ones and start a new one
+    windowFrames += numFrames;
+    if (windowFrames >= AUDIO_LOAD_WINDOW_FRAMES)
+    {
+        load.worstCallbackMicros = window.worstCallbackMicros;
+        load.peakLoadPercent = window.peakLoadPercent;
+        load.playerCostHistogram = window.playerCostHistogram;
+        load.costliestPlayerId = window.costliestPlayerId;
+        load.costliestPlayerMicros = window.costliestPlayerMicros;
+        load.costliestPlayerFilterStages = window.costliestPlayerFilterStages;
+        window = AudioCallbackLoad();
+        windowFrames = 0;
+    }
+
+    return true;
+}
+
+const AudioCallbackLoad &AudioLoadMeter::getLoad() const
+{
+    return load;
+}
@@ -0,0 +1,61 @@
+#ifndef DEF_AUDIO_LOAD_METER_HPP
+#define DEF_AUDIO_LOAD_METER_HPP
+
+#include <cstdint>
+
+#include "DataSource.h"
+
+/**
+ * @brief      Aggregates the durations of the audio callbacks and of the sample player
+ *             blocks into the AudioCallbackLoad values published to the UI. The load of
+ *             the last callback is updated on each callback, while the peak, histogram and
+ *             costliest player values are published once per AUDIO_LOAD_WINDOW_FRAMES.
+ *             Meant to be used from the audio thread only, it never allocates nor locks.
+ */
+class AudioLoadMeter
+{
+  public:
+    AudioLoadMeter();
+
+    /**
+     * @brief      Clears the loads and the current window. The deadline misses
+     *             are kept, as they count the xruns since startup.
+     */
+    void reset();
+
+    /**
+     * @brief      Records in the current window how long a sample player took to compute its block.
+     *
+     * @param[in]  playerId      The sample player index.
+     * @param[in]  micros        The duration of the block in microseconds.
+     * @param[in]  filterStages  The number of filters the player runs per channel.
+     */
+    void recordPlayerCost(int playerId, float micros, int filterStages);
+
+    /**
+     * @brief      Records the duration of an audio callback, and counts a deadline
+     *             miss if it took longer than the audio it computed lasts.
+     *
+     * @param[in]  micros      The duration of the callback in microseconds.
+     * @param[in]  numFrames   The number of audio frames the callback computed.
+     * @param[in]  sampleRate  The sample rate of the device.
+     *
+     * @return     false if nothing was recorded because there is no deadline to compare to.
+     */
+    bool recordCallback(float micros, int numFrames, double sampleRate);
+
+    /**
+     * @brief      Gets the values to publish.
+     */
+    const AudioCallbackLoad &getLoad() const;
+
+  private:
+    // published values
+    AudioCallbackLoad load;
+    // the peak and histogram values of the window being aggregated
+    AudioCallbackLoad window;
+    // how many audio frames were processed in the current aggregation window
+    int64_t windowFrames;
+};
+
+#endif // DEF_AUDIO_LOAD_METER_HPP
@@ -0,0 +1,427 @@
+#include "CompressedAudioBuffer.h"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+const uint8_t ENCODING_RAW_FLOATS = 0;
+const uint8_t ENCODING_RICE = 1;
+
+// size of the header before the frames of each block channel
+const int BLOCK_CHANNEL_HEADER_SIZE = 4;
+
+// integer depths the floats are tried to be scaled from, in order
+const int INTEGER_BIT_DEPTHS[] = {16, 24};
+
+std::atomic<uint64_t> nextIdentifier{1};
+
+/**
+ * @brief      Convert the floats to integers of this depth if they all give back the exact same float.
+ */
+bool toIntegers(const float *frames, int numFrames, int bitDepth, int32_t *integers)
+{
+    float scale = float(1 << (bitDepth - 1));
+    float inverseScale = 1.0f / scale;
+
+    for (int i = 0; i < numFrames; i++)
+    {
+        // scaling by a power of two is exact, so any fractional part means the frame is not an integer
+        float scaled = frames[i] * scale;
+        // this also rules out NaNs
+        if (!(scaled >= -scale && scaled < scale))
+        {
+            return false;
+        }
+        int32_t value = int32_t(scaled);
+        float decoded = float(value) * inverseScale;
+        // compare bits so that -0.0 is not mistaken for 0.0
+        if (std::memcmp(&decoded, &frames[i], sizeof(float)) != 0)
+        {
+            return false;
+        }
+        integers[i] = value;
+    }
+    return true;
+}
+
+inline int64_t predict(int order, int64_t previous, int64_t beforePrevious)
+{
+    switch (order)
+    {
+    case 0:
+        return 0;
+    case 1:
+        return previous;
+    default:
+        return (2 * previous) - beforePrevious;
+    }
+}
+
+// interleave positive and negative residuals so that small magnitudes give small values
+inline uint32_t zigzagEncode(int64_t residual)
+{
+    return residual >= 0 ? uint32_t(residual) << 1 : (uint32_t(-residual) << 1) - 1;
+}
+
+inline int64_t zigzagDecode(uint32_t value)
+{
+    return (value & 1) ? -int64_t(value >> 1) - 1 : int64_t(value >> 1);
+}
+
+inline size_t riceCodeLength(uint32_t value, int riceParameter)
+{
+    uint32_t quotient = value >> riceParameter;
+    if (quotient >= COMPRESSED_AUDIO_RICE_ESCAPE)
+    {
+        return COMPRESSED_AUDIO_RICE_ESCAPE + 32;
+    }
+    return quotient + 1 + (size_t)riceParameter;
+}
+
+/**
+ * @brief      Gets the 64 bits following a bit position, the first bit being the most significant.
+ *             At least 57 of them are valid, provided there are 8 readable bytes after the position byte.
+ */
+inline uint64_t peekBits(const uint8_t *data, size_t bitPosition)
+{
+    const uint8_t *bytes = data + (bitPosition >> 3);
+    uint64_t window = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        window = (window << 8) | bytes[i];
+    }
+    return window << (bitPosition & 7);
+}
+
+/**
+ * @brief      Appends bits to a byte vector, most significant bit first.
+ */
+class BitWriter
+{
+  public:
+    explicit BitWriter(std::vector<uint8_t> &out) : output(out), accumulator(0), pendingBits(0)
+    {
+    }
+
+    void write(uint32_t value, int numBits)
+    {
+        uint64_t mask = (uint64_t(1) << numBits) - 1;
+        accumulator = (accumulator << numBits) | (value & mask);
+        pendingBits += numBits;
+        while (pendingBits >= 8)
+        {
+            output.push_back(uint8_t(accumulator >> (pendingBits - 8)));
+            pendingBits -= 8;
+        }
+    }
+
+    void writeRiceCode(uint32_t value, int riceParameter)
+    {
+        uint32_t quotient = value >> riceParameter;
+        if (quotient >= COMPRESSED_AUDIO_RICE_ESCAPE)
+        {
+            write((1u << COMPRESSED_AUDIO_RICE_ESCAPE) - 1, COMPRESSED_AUDIO_RICE_ESCAPE);
+            write(value, 32);
+            return;
+        }
+        // unary quotient: as many ones as its value followed by a zero
+        write(((1u << quotient) - 1) << 1, int(quotient) + 1);
+        write(value, riceParameter);
+    }
+
+    void flush()
+    {
+        if (pendingBits > 0)
+        {
+            output.push_back(uint8_t(accumulator << (8 - pendingBits)));
+            pendingBits = 0;
+        }
+    }
+
+  private:
+    std::vector<uint8_t> &output;
+    uint64_t accumulator;
+    int pendingBits;
+};
+} // namespace
+
+CompressedAudioBuffer::CompressedAudioBuffer(const juce::AudioSampleBuffer &source)
+    : numChannels(source.getNumChannels()), numSamples(source.getNumSamples()), identifier(nextIdentifier++)
+{
+    int numBlocks = getNumBlocks();
+    blockOffsets.resize((size_t)numBlocks);
+
+    for (int block = 0; block < numBlocks; block++)
+    {
+        blockOffsets[(size_t)block] = encodedData.size();
+
+        int blockStart = block * COMPRESSED_AUDIO_BLOCK_FRAMES;
+        int blockLength = juce::jmin(COMPRESSED_AUDIO_BLOCK_FRAMES, numSamples - blockStart);
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            encodeBlockChannel(source.getReadPointer(channel, blockStart), blockLength);
+        }
+    }
+
+    // the bit reader looks up to 8 bytes ahead of the bits it decodes
+    encodedData.resize(encodedData.size() + 8, 0);
+    encodedData.shrink_to_fit();
+}
+
+int CompressedAudioBuffer::getNumChannels() const
+{
+    return numChannels;
+}
+
+int CompressedAudioBuffer::getNumSamples() const
+{
+    return numSamples;
+}
+
+int CompressedAudioBuffer::getNumBlocks() const
+{
+    return (numSamples + COMPRESSED_AUDIO_BLOCK_FRAMES - 1) / COMPRESSED_AUDIO_BLOCK_FRAMES;
+}
+
+size_t CompressedAudioBuffer::getNumBytes() const
+{
+    return encodedData.size() + (blockOffsets.size() * sizeof(size_t));
+}
+
+uint64_t CompressedAudioBuffer::getIdentifier() const
+{
+    return identifier;
+}
+
+void CompressedAudioBuffer::encodeBlockChannel(const float *frames, int numFrames)
+{
+    std::vector<int32_t> integers((size_t)numFrames);
+    std::vector<uint32_t> residuals((size_t)numFrames);
+
+    // raw floats are what we fall back to if nothing smaller is found
+    size_t bestLength = (size_t)numFrames * sizeof(float) * 8;
+    int bestBitDepth = 0, bestOrder = 0, bestRiceParameter = 0;
+
+    for (int bitDepth : INTEGER_BIT_DEPTHS)
+    {
+        if (!toIntegers(frames, numFrames, bitDepth, integers.data()))
+        {
+            continue;
+        }
+
+        // pick the predictor order that gives the smallest residuals
+        uint64_t residualsSums[COMPRESSED_AUDIO_MAX_PREDICTOR_ORDER + 1] = {};
+        for (int order = 0; order <= COMPRESSED_AUDIO_MAX_PREDICTOR_ORDER; order++)
+        {
+            int64_t previous = 0, beforePrevious = 0;
+            for (int i = 0; i < numFrames; i++)
+            {
+                residualsSums[order] += zigzagEncode(integers[(size_t)i] - predict(order, previous, beforePrevious));
+                beforePrevious = previous;
+                previous = integers[(size_t)i];
+            }
+        }
+        int order = 0;
+        for (int i = 1; i <= COMPRESSED_AUDIO_MAX_PREDICTOR_ORDER; i++)
+        {
+            if (residualsSums[i] < residualsSums[order])
+            {
+                order = i;
+            }
+        }
+
+        int64_t previous = 0, beforePrevious = 0;
+        for (int i = 0; i < numFrames; i++)
+        {
+            residuals[(size_t)i] = zigzagEncode(integers[(size_t)i] - predict(order, previous, beforePrevious));
+            beforePrevious = previous;
+            previous = integers[(size_t)i];
+        }
+
+        // the best rice parameter is close to the log2 of the mean residual, so we only try around it
+        uint64_t meanResidual = residualsSums[order] / (uint64_t)numFrames;
+        int estimatedParameter = 0;
+        while (estimatedParameter < COMPRESSED_AUDIO_MAX_RICE_PARAMETER &&
+               (uint64_t(1) << (estimatedParameter + 1)) <= meanResidual)
+        {
+            estimatedParameter++;
+        }
+        int minParameter = juce::jmax(0, estimatedParameter - 1);
+        int maxParameter = juce::jmin(COMPRESSED_AUDIO_MAX_RICE_PARAMETER, estimatedParameter + 1);
+        for (int riceParameter = minParameter; riceParameter <= maxParameter; riceParameter++)
+        {
+            size_t length = 0;
+            for (int i = 0; i < numFrames; i++)
+            {
+                length += riceCodeLength(residuals[(size_t)i], riceParameter);
+            }
+            if (length < bestLength)
+            {
+                bestLength = length;
+                bestBitDepth = bitDepth;
+                bestOrder = order;
+                bestRiceParameter = riceParameter;
+            }
+        }
+
+        // lower depths give smaller residuals, no need to try higher ones
+        break;
+    }
+
+    if (bestBitDepth == 0)
+    {
+        encodedData.push_back(ENCODING_RAW_FLOATS);
+        encodedData.resize(encodedData.size() + BLOCK_CHANNEL_HEADER_SIZE - 1, 0);
+        size_t framesOffset = encodedData.size();
+        encodedData.resize(framesOffset + ((size_t)numFrames * sizeof(float)));
+        std::memcpy(encodedData.data() + framesOffset, frames, (size_t)numFrames * sizeof(float));
+        return;
+    }
+
+    encodedData.push_back(ENCODING_RICE);
+    encodedData.push_back(uint8_t(bestBitDepth));
+    encodedData.push_back(uint8_t(bestOrder));
+    encodedData.push_back(uint8_t(bestRiceParameter));
+
+    BitWriter writer(encodedData);
+    for (int i = 0; i < numFrames; i++)
+    {
+        writer.writeRiceCode(residuals[(size_t)i], bestRiceParameter);
+    }
+    writer.flush();
+}
+
+void CompressedAudioBuffer::decodeBlock(int blockIndex, juce::AudioSampleBuffer &dest) const
+{
+    if (blockIndex < 0 || blockIndex >= getNumBlocks())
+    {
+        throw std::runtime_error("Tried to decode a compressed audio block that doesn't exist");
+    }
+
+    int blockStart = blockIndex * COMPRESSED_AUDIO_BLOCK_FRAMES;
+    int blockLength = juce::jmin(COMPRESSED_AUDIO_BLOCK_FRAMES, numSamples - blockStart);
+    const uint8_t *data = encodedData.data() + blockOffsets[(size_t)blockIndex];
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        data = decodeBlockChannel(data, dest.getWritePointer(channel), blockLength);
+    }
+}
+
+const uint8_t *CompressedAudioBuffer::decodeBlockChannel(const uint8_t *data, float *frames, int numFrames) const
+{
+    const uint8_t *framesData = data + BLOCK_CHANNEL_HEADER_SIZE;
+
+    if (data[0] == ENCODING_RAW_FLOATS)
+    {
+        std::memcpy(frames, framesData, (size_t)numFrames * sizeof(float));
+        return framesData + ((size_t)numFrames * sizeof(float));
+    }
+
+    float inverseScale = 1.0f / float(1 << (data[1] - 1));
+    int order = data[2];
+    int riceParameter = data[3];
+
+    size_t bitPosition = 0;
+    int64_t previous = 0, beforePrevious = 0;
+    for (int i = 0; i < numFrames; i++)
+    {
+        uint64_t window = peekBits(framesData, bitPosition);
+
+        int ones = 0;
+        while (ones < COMPRESSED_AUDIO_RICE_ESCAPE && (window & (uint64_t(1) << (63 - ones))) != 0)
+        {
+            ones++;
+        }
+
+        uint32_t residual;
+        if (ones == COMPRESSED_AUDIO_RICE_ESCAPE)
+        {
+            residual = uint32_t(peekBits(framesData, bitPosition + COMPRESSED_AUDIO_RICE_ESCAPE) >> 32);
+            bitPosition += COMPRESSED_AUDIO_RICE_ESCAPE + 32;
+        }
+        else
+        {
+            window <<= ones + 1;
+            uint32_t remainder = riceParameter == 0 ? 0 : uint32_t(window >> (64 - riceParameter));
+            residual = (uint32_t(ones) << riceParameter) | remainder;
+            bitPosition += (size_t)(ones + 1 + riceParameter);
+        }
+
+        int64_t value = predict(order, previous, beforePrevious) + zigzagDecode(residual);
+        frames[i] = float(value) * inverseScale;
+        beforePrevious = previous;
+        previous = value;
+    }
+
+    return framesData + ((bitPosition + 7) >> 3);
+}
+
+void CompressedAudioBuffer::copyFrames(DecodedBlockCache &cache, float *dest, int channel, int startFrame,
+                                       int numFrames) const
+{
+    while (numFrames > 0)
+    {
+        int blockIndex = startFrame / COMPRESSED_AUDIO_BLOCK_FRAMES;
+        int blockPosition = startFrame % COMPRESSED_AUDIO_BLOCK_FRAMES;
+        int framesThisTime = juce::jmin(numFrames, COMPRESSED_AUDIO_BLOCK_FRAMES - blockPosition);
+
+        const juce::AudioSampleBuffer &block = cache.getBlock(*this, blockIndex);
+        juce::FloatVectorOperations::copy(dest, block.getReadPointer(channel, blockPosition), framesThisTime);
+
+        dest += framesThisTime;
+        startFrame += framesThisTime;
+        numFrames -= framesThisTime;
+    }
+}
+
+//////////////////////////////////////////////////
+
+DecodedBlockCache::DecodedBlockCache() : useCounter(0)
+{
+}
+
+void DecodedBlockCache::prepare(int numChannels)
+{
+    blocks.resize(COMPRESSED_AUDIO_CACHED_BLOCKS);
+    for (auto &block : blocks)
+    {
+        block.bufferIdentifier = 0;
+        block.blockIndex = -1;
+        block.lastUse = 0;
+        block.frames.setSize(numChannels, COMPRESSED_AUDIO_BLOCK_FRAMES);
+    }
+    useCounter = 0;
+}
+
+const juce::AudioSampleBuffer &DecodedBlockCache::getBlock(const CompressedAudioBuffer &buffer, int blockIndex)
+{
+    // this only allocates if the cache was not prepared for this buffer
+    if (blocks.empty() || blocks[0].frames.getNumChannels() < buffer.getNumChannels())
+    {
+        prepare(buffer.getNumChannels());
+    }
+
+    useCounter++;
+
+    CachedBlock *leastRecentlyUsed = &blocks[0];
+    for (auto &block : blocks)
+    {
+        if (block.bufferIdentifier == buffer.getIdentifier() && block.blockIndex == blockIndex)
+        {
+            block.lastUse = useCounter;
+            return block.frames;
+        }
+        if (block.lastUse < leastRecentlyUsed->lastUse)
+        {
+            leastRecentlyUsed = &block;
+        }
+    }
+
+    buffer.decodeBlock(blockIndex, leastRecentlyUsed->frames);
+    leastRecentlyUsed->bufferIdentifier = buffer.getIdentifier();
+    leastRecentlyUsed->blockIndex = blockIndex;
+    leastRecentlyUsed->lastUse = useCounter;
+    return leastRecentlyUsed->frames;
+}
@@ -0,0 +1,143 @@
+#ifndef DEF_COMPRESSED_AUDIO_BUFFER_HPP
+#define DEF_COMPRESSED_AUDIO_BUFFER_HPP
+
+#include <cstdint>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**< Number of frames in each independently decodable block. Always choose a power of two! */
+#define COMPRESSED_AUDIO_BLOCK_FRAMES 4096
+
+/**< How many decoded blocks a DecodedBlockCache keeps. Two are enough to play across a block
+ * boundary, the others keep the blocks around a loop start or a recent seek. */
+#define COMPRESSED_AUDIO_CACHED_BLOCKS 4
+
+/**< Highest predictor order tried on each block (0 is no prediction) */
+#define COMPRESSED_AUDIO_MAX_PREDICTOR_ORDER 2
+
+/**< Highest rice parameter used. It keeps every rice code that is not escaped under 56 bits. */
+#define COMPRESSED_AUDIO_MAX_RICE_PARAMETER 24
+
+/**< Length of the unary prefix that tells a residual is escaped and written on 32 bits */
+#define COMPRESSED_AUDIO_RICE_ESCAPE 31
+
+class DecodedBlockCache;
+
+/**
+ * @brief      An immutable and losslessly compressed copy of an audio buffer, split in blocks of
+ *             COMPRESSED_AUDIO_BLOCK_FRAMES frames that are each decoded on their own.
+ *             Decoding audio files gives floats that are 16 or 24 bits integers scaled
+ *             down, and the blocks where this holds are stored as rice coded prediction residuals
+ *             of those integers. The other blocks are stored as raw floats. Either way, decoding gives
+ *             back the exact same floats. Reading doesn't allocate nor lock, so one instance can be shared
+ *             by any number of threads, each reading through its own DecodedBlockCache.
+ */
+class CompressedAudioBuffer
+{
+  public:
+    /**
+     * @brief      Encodes the audio buffer. This is slow and meant for loading threads.
+     *
+     * @param[in]  source  The audio to compress.
+     */
+    explicit CompressedAudioBuffer(const juce::AudioSampleBuffer &source);
+
+    int getNumChannels() const;
+    int getNumSamples() const;
+    int getNumBlocks() const;
+
+    /**
+     * @brief      Gets the memory used by the encoded audio in bytes.
+     */
+    size_t getNumBytes() const;
+
+    /**
+     * @brief      Gets an identifier that is unique to this instance for the whole program run,
+     *             unlike its address that can be reused once it's freed.
+     */
+    uint64_t getIdentifier() const;
+
+    /**
+     * @brief      Decodes all the channels of a block.
+     *
+     * @param[in]  blockIndex  The block index.
+     * @param      dest        The buffer to decode to, starting at frame 0. It must have at least
+     *                         getNumChannels() channels and COMPRESSED_AUDIO_BLOCK_FRAMES frames.
+     */
+    void decodeBlock(int blockIndex, juce::AudioSampleBuffer &dest) const;
+
+    /**
+     * @brief      Copies frames of a channel, decoding the blocks the cache doesn't hold yet.
+     *
+     * @param      cache       The cache of decoded blocks of the calling thread.
+     * @param      dest        Where to copy the frames.
+     * @param[in]  channel     The channel to copy from.
+     * @param[in]  startFrame  The first frame to copy.
+     * @param[in]  numFrames   The number of frames to copy.
+     */
+    void copyFrames(DecodedBlockCache &cache, float *dest, int channel, int startFrame, int numFrames) const;
+
+  private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompressedAudioBuffer)
+
+    /**
+     * @brief      Appends the encoded frames of one channel of a block to encodedData.
+     */
+    void encodeBlockChannel(const float *frames, int numFrames);
+
+    /**
+     * @brief      Decodes the frames of one channel of a block encoded at data.
+     *
+     * @return     A pointer to the data of the next channel.
+     */
+    const uint8_t *decodeBlockChannel(const uint8_t *data, float *frames, int numFrames) const;
+
+    int numChannels;
+    int numSamples;
+    uint64_t identifier;
+
+    // position of each block in encodedData
+    std::vector<size_t> blockOffsets;
+    std::vector<uint8_t> encodedData;
+};
+
+/**
+ * @brief      A small least recently used cache of decoded CompressedAudioBuffer blocks.
+ *             It is not thread safe: each thread reading compressed audio needs its own.
+ */
+class DecodedBlockCache
+{
+  public:
+    DecodedBlockCache();
+
+    /**
+     * @brief      Allocates the cached blocks for buffers of up to numChannels channels and
+     *             forgets the cached ones. It allocates and is not meant for the audio thread.
+     */
+    void prepare(int numChannels);
+
+    /**
+     * @brief      Gets a decoded block, decoding it in place of the least recently used one
+     *             if it is not cached.
+     *
+     * @param[in]  buffer      The compressed buffer.
+     * @param[in]  blockIndex  The block index.
+     *
+     * @return     The decoded frames, valid until the next call.
+     */
+    const juce::AudioSampleBuffer &getBlock(const CompressedAudioBuffer &buffer, int blockIndex);
+
+  private:
+    struct CachedBlock
+    {
+        uint64_t bufferIdentifier;
+        int blockIndex;
+        uint64_t lastUse;
+        juce::AudioSampleBuffer frames;
+    };
+
+    std::vector<CachedBlock> blocks;
+    uint64_t useCounter;
+};
+
+#endif // DEF_COMPRESSED_AUDIO_BUFFER_HPP
@@ -1,11 +1,19 @@
 #ifndef DATA_SOURCE_HPP
 #define DATA_SOURCE_HPP
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
 #define VUMETER_MAP_SIZE 32
 
+// number of buckets in the per sample player audio callback cost histogram
+#define AUDIO_LOAD_HISTOGRAM_SIZE 8
+// upper bound in microseconds of the first histogram bucket, each next one doubles it
+#define AUDIO_LOAD_HISTOGRAM_FIRST_BUCKET_US 8.0f
+// how many audio frames are aggregated before the peak and histogram values are published
+#define AUDIO_LOAD_WINDOW_FRAMES AUDIO_FRAMERATE
+
 // minimum db value displayed
 #define VUMETER_MIN_DB -36.0f
 
@@ -14,6 +22,8 @@
 
 #include <juce_core/juce_core.h>
 
+#include "../Config.h"
+
 /**
  * @brief      The identifiers for vu meters.
  */
@@ -57,6 +67,47 @@ class VuMeterDataSource
     virtual juce::Optional<std::pair<float, float>> getVuMeterValue(VumeterId vuMeterId) = 0;
 };
 
+/**
+ * @brief      Timing informations about the audio callbacks. Loads are
+ *             ratios in percent of the time spent computing a buffer relative to
+ *             the duration of the buffer (the deadline). Peak values, histogram
+ *             and costliest player are aggregated over AUDIO_LOAD_WINDOW_FRAMES.
+ */
+struct AudioCallbackLoad
+{
+    // load of the last audio callback
+    float loadPercent = 0.0f;
+    // highest callback load in the last window
+    float peakLoadPercent = 0.0f;
+    // duration of the last callback in microseconds
+    float callbackMicros = 0.0f;
+    // longest callback duration in the last window in microseconds
+    float worstCallbackMicros = 0.0f;
+    // how many callbacks exceeded the buffer duration since startup
+    uint32_t deadlineMisses = 0;
+    // how many sample player blocks were computed in each cost bucket during the last window
+    std::array<uint32_t, AUDIO_LOAD_HISTOGRAM_SIZE> playerCostHistogram{};
+    // id of the sample player with the most expensive block in the last window (-1 if none)
+    int costliestPlayerId = -1;
+    // duration in microseconds of this most expensive block
+    float costliestPlayerMicros = 0.0f;
+    // number of 12db/octave filters (low and high pass) this player runs per channel
+    int costliestPlayerFilterStages = 0;
+};
+
+/**
+ * @brief      Interface for classes that can provide audio callback timings.
+ */
+class AudioLoadDataSource
+{
+  public:
+    /**
+     * @brief      Gets the latest audio callback load informations.
+     *             Must never block.
+     */
+    virtual juce::Optional<AudioCallbackLoad> getAudioCallbackLoad() = 0;
+};
+
 /**
  * @brief      This class describes a position data source.
  */
@@ -1,5 +1,6 @@
 #include "FftRunner.h"
 #include "../Config.h"
+#include "../StartupTracer.h"
 #include <algorithm>
 #include <chrono>
 #include <complex>
@@ -15,9 +16,12 @@
 
 using namespace std::chrono_literals;
 
-FftRunner::FftRunner() : exiting(false)
+FftRunner::FftRunner() : exiting(false), workersInit("fft workers", [this] { startWorkers(); })
 {
+}
 
+void FftRunner::startWorkers()
+{
     // preallocate jobs data structures
     for (int i = 0; i < FFT_PREALLOCATED_JOB_STRUCTS; i++)
     {
@@ -65,8 +69,17 @@ int FftRunner::getNumFftFromNumSamples(int numSamples)
     return (numWindowsNoOverlap * FFT_OVERLAP_DIVISION) - (FFT_OVERLAP_DIVISION - 1);
 }
 
+std::mutex &FftRunner::getFftwPlannerMutex()
+{
+    static std::mutex fftwPlannerMutex;
+    return fftwPlannerMutex;
+}
+
 std::shared_ptr<std::vector<float>> FftRunner::performFft(std::shared_ptr<juce::AudioSampleBuffer> audioFile)
 {
+    // the workers are started by the first fft if the app didn't start them yet
+    workersInit.ensure();
+
     // NOTE: one job = one fft
 
     // number of jobs to send per channel
@@ -208,7 +221,8 @@ void FftRunner::fftThreadsLoop()
     fftwf_plan fftwPlan;
     // allocate them and compute the plan
     {
-        std::scoped_lock<std::mutex> lock(fftwMutex);
+        std::scoped_lock<std::mutex> lock(getFftwPlannerMutex());
+        StartupPhase phase("fft worker planning");
         fftInput = fftwf_alloc_real(FFTW_INPUT_SIZE);
         fftOutput = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * FFT_OUTPUT_NO_FREQS);
         fftwPlan = fftwf_plan_dft_r2c_1d(FFTW_INPUT_SIZE, fftInput, fftOutput, FFTW_PATIENT);
@@ -251,7 +265,7 @@ void FftRunner::fftThreadsLoop()
             {
                 // free the FFTW resources
                 {
-                    std::scoped_lock<std::mutex> lockFftw(fftwMutex);
+                    std::scoped_lock<std::mutex> lockFftw(getFftwPlannerMutex());
                     fftwf_destroy_plan(fftwPlan);
                     fftwf_free(fftInput);
                     fftwf_free(fftOutput);
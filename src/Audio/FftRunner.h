@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "../Config.h"
+#include "../LazyInit.h"
 #include "../WaitGroup.h"
 
 // a cool post about C++ thread pools: https://stackoverflow.com/a/32593825
@@ -42,6 +43,8 @@ struct FftRunnerJob
  * @brief Class that performs fft, eventually distributing
  *        computing between worker threads. It is meant to be used
  *        as a global static instance through juce::SharedRessourcePointer.
+ *        The worker threads and their FFTW plans are only created on the first
+ *        fft or once the app window is shown, to not delay the startup.
  */
 
 class FftRunner
@@ -86,7 +89,21 @@ class FftRunner
      */
     void processJob(std::shared_ptr<FftRunnerJob> jobRef, fftwf_plan *plan, float *in, fftwf_complex *out);
 
+    /**
+     * @brief Gets the mutex to hold while calling the FFTW planner functions, that are
+     *        not thread safe. It is shared with every other FFTW user of the app.
+     *
+     * @return std::mutex& The FFTW planner mutex.
+     */
+    static std::mutex &getFftwPlannerMutex();
+
   private:
+    /**
+     * @brief Preallocates the jobs and starts the worker threads, which plan their FFTs.
+     *        Runs once, on the first fft or when the app starts its lazy initializations.
+     */
+    void startWorkers();
+
     /**
      * @brief Main loop of the threads that are performing FFT.
      *
@@ -101,8 +118,8 @@ class FftRunner
     std::queue<std::shared_ptr<FftRunnerJob>>
         emptyJobPool;                   /**< Preallocated structures to carry job information. If empty, please wait. */
     std::mutex emptyJobsMutex;          /**< Prevent race condition if many threads want to run FFTs */
-    std::mutex fftwMutex;               /**< Mutex for non thread safe fftw init functions */
     std::vector<float> hannWindowTable; /**< factors of the hann windowing function for our desired input size */
+    LazyInit workersInit;               /**< Starts the workers, declared last as it uses the members above */
 };
 
 #endif // DEF_FFT_RUNNER_HPP
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "LinearPhaseFilter.h"
+#include "FftRunner.h"
+
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+/**
+ * @brief      FFTW plans shared by all the linear phase filters. FFTW allows executing
+ *             the same plan concurrently on different arrays as long as they have the
+ *             same alignment, which fftwf_malloc guarantees.
+ */
+struct LinearPhaseFftPlans
+{
+    fftwf_plan forward;       /**< real to complex plan of LINEAR_PHASE_FILTER_FFT_SIZE */
+    fftwf_plan inverse;       /**< complex to real plan of LINEAR_PHASE_FILTER_FFT_SIZE */
+    fftwf_plan kernelInverse; /**< complex to real plan of LINEAR_PHASE_FILTER_TAPS */
+};
+
+static const LinearPhaseFftPlans &getLinearPhaseFftPlans()
+{
+    static const LinearPhaseFftPlans plans = []() {
+        LinearPhaseFftPlans newPlans;
+
+        std::scoped_lock<std::mutex> lock(FftRunner::getFftwPlannerMutex());
+
+        // planning can overwrite the arrays, so we use temporary ones
+        float *real = fftwf_alloc_real(LINEAR_PHASE_FILTER_TAPS);
+        fftwf_complex *complex = fftwf_alloc_complex((LINEAR_PHASE_FILTER_TAPS >> 1) + 1);
+
+        newPlans.forward = fftwf_plan_dft_r2c_1d(LINEAR_PHASE_FILTER_FFT_SIZE, real, complex, FFTW_MEASURE);
+        newPlans.inverse = fftwf_plan_dft_c2r_1d(LINEAR_PHASE_FILTER_FFT_SIZE, complex, real, FFTW_MEASURE);
+        newPlans.kernelInverse = fftwf_plan_dft_c2r_1d(LINEAR_PHASE_FILTER_TAPS, complex, real, FFTW_ESTIMATE);
+
+        fftwf_free(real);
+        fftwf_free(complex);
+
+        return newPlans;
+    }();
+    return plans;
+}
+
+//==============================================================================
+
+LinearPhaseKernel::LinearPhaseKernel(float hpFreq, int hpRepeat, float lpFreq, int lpRepeat)
+    : highPassFreq(hpFreq), lowPassFreq(lpFreq), highPassRepeat(hpRepeat), lowPassRepeat(lpRepeat)
+{
+    const LinearPhaseFftPlans &plans = getLinearPhaseFftPlans();
+
+    int noMaskBins = (LINEAR_PHASE_FILTER_TAPS >> 1) + 1;
+    fftwf_complex *mask = fftwf_alloc_complex(noMaskBins);
+    float *impulse = fftwf_alloc_real(LINEAR_PHASE_FILTER_TAPS);
+    float *partitionInput = fftwf_alloc_real(LINEAR_PHASE_FILTER_FFT_SIZE);
+    fftwf_complex *partitionOutput = fftwf_alloc_complex(LINEAR_PHASE_FILTER_NO_BINS);
+
+    // a real mask without imaginary part gives a zero phase impulse centered on the first frame
+    for (int i = 0; i < noMaskBins; i++)
+    {
+        float freq = float(i) * float(AUDIO_FRAMERATE) / float(LINEAR_PHASE_FILTER_TAPS);
+        mask[i][0] = getMaskMagnitude(freq);
+        mask[i][1] = 0.0f;
+    }
+    fftwf_execute_dft_c2r(plans.kernelInverse, mask, impulse);
+
+    // center the impulse to make it causal (this is the linear phase delay), normalize it,
+    // and window it with a periodic blackman window to limit the ripples of the truncation
+    std::vector<float> centeredImpulse(LINEAR_PHASE_FILTER_TAPS);
+    for (int i = 0; i < LINEAR_PHASE_FILTER_TAPS; i++)
+    {
+        float phase = 2.0f * float(M_PI) * float(i) / float(LINEAR_PHASE_FILTER_TAPS);
+        float window = 0.42f - (0.5f * std::cos(phase)) + (0.08f * std::cos(2.0f * phase));
+        int sourceIndex = (i + (LINEAR_PHASE_FILTER_TAPS >> 1)) % LINEAR_PHASE_FILTER_TAPS;
+        centeredImpulse[(size_t)i] = window * impulse[sourceIndex] / float(LINEAR_PHASE_FILTER_TAPS);
+    }
+
+    // transform each zero padded partition, pre-scaled for the unnormalized inverse transform
+    partitions.resize((size_t)LINEAR_PHASE_FILTER_NO_PARTITIONS * LINEAR_PHASE_FILTER_NO_BINS);
+    for (int p = 0; p < LINEAR_PHASE_FILTER_NO_PARTITIONS; p++)
+    {
+        memcpy(partitionInput, centeredImpulse.data() + (p * LINEAR_PHASE_FILTER_BLOCK_SIZE),
+               sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memset(partitionInput + LINEAR_PHASE_FILTER_BLOCK_SIZE, 0, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        fftwf_execute_dft_r2c(plans.forward, partitionInput, partitionOutput);
+
+        std::complex<float> *partition = partitions.data() + ((size_t)p * LINEAR_PHASE_FILTER_NO_BINS);
+        for (int i = 0; i < LINEAR_PHASE_FILTER_NO_BINS; i++)
+        {
+            partition[i] = std::complex<float>(partitionOutput[i][0], partitionOutput[i][1]) /
+                           float(LINEAR_PHASE_FILTER_FFT_SIZE);
+        }
+    }
+
+    fftwf_free(mask);
+    fftwf_free(impulse);
+    fftwf_free(partitionInput);
+    fftwf_free(partitionOutput);
+}
+
+float LinearPhaseKernel::getMaskMagnitude(float freq) const
+{
+    float gain = 1.0f;
+
+    // each repeat is a second order butterworth stage: 1/sqrt(1+(f/fc)^4)
+    if (highPassFreq > 0.0f)
+    {
+        if (freq <= 0.0f)
+        {
+            return 0.0f;
+        }
+        float ratio = highPassFreq / freq;
+        gain *= std::pow(1.0f / std::sqrt(1.0f + std::pow(ratio, 4.0f)), float(highPassRepeat));
+    }
+
+    if (lowPassFreq < float((AUDIO_FRAMERATE >> 1) - 1))
+    {
+        if (lowPassFreq <= 0.0f)
+        {
+            return 0.0f;
+        }
+        float ratio = freq / lowPassFreq;
+        gain *= std::pow(1.0f / std::sqrt(1.0f + std::pow(ratio, 4.0f)), float(lowPassRepeat));
+    }
+
+    return gain;
+}
+
+const std::complex<float> *LinearPhaseKernel::getPartition(int partition) const
+{
+    return partitions.data() + ((size_t)partition * LINEAR_PHASE_FILTER_NO_BINS);
+}
+
+//==============================================================================
+
+LinearPhaseFilter::LinearPhaseFilter(std::shared_ptr<const LinearPhaseKernel> k, int numChannels)
+    : kernel(k), blockPosition(0), primed(false), priming(false), primingPosition(0),
+      scratchBuffer(numChannels, LINEAR_PHASE_FILTER_BLOCK_SIZE)
+{
+    // make sure plans exist before the audio thread needs them
+    getLinearPhaseFftPlans();
+
+    channels.resize((size_t)numChannels);
+    for (auto &state : channels)
+    {
+        state.inputBlock = fftwf_alloc_real(LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        state.outputBlock = fftwf_alloc_real(LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        state.overlap = fftwf_alloc_real(LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        state.spectrumHistory =
+            fftwf_alloc_complex((size_t)LINEAR_PHASE_FILTER_NO_PARTITIONS * LINEAR_PHASE_FILTER_HISTORY_STRIDE);
+    }
+
+    fftInput = fftwf_alloc_real(LINEAR_PHASE_FILTER_FFT_SIZE);
+    accumulator = fftwf_alloc_complex(LINEAR_PHASE_FILTER_NO_BINS);
+    ifftOutput = fftwf_alloc_real(LINEAR_PHASE_FILTER_FFT_SIZE);
+
+    reset();
+}
+
+LinearPhaseFilter::~LinearPhaseFilter()
+{
+    for (auto &state : channels)
+    {
+        fftwf_free(state.inputBlock);
+        fftwf_free(state.outputBlock);
+        fftwf_free(state.overlap);
+        fftwf_free(state.spectrumHistory);
+    }
+    fftwf_free(fftInput);
+    fftwf_free(accumulator);
+    fftwf_free(ifftOutput);
+}
+
+void LinearPhaseFilter::reset()
+{
+    for (auto &state : channels)
+    {
+        memset(state.inputBlock, 0, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memset(state.outputBlock, 0, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memset(state.overlap, 0, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memset(state.spectrumHistory, 0,
+               sizeof(fftwf_complex) * LINEAR_PHASE_FILTER_NO_PARTITIONS * LINEAR_PHASE_FILTER_HISTORY_STRIDE);
+        state.historyIndex = 0;
+    }
+    blockPosition = 0;
+}
+
+void LinearPhaseFilter::processSamples(const juce::AudioSourceChannelInfo &bufferToFill)
+{
+    int numChannels = juce::jmin(bufferToFill.buffer->getNumChannels(), (int)channels.size());
+    int samplesDone = 0;
+
+    while (samplesDone < bufferToFill.numSamples)
+    {
+        int samplesThisTime =
+            juce::jmin(bufferToFill.numSamples - samplesDone, LINEAR_PHASE_FILTER_BLOCK_SIZE - blockPosition);
+
+        // exchange the input frames with the output ones computed for the previous block
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            auto &state = channels[(size_t)channel];
+            float *samples = bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample + samplesDone);
+            juce::FloatVectorOperations::copy(state.inputBlock + blockPosition, samples, samplesThisTime);
+            juce::FloatVectorOperations::copy(samples, state.outputBlock + blockPosition, samplesThisTime);
+        }
+
+        blockPosition += samplesThisTime;
+        samplesDone += samplesThisTime;
+
+        if (blockPosition == LINEAR_PHASE_FILTER_BLOCK_SIZE)
+        {
+            for (auto &state : channels)
+            {
+                processBlock(state);
+            }
+            blockPosition = 0;
+        }
+    }
+}
+
+void LinearPhaseFilter::processBlock(ChannelState &state)
+{
+    const LinearPhaseFftPlans &plans = getLinearPhaseFftPlans();
+
+    // transform the zero padded input block and store it as the most recent spectrum
+    memcpy(fftInput, state.inputBlock, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+    memset(fftInput + LINEAR_PHASE_FILTER_BLOCK_SIZE, 0, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+    fftwf_complex *newestSpectrum =
+        state.spectrumHistory + ((size_t)state.historyIndex * LINEAR_PHASE_FILTER_HISTORY_STRIDE);
+    fftwf_execute_dft_r2c(plans.forward, fftInput, newestSpectrum);
+
+    // multiply each past input spectrum with the matching kernel partition and sum them
+    memset(accumulator, 0, sizeof(fftwf_complex) * LINEAR_PHASE_FILTER_NO_BINS);
+    for (int p = 0; p < LINEAR_PHASE_FILTER_NO_PARTITIONS; p++)
+    {
+        int historyIndex =
+            (state.historyIndex - p + LINEAR_PHASE_FILTER_NO_PARTITIONS) % LINEAR_PHASE_FILTER_NO_PARTITIONS;
+        const fftwf_complex *input =
+            state.spectrumHistory + ((size_t)historyIndex * LINEAR_PHASE_FILTER_HISTORY_STRIDE);
+        const std::complex<float> *partition = kernel->getPartition(p);
+        for (int i = 0; i < LINEAR_PHASE_FILTER_NO_BINS; i++)
+        {
+            float re = partition[i].real();
+            float im = partition[i].imag();
+            accumulator[i][0] += (input[i][0] * re) - (input[i][1] * im);
+            accumulator[i][1] += (input[i][0] * im) + (input[i][1] * re);
+        }
+    }
+
+    // back to time domain (this destroys the accumulator, which we reset anyway)
+    fftwf_execute_dft_c2r(plans.inverse, accumulator, ifftOutput);
+
+    // overlap-add the first half with the previous block tail and keep the second half for the next one
+    for (int i = 0; i < LINEAR_PHASE_FILTER_BLOCK_SIZE; i++)
+    {
+        state.outputBlock[i] = ifftOutput[i] + state.overlap[i];
+        state.overlap[i] = ifftOutput[i + LINEAR_PHASE_FILTER_BLOCK_SIZE];
+    }
+
+    state.historyIndex = (state.historyIndex + 1) % LINEAR_PHASE_FILTER_NO_PARTITIONS;
+}
+
+bool LinearPhaseFilter::isPrimed() const
+{
+    return primed;
+}
+
+void LinearPhaseFilter::setPrimed(bool p)
+{
+    primed = p;
+    priming = false;
+}
+
+void LinearPhaseFilter::startPriming(int64_t inputPosition)
+{
+    reset();
+    primed = false;
+    priming = true;
+    primingPosition = inputPosition;
+}
+
+bool LinearPhaseFilter::isPriming() const
+{
+    return priming;
+}
+
+int64_t LinearPhaseFilter::getPrimingPosition() const
+{
+    return primingPosition;
+}
+
+void LinearPhaseFilter::setPrimingPosition(int64_t inputPosition)
+{
+    primingPosition = inputPosition;
+}
+
+void LinearPhaseFilter::copyStateFrom(const LinearPhaseFilter &other)
+{
+    jassert(other.channels.size() == channels.size());
+
+    for (size_t channel = 0; channel < juce::jmin(channels.size(), other.channels.size()); channel++)
+    {
+        ChannelState &state = channels[channel];
+        const ChannelState &otherState = other.channels[channel];
+        memcpy(state.inputBlock, otherState.inputBlock, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memcpy(state.outputBlock, otherState.outputBlock, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memcpy(state.overlap, otherState.overlap, sizeof(float) * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+        memcpy(state.spectrumHistory, otherState.spectrumHistory,
+               sizeof(fftwf_complex) * LINEAR_PHASE_FILTER_NO_PARTITIONS * LINEAR_PHASE_FILTER_HISTORY_STRIDE);
+        state.historyIndex = otherState.historyIndex;
+    }
+    blockPosition = other.blockPosition;
+    primed = other.primed;
+    priming = other.priming;
+    primingPosition = other.primingPosition;
+}
+
+int LinearPhaseFilter::getNumChannels() const
+{
+    return (int)channels.size();
+}
+
+juce::AudioSampleBuffer &LinearPhaseFilter::getScratchBuffer()
+{
+    return scratchBuffer;
+}
+
+std::shared_ptr<const LinearPhaseKernel> LinearPhaseFilter::getKernel() const
+{
+    return kernel;
+}
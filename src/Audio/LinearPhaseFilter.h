@@ -0,0 +1,217 @@
+#ifndef DEF_LINEAR_PHASE_FILTER_HPP
+#define DEF_LINEAR_PHASE_FILTER_HPP
+
+#include <complex>
+#include <fftw3.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <memory>
+#include <vector>
+
+#include "../Config.h"
+
+/**< Size of the audio blocks the filter processes at once, and of each partition of its impulse response.
+ * It is also the latency the partitioning adds. Always choose a power of two! */
+#define LINEAR_PHASE_FILTER_BLOCK_SIZE 512
+
+/**< Length of the filter impulse response in audio frames. Must be a multiple of the block size. The longer it is,
+ * the steeper the filters are at low frequencies, but the more the filter costs and rings before transients. */
+#define LINEAR_PHASE_FILTER_TAPS 4096
+
+/**< Size of the FFTs used to convolve each block with each partition (zero padded to avoid circular convolution) */
+#define LINEAR_PHASE_FILTER_FFT_SIZE (LINEAR_PHASE_FILTER_BLOCK_SIZE * 2)
+
+/**< Number of complex bins each FFT outputs */
+#define LINEAR_PHASE_FILTER_NO_BINS (LINEAR_PHASE_FILTER_BLOCK_SIZE + 1)
+
+/**< Distance in complex values between two spectrums of the input history. The bins count is padded to a multiple
+ * of 8 so that each spectrum is 64 bytes aligned like the arrays the FFTW plans were made with, as SIMD codelets
+ * require it when executing a plan on new arrays */
+#define LINEAR_PHASE_FILTER_HISTORY_STRIDE (((LINEAR_PHASE_FILTER_NO_BINS + 7) / 8) * 8)
+
+/**< How many partitions the impulse response is split into */
+#define LINEAR_PHASE_FILTER_NO_PARTITIONS (LINEAR_PHASE_FILTER_TAPS / LINEAR_PHASE_FILTER_BLOCK_SIZE)
+
+/**< Delay between the input and the output of the filter: the partitioning latency plus the impulse response center */
+#define LINEAR_PHASE_FILTER_LATENCY (LINEAR_PHASE_FILTER_BLOCK_SIZE + (LINEAR_PHASE_FILTER_TAPS >> 1))
+
+/**< How many input frames a filter must be fed after a seek before its output is right again */
+#define LINEAR_PHASE_FILTER_PRIMING_FRAMES ((LINEAR_PHASE_FILTER_TAPS >> 1) + LINEAR_PHASE_FILTER_LATENCY)
+
+/**< How many blocks a filter being primed on the audio thread is fed per callback, on top of the callback length.
+ * The priming is spread over several callbacks so that seeking with several filters doesn't cause an xrun. */
+#define LINEAR_PHASE_FILTER_PRIMING_BLOCKS_PER_CALLBACK 2
+
+/**
+ * @brief      The precomputed spectrum of each partition of a linear phase band pass impulse response.
+ *             It is immutable once built and can be shared between filters and threads.
+ */
+class LinearPhaseKernel
+{
+  public:
+    /**
+     * @brief      Builds the kernel from a frequency mask that has the same magnitude response as the
+     *             SamplePlayer IIR cascades (each repeat is a 12dB/octave butterworth stage), but without
+     *             their phase shift.
+     *
+     * @param[in]  highPassFreq    The high pass frequency, 0 to disable it.
+     * @param[in]  highPassRepeat  How many 12dB/octave high pass stages the mask mimics.
+     * @param[in]  lowPassFreq     The low pass frequency, nyquist frequency or above to disable it.
+     * @param[in]  lowPassRepeat   How many 12dB/octave low pass stages the mask mimics.
+     */
+    LinearPhaseKernel(float highPassFreq, int highPassRepeat, float lowPassFreq, int lowPassRepeat);
+
+    /**
+     * @brief      Gets the magnitude of the frequency mask the kernel was designed from.
+     *
+     * @param[in]  freq  The frequency in Hz.
+     *
+     * @return     The magnitude (gain) at this frequency.
+     */
+    float getMaskMagnitude(float freq) const;
+
+    /**
+     * @brief      Gets the spectrum of a partition, pre-scaled for FFTW unnormalized inverse transform.
+     *
+     * @param[in]  partition  The partition index.
+     *
+     * @return     LINEAR_PHASE_FILTER_NO_BINS complex values.
+     */
+    const std::complex<float> *getPartition(int partition) const;
+
+  private:
+    float highPassFreq, lowPassFreq;
+    int highPassRepeat, lowPassRepeat;
+
+    // LINEAR_PHASE_FILTER_NO_PARTITIONS spectrums of LINEAR_PHASE_FILTER_NO_BINS bins each
+    std::vector<std::complex<float>> partitions;
+};
+
+/**
+ * @brief      A multichannel uniformly partitioned overlap-add FFT convolution filter. It convolves the
+ *             signal with the linear phase impulse response of a LinearPhaseKernel, which delays it by
+ *             exactly LINEAR_PHASE_FILTER_LATENCY frames. Processing doesn't allocate nor lock and is
+ *             meant for the audio thread, but construction is not.
+ */
+class LinearPhaseFilter
+{
+  public:
+    /**
+     * @brief      Allocates the filter state for this kernel.
+     *
+     * @param[in]  kernel       The kernel to convolve with.
+     * @param[in]  numChannels  The number of channels to filter.
+     */
+    LinearPhaseFilter(std::shared_ptr<const LinearPhaseKernel> kernel, int numChannels);
+    ~LinearPhaseFilter();
+
+    /**
+     * @brief      Forget about all the previous input, as if silence was played for ever.
+     */
+    void reset();
+
+    /**
+     * @brief      Filter the buffer region in place. Channels above the number of channels
+     *             of the filter are left untouched.
+     *
+     * @param[in]  bufferToFill  The buffer region to filter.
+     */
+    void processSamples(const juce::AudioSourceChannelInfo &bufferToFill);
+
+    /**
+     * @brief      Tells if the filter state was built from the signal preceding the next
+     *             frames to process. Filters are not primed after construction.
+     */
+    bool isPrimed() const;
+
+    /**
+     * @brief      Mark the filter as primed or not. Marking it as primed ends the priming.
+     */
+    void setPrimed(bool primed);
+
+    /**
+     * @brief      Resets the filter and marks it as being primed, which can then be spread over
+     *             several calls by the caller.
+     *
+     * @param[in]  inputPosition  The position, in the caller timeline, of the next input frame.
+     */
+    void startPriming(int64_t inputPosition);
+
+    /**
+     * @brief      Tells if startPriming was called and the filter is not primed yet.
+     */
+    bool isPriming() const;
+
+    /**
+     * @brief      Gets or sets the position, in the caller timeline, of the next input frame
+     *             of a filter being primed.
+     */
+    int64_t getPrimingPosition() const;
+    void setPrimingPosition(int64_t inputPosition);
+
+    /**
+     * @brief      Copies the whole state of another filter with the same number of channels,
+     *             so that a filter primed ahead of time on another thread can take over without
+     *             running the priming again. It doesn't allocate and is meant for the audio thread.
+     *
+     * @param[in]  other  The filter to copy the state from.
+     */
+    void copyStateFrom(const LinearPhaseFilter &other);
+
+    /**
+     * @brief      Gets the number of channels the filter was allocated for.
+     */
+    int getNumChannels() const;
+
+    /**
+     * @brief      Gets a buffer of LINEAR_PHASE_FILTER_BLOCK_SIZE frames that callers can use to feed
+     *             the filter without allocating, for example to prime it.
+     */
+    juce::AudioSampleBuffer &getScratchBuffer();
+
+    /**
+     * @brief      Gets the kernel this filter convolves with.
+     */
+    std::shared_ptr<const LinearPhaseKernel> getKernel() const;
+
+  private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseFilter)
+
+    /**
+     * @brief      The convolution state of one channel.
+     */
+    struct ChannelState
+    {
+        // input frames waiting for the block to be complete
+        float *inputBlock;
+        // filtered frames given back in exchange of the input ones
+        float *outputBlock;
+        // second half of the last inverse FFT, added to the next block
+        float *overlap;
+        // spectrums of the last LINEAR_PHASE_FILTER_NO_PARTITIONS input blocks,
+        // LINEAR_PHASE_FILTER_HISTORY_STRIDE complex values apart
+        fftwf_complex *spectrumHistory;
+        // index of the most recent spectrum in the history
+        int historyIndex;
+    };
+
+    void processBlock(ChannelState &state);
+
+    std::shared_ptr<const LinearPhaseKernel> kernel;
+    std::vector<ChannelState> channels;
+
+    // position in the current block, shared by all channels
+    int blockPosition;
+
+    bool primed;
+    bool priming;
+    int64_t primingPosition;
+
+    // FFTW work buffers shared by all channels
+    float *fftInput;
+    fftwf_complex *accumulator;
+    float *ifftOutput;
+
+    juce::AudioSampleBuffer scratchBuffer;
+};
+
+#endif // DEF_LINEAR_PHASE_FILTER_HPP
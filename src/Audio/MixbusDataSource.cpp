@@ -3,56 +3,47 @@
 MixbusDataSource::MixbusDataSource()
 {
     trackPosition = 0;
+    selectionGeneration = 0;
 }
 
 juce::Optional<std::pair<float, float>> MixbusDataSource::getVuMeterValue(VumeterId vuMeterId)
 {
-    // try to lock and do nothing if unable
-    const juce::CriticalSection::ScopedTryLockType lock(vuMetersMutex);
-
-    if (lock.isLocked())
+    if (vuMeterId >= VUMETER_SIZE)
     {
-        return vuMeterValues[vuMeterId];
+        return juce::Optional<std::pair<float, float>>(juce::nullopt);
     }
 
-    // return nothing if we can't find that vu meter data or couldn't get lock
-    return juce::Optional<std::pair<float, float>>(juce::nullopt);
+    return vuMeterValues.read()[vuMeterId];
 }
 
-void MixbusDataSource::swapVuMeterValues(VuMeterData &newValues)
+void MixbusDataSource::publishVuMeterValues(const VuMeterData &newValues)
 {
-    // try to lock and do nothing if unable
-    const juce::CriticalSection::ScopedTryLockType lock(vuMetersMutex);
-
-    if (lock.isLocked())
-    {
-        vuMeterValues.swap(newValues);
-    }
+    vuMeterValues.write(newValues);
 }
 
-void MixbusDataSource::updateSelectedTracks(std::set<size_t> &newSelectedTracks)
+void MixbusDataSource::updateSelectedTracks(const std::set<size_t> &newSelectedTracks)
 {
-    juce::CriticalSection::ScopedLockType lock(selectedTracksMutex);
-    newSelectedTracks.swap(selectedTracks);
-}
+    // odd while the bits are flipped so that readers can tell the bitmask is not consistent
+    selectionGeneration++;
 
-std::set<size_t> *MixbusDataSource::getLockedSelectedTracks()
-{
-    std::set<size_t> *response = nullptr;
-
-    bool isLocked = selectedTracksMutex.tryEnter();
+    // unset tracks that are not selected anymore
+    for (auto it = selectedTracks.begin(); it != selectedTracks.end(); it++)
+    {
+        if (newSelectedTracks.find(*it) == newSelectedTracks.end())
+        {
+            selectedTracksBitmask.reset(*it);
+        }
+    }
 
-    if (isLocked)
+    for (auto it = newSelectedTracks.begin(); it != newSelectedTracks.end(); it++)
     {
-        response = &selectedTracks;
+        selectedTracksBitmask.set(*it);
     }
 
-    return response;
-}
+    selectedTracks = newSelectedTracks;
 
-void MixbusDataSource::releaseSelectedTracks()
-{
-    selectedTracksMutex.exit();
+    // even again, the bitmask matches the new selection
+    selectionGeneration++;
 }
 
 juce::Optional<int64_t> MixbusDataSource::getPosition()
@@ -64,3 +55,13 @@ void MixbusDataSource::setPosition(int64_t pos)
 {
     trackPosition = pos;
 }
+
+juce::Optional<AudioCallbackLoad> MixbusDataSource::getAudioCallbackLoad()
+{
+    return audioCallbackLoad.read();
+}
+
+void MixbusDataSource::setAudioCallbackLoad(const AudioCallbackLoad &load)
+{
+    audioCallbackLoad.write(load);
+}
@@ -1,10 +1,13 @@
 #ifndef MIXBUS_DATA_SOURCE_HPP
 #define MIXBUS_DATA_SOURCE_HPP
 
+#include "AtomicBitmask.h"
 #include "DataSource.h"
+#include "TripleBuffer.h"
 #include <atomic>
 #include <cstdint>
 #include <map>
+#include <set>
 
 /**
  * @brief      This class describes a mixbus data source.
@@ -13,14 +16,17 @@
  *             It is both owned and called by Mixbus to set
  *             values, and requested by (generally) UI components
  *             to get informations.
+ *             Values flowing from the audio thread go through
+ *             TripleBuffer channels, and must be read from a single
+ *             thread (the message thread). Nothing here ever locks.
  */
-class MixbusDataSource : public VuMeterDataSource, public PositionDataSource
+class MixbusDataSource : public VuMeterDataSource, public PositionDataSource, public AudioLoadDataSource
 {
   public:
     MixbusDataSource();
 
     /**
-     * @brief      Gets the vu meter value.
+     * @brief      Gets the vu meter value. Call it from the message thread.
      *
      * @param[in]  vuMeterId  The vu meter identifier
      *
@@ -29,66 +35,104 @@ class MixbusDataSource : public VuMeterDataSource, public PositionDataSource
     juce::Optional<std::pair<float, float>> getVuMeterValue(VumeterId vuMeterId) override final;
 
     /**
-     * @brief      Called from the audio thread. Swap the maps
-     * values with the previous one so that new values can be read by
-     * getVuMeterValues.
+     * @brief      Called from the audio thread. Publish the vu meters values
+     *             so that they can be read by getVuMeterValue. Never blocks
+     *             nor allocates.
      *
-     * @param[in]  avalues  The map with the new values to swap
+     * @param[in]  values  The new vu meters values.
      */
-    void swapVuMeterValues(VuMeterData &values);
+    void publishVuMeterValues(const VuMeterData &values);
 
     /**
      * @brief      Receives a copy of the set holding the selected
-     *             tracks ids and takes care of swapping with the locked
-     *             ones that are requested by the mixbus. This function can
-     *             lock.
+     *             tracks ids and updates the selection bitmask the
+     *             mixbus reads. Call it from a single thread.
      *
      * @param[in]  newSelectedTracks  The new selected tracks
      */
-    void updateSelectedTracks(std::set<size_t> &newSelectedTracks);
+    void updateSelectedTracks(const std::set<size_t> &newSelectedTracks);
 
     /**
-     * @brief      Gets the selected tracks. Will not block and
-     *             return nothing if current selection is locked.
-     *             Warning: it takes the lock untill releaseSelectedTracks()
-     *             is called.
+     * @brief      Tells if a track is selected. Never blocks, safe to
+     *             call from the audio thread for each track of each block.
      *
-     * @return     The selected tracks.
+     * @param[in]  trackId  The track identifier
+     *
+     * @return     True if the track is selected.
+     */
+    bool isTrackSelected(size_t trackId) const
+    {
+        return selectedTracksBitmask.test(trackId);
+    }
+
+    /**
+     * @brief      Gets a counter that is incremented before and after each selection update,
+     *             like a seqlock. It is odd while the selection bits are being changed.
+     *             Lets readers know if something they derived from the selection
+     *             is outdated without comparing sets: the bits read between two calls
+     *             returning the same even value are a consistent selection.
+     *
+     * @return     The selection generation.
      */
-    std::set<size_t> *getLockedSelectedTracks();
+    uint64_t getSelectionGeneration() const
+    {
+        // keeps the relaxed reads of the bits done before from moving after this one
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return selectionGeneration.load();
+    }
 
     /**
-     * @brief      Releases the lock on selected tracks. To call after
-     *             getLockedSelectedTracks. Warning: quite dangerous
-     *             to use ! Never ever allow an udpateSelectedTracks to be
-     *             called and return something != nullptr without a matching call
-     *             to this to release lock.
+     * @brief      Tells if a selection generation was read while the selection was being changed.
+     *
+     * @param[in]  generation  A value returned by getSelectionGeneration.
+     *
+     * @return     True if the selection bits read with this generation may be inconsistent.
      */
-    void releaseSelectedTracks();
+    static bool isSelectionBeingUpdated(uint64_t generation)
+    {
+        return (generation & 1) != 0;
+    }
 
     /**
      * @brief      Gets the position of the track in audio samples (in the sense of audio frames).
-     *             Does not block and simply return nothing when lock is taken.
      *
-     * @return     The position or nothing if didn't get the lock.
+     * @return     The position.
      */
     juce::Optional<int64_t> getPosition() override;
 
     /**
-     * @brief      Sets the position, not blocking if lock is taken. Will do nothing in that
-     * eventuality.
+     * @brief      Sets the position. Never blocks.
      *
      * @param[in]  the new value to be set.
      */
     void setPosition(int64_t);
 
+    /**
+     * @brief      Gets the latest audio callback load values. Call it
+     *             from the message thread.
+     *
+     * @return     The audio callback load.
+     */
+    juce::Optional<AudioCallbackLoad> getAudioCallbackLoad() override;
+
+    /**
+     * @brief      Called from the audio thread to publish the latest
+     *             audio callback load values. Never blocks.
+     *
+     * @param[in]  load  The load values to publish.
+     */
+    void setAudioCallbackLoad(const AudioCallbackLoad &load);
+
   private:
-    juce::CriticalSection vuMetersMutex;
-    VuMeterData vuMeterValues;
+    TripleBuffer<VuMeterData> vuMeterValues;
     std::atomic<int64_t> trackPosition;
 
+    // the last selection received, used to only flip the bits that changed
     std::set<size_t> selectedTracks;
-    juce::CriticalSection selectedTracksMutex;
+    AtomicBitmask selectedTracksBitmask;
+    std::atomic<uint64_t> selectionGeneration;
+
+    TripleBuffer<AudioCallbackLoad> audioCallbackLoad;
 };
 
-#endif // MIXBUS_DATA_SOURCE_HPP
\ No newline at end of file
+#endif // MIXBUS_DATA_SOURCE_HPP
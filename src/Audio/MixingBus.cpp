@@ -4,6 +4,7 @@
 #include "SamplePlayer.h"
 #include "UnitConverter.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -48,6 +49,19 @@ void MixingBus::reset()
 
     lastDrawnCursor = 0;
 
+    // keeps counting the deadline misses since startup
+    audioLoadMeter.reset();
+
+    loopBed.reset();
+    loopBedSelectedPlayers.clear();
+    loopBedStartFrame = 0;
+    loopBedEndFrame = 0;
+    loopBedArrangementGeneration = 0;
+    loopBedSelectionGeneration = 0;
+    loopBedKey = 0;
+    arrangementGeneration++;
+    samplePlayersPositionOutdated = false;
+
     samplePlayers.clear();
 }
 
@@ -196,6 +210,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     if (sc != nullptr && !sc->isCompleted() && !sc->hasFailed())
     {
         addSample(sc);
+        invalidateLoopBed();
         return true;
     }
 
@@ -203,6 +218,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     if (sd != nullptr && !sd->isCompleted() && !sd->hasFailed())
     {
         deleteSample(sd);
+        invalidateLoopBed();
         return true;
     }
 
@@ -210,6 +226,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     if (restoreTask != nullptr && !restoreTask->isCompleted() && !restoreTask->hasFailed())
     {
         restoreSample(restoreTask);
+        invalidateLoopBed();
         return true;
     }
 
@@ -220,6 +237,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         {
             samplePlayers[moveTask->id]->move(samplePlayers[moveTask->id]->getEditingPosition() +
                                               moveTask->dragDistance);
+            invalidateLoopBed();
             moveTask->setCompleted(true);
             moveTask->setFailed(false);
 
@@ -242,6 +260,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     if (timeCropTask != nullptr && !timeCropTask->isCompleted() && !timeCropTask->hasFailed())
     {
         cropSample(timeCropTask);
+        invalidateLoopBed();
         return true;
     }
 
@@ -249,6 +268,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     if (freqCropTask != nullptr && !freqCropTask->isCompleted() && !freqCropTask->hasFailed())
     {
         cropSample(freqCropTask);
+        invalidateLoopBed();
         return true;
     }
 
@@ -349,6 +369,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     {
         if (!loopToggleTask->requestingStateBroadcast)
         {
+            const juce::ScopedLock lock(mixbusMutex);
             loopingToggledOn = loopToggleTask->shouldLoop;
         }
         loopToggleTask->isCurrentlyLooping = loopingToggledOn;
@@ -362,6 +383,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     {
         if (!loopMovingTask->isBroadcastRequest)
         {
+            const juce::ScopedLock lock(mixbusMutex);
             loopSectionStartFrame = loopMovingTask->currentLoopBeginFrame;
             loopSectionEndFrame = loopMovingTask->currentLoopEndFrame;
         }
@@ -418,6 +440,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         fadeChangeTask->setCompleted(true);
         if (hasUpdated)
         {
+            invalidateLoopBed();
             fadeChangeTask->setFailed(false);
         }
         else
@@ -442,6 +465,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         if (!gainChangeTask->isBroadcastRequest)
         {
             samplePlayers[gainChangeTask->sampleId]->setDbGain(gainChangeTask->currentDbGain);
+            invalidateLoopBed();
         }
         gainChangeTask->currentDbGain = samplePlayers[gainChangeTask->sampleId]->getDbGain();
 
@@ -478,6 +502,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
             {
                 samplePlayers[filterRepeatChange->sampleId]->setHighPassRepeat(filterRepeatChange->newFilterRepeat);
             }
+            invalidateLoopBed();
         }
 
         if (filterRepeatChange->isLowPassFilter)
@@ -494,6 +519,26 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         return true;
     }
 
+    auto linearPhaseChange = std::dynamic_pointer_cast<SampleLinearPhaseChange>(task);
+    if (linearPhaseChange != nullptr && !linearPhaseChange->isCompleted() && !linearPhaseChange->hasFailed())
+    {
+        if (linearPhaseChange->sampleId < 0 || linearPhaseChange->sampleId >= samplePlayers.size() ||
+            samplePlayers[linearPhaseChange->sampleId] == nullptr)
+        {
+            return false;
+        }
+
+        auto sp = samplePlayers[linearPhaseChange->sampleId];
+        linearPhaseChange->previousLinearPhase = sp->isLinearPhaseFiltering();
+        sp->setLinearPhaseFiltering(linearPhaseChange->newLinearPhase);
+        invalidateLoopBed();
+        linearPhaseChange->newLinearPhase = sp->isLinearPhaseFiltering();
+
+        linearPhaseChange->setCompleted(true);
+        activityManager.broadcastNestedTaskNow(linearPhaseChange);
+        return true;
+    }
+
     auto resetTask = std::dynamic_pointer_cast<ResetTask>(task);
     if (resetTask != nullptr)
     {
@@ -502,7 +547,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         const juce::ScopedLock lock(mixbusMutex);
 
         reset();
-        notify();
+        invalidateLoopBed();
 
         auto loopResetTask = std::make_shared<LoopMovingTask>();
         loopResetTask->isBroadcastRequest = false;
@@ -526,6 +571,7 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
         try
         {
             unmarshal(projectLoadingTask->mixbusConfig);
+            invalidateLoopBed();
             projectLoadingTask->setCompleted(true);
             projectLoadingTask->stage = OPEN_PROJECT_STAGE_COMPLETED;
         }
@@ -546,6 +592,12 @@ bool MixingBus::taskHandler(std::shared_ptr<Task> task)
     return false;
 }
 
+void MixingBus::invalidateLoopBed()
+{
+    arrangementGeneration++;
+    notify();
+}
+
 void MixingBus::cropSample(std::shared_ptr<SampleTimeCropTask> task)
 {
     if (samplePlayers[task->id] != nullptr)
@@ -716,6 +768,9 @@ void MixingBus::releaseResources()
 
 void MixingBus::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
 {
+    // the time spent waiting for the lock counts toward the deadline
+    auto callbackStart = std::chrono::steady_clock::now();
+
     const juce::ScopedLock sl(mixbusMutex);
 
     int nextPlayPosition = (playCursor + bufferToFill.numSamples);
@@ -756,6 +811,8 @@ void MixingBus::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFi
             getAudioBlock(loopStartBufferRead);
         }
     }
+
+    recordAudioCallbackLoad(callbackStart, bufferToFill.numSamples);
 }
 
 void MixingBus::getAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
@@ -772,82 +829,25 @@ void MixingBus::getAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
     if (samplePlayers.size() > 0 && isPlaying)
     {
 
-        // get if possible a pointer to the set of selected tracks
-        std::set<size_t> *selectedTracks = mixbusDataSource->getLockedSelectedTracks();
-
         // ensure selected audio buffer has necessary space
-        if (selectedTracks != nullptr)
-        {
-            // initialize buffer
-            audioThreadSelectionBuffer.setSize(juce::jmax(1, bufferToFill.buffer->getNumChannels()),
-                                               bufferToFill.buffer->getNumSamples(), false, false, true);
-            audioThreadSelectionBuffer.clear();
-        }
+        audioThreadSelectionBuffer.setSize(juce::jmax(1, bufferToFill.buffer->getNumChannels()),
+                                           bufferToFill.buffer->getNumSamples(), false, false, true);
+        audioThreadSelectionBuffer.clear();
 
-        // get a pointer to a new processed input buffer from first source
-        // we will append into this one to mix tracks together
-        if (samplePlayers.getUnchecked(0) != nullptr)
+        // when the loop section was pre-rendered, only the selected samples are computed
+        if (canUseLoopBed(bufferToFill))
         {
-            samplePlayers.getUnchecked(0)->getNextAudioBlock(bufferToFill);
-
-            // if the track is currently selected sum its volume
-            if (selectedTracks != nullptr && selectedTracks->find(0) != selectedTracks->end())
-            {
-                // append it to the initial one
-                for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
-                {
-                    audioThreadSelectionBuffer.addFrom(chan, 0, (*(bufferToFill.buffer)), chan,
-                                                       bufferToFill.startSample, bufferToFill.numSamples);
-                }
-            }
+            mixSelectionOverLoopBed(bufferToFill);
         }
         else
         {
-            bufferToFill.clearActiveBufferRegion();
-        }
-
-        if (samplePlayers.size() > 1)
-        {
-            // initialize buffer
-            audioThreadBuffer.setSize(juce::jmax(1, bufferToFill.buffer->getNumChannels()),
-                                      bufferToFill.buffer->getNumSamples(), false, false, true);
-
-            // create a new getNextAudioBlock request that
-            // will use our MixingBus buffer to pull
-            // block to append to the previous buffer
-            juce::AudioSourceChannelInfo copyBufferDest(&audioThreadBuffer, 0, bufferToFill.numSamples);
-
-            // for each input source
-            for (size_t i = 1; i < (size_t)samplePlayers.size(); i++)
+            // samples skipped while the loop bed was played have to catch up
+            if (samplePlayersPositionOutdated)
             {
-                if (samplePlayers.getUnchecked(i) == nullptr)
-                {
-                    continue;
-                }
-                // get the next audio block in the buffer
-                samplePlayers.getUnchecked(i)->getNextAudioBlock(copyBufferDest);
-                // abort whenever the buffer is empty
-                if (audioThreadBuffer.getNumSamples() != 0)
-                {
-                    // append it to the initial one
-                    for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
-                    {
-                        bufferToFill.buffer->addFrom(chan, bufferToFill.startSample, audioThreadBuffer, chan, 0,
-                                                     bufferToFill.numSamples);
-                    }
-
-                    // if the track is currently selected sum its volume
-                    if (selectedTracks != nullptr && selectedTracks->find(i) != selectedTracks->end())
-                    {
-                        // append it to the initial one
-                        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
-                        {
-                            audioThreadSelectionBuffer.addFrom(chan, 0, audioThreadBuffer, chan, 0,
-                                                               bufferToFill.numSamples);
-                        }
-                    }
-                }
+                setNextReadPosition(playCursor);
+                samplePlayersPositionOutdated = false;
             }
+            mixAllSamplePlayers(bufferToFill);
         }
 
         // create context to apply dsp effects
@@ -873,10 +873,7 @@ void MixingBus::getAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
         vuMeterVolumes[VUMETER_ID_SELECTED] = selectionVolume;
 
         // send all the vu meter values to the data source
-        mixbusDataSource->swapVuMeterValues(vuMeterVolumes);
-
-        // ensure we freed the selected tracks lock !
-        mixbusDataSource->releaseSelectedTracks();
+        mixbusDataSource->publishVuMeterValues(vuMeterVolumes);
     }
     else
     {
@@ -897,6 +894,145 @@ void MixingBus::getAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
     }
 }
 
+void MixingBus::mixAllSamplePlayers(const juce::AudioSourceChannelInfo &bufferToFill)
+{
+    // get a pointer to a new processed input buffer from first source
+    // we will append into this one to mix tracks together
+    if (samplePlayers.getUnchecked(0) != nullptr)
+    {
+        auto playerStart = std::chrono::steady_clock::now();
+        samplePlayers.getUnchecked(0)->getNextAudioBlock(bufferToFill);
+        recordSamplePlayerCost(0, playerStart);
+
+        // if the track is currently selected sum its volume
+        if (mixbusDataSource->isTrackSelected(0))
+        {
+            // append it to the initial one
+            for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
+            {
+                audioThreadSelectionBuffer.addFrom(chan, 0, (*(bufferToFill.buffer)), chan,
+                                                   bufferToFill.startSample, bufferToFill.numSamples);
+            }
+        }
+    }
+    else
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+
+    if (samplePlayers.size() > 1)
+    {
+        // initialize buffer
+        audioThreadBuffer.setSize(juce::jmax(1, bufferToFill.buffer->getNumChannels()),
+                                  bufferToFill.buffer->getNumSamples(), false, false, true);
+
+        // create a new getNextAudioBlock request that
+        // will use our MixingBus buffer to pull
+        // block to append to the previous buffer
+        juce::AudioSourceChannelInfo copyBufferDest(&audioThreadBuffer, 0, bufferToFill.numSamples);
+
+        // for each input source
+        for (size_t i = 1; i < (size_t)samplePlayers.size(); i++)
+        {
+            if (samplePlayers.getUnchecked(i) == nullptr)
+            {
+                continue;
+            }
+            // get the next audio block in the buffer
+            auto playerStart = std::chrono::steady_clock::now();
+            samplePlayers.getUnchecked(i)->getNextAudioBlock(copyBufferDest);
+            recordSamplePlayerCost(i, playerStart);
+            // abort whenever the buffer is empty
+            if (audioThreadBuffer.getNumSamples() != 0)
+            {
+                // append it to the initial one
+                for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
+                {
+                    bufferToFill.buffer->addFrom(chan, bufferToFill.startSample, audioThreadBuffer, chan, 0,
+                                                 bufferToFill.numSamples);
+                }
+
+                // if the track is currently selected sum its volume
+                if (mixbusDataSource->isTrackSelected(i))
+                {
+                    // append it to the initial one
+                    for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
+                    {
+                        audioThreadSelectionBuffer.addFrom(chan, 0, audioThreadBuffer, chan, 0,
+                                                           bufferToFill.numSamples);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool MixingBus::canUseLoopBed(const juce::AudioSourceChannelInfo &bufferToFill)
+{
+    // the bed must match the current loop, arrangement and selection, and the block must be inside it
+    return loopingToggledOn && loopBed != nullptr && loopBedStartFrame == loopSectionStartFrame &&
+           loopBedEndFrame == loopSectionEndFrame && playCursor >= loopBedStartFrame &&
+           playCursor + bufferToFill.numSamples - 1 <= loopBedEndFrame &&
+           loopBedArrangementGeneration == arrangementGeneration.load() &&
+           loopBedSelectionGeneration == mixbusDataSource->getSelectionGeneration();
+}
+
+void MixingBus::mixSelectionOverLoopBed(const juce::AudioSourceChannelInfo &bufferToFill)
+{
+    // start from the pre-rendered non selected samples
+    int bedOffset = int(playCursor - loopBedStartFrame);
+    for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
+    {
+        bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample, *loopBed, chan % loopBed->getNumChannels(),
+                                      bedOffset, bufferToFill.numSamples);
+    }
+
+    audioThreadBuffer.setSize(juce::jmax(1, bufferToFill.buffer->getNumChannels()),
+                              bufferToFill.buffer->getNumSamples(), false, false, true);
+    juce::AudioSourceChannelInfo copyBufferDest(&audioThreadBuffer, 0, bufferToFill.numSamples);
+
+    // and add the selected ones live, as they are the ones being edited
+    for (size_t i = 0; i < (size_t)samplePlayers.size(); i++)
+    {
+        if (samplePlayers.getUnchecked(i) == nullptr)
+        {
+            continue;
+        }
+        // the selection the bed was rendered without, the live one may be changing meanwhile
+        if (i >= loopBedSelectedPlayers.size() || !loopBedSelectedPlayers[i])
+        {
+            // its position is not moving forward anymore
+            samplePlayersPositionOutdated = true;
+            continue;
+        }
+        auto playerStart = std::chrono::steady_clock::now();
+        samplePlayers.getUnchecked(i)->getNextAudioBlock(copyBufferDest);
+        recordSamplePlayerCost(i, playerStart);
+        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); chan++)
+        {
+            bufferToFill.buffer->addFrom(chan, bufferToFill.startSample, audioThreadBuffer, chan, 0,
+                                         bufferToFill.numSamples);
+            audioThreadSelectionBuffer.addFrom(chan, 0, audioThreadBuffer, chan, 0, bufferToFill.numSamples);
+        }
+    }
+}
+
+void MixingBus::recordSamplePlayerCost(size_t playerId, std::chrono::steady_clock::time_point start)
+{
+    float micros = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+    auto &player = samplePlayers.getReference((int)playerId);
+    audioLoadMeter.recordPlayerCost((int)playerId, micros, player->getLowPassRepeat() + player->getHighPassRepeat());
+}
+
+void MixingBus::recordAudioCallbackLoad(std::chrono::steady_clock::time_point start, int numFrames)
+{
+    float micros = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (audioLoadMeter.recordCallback(micros, numFrames, currentAudioSpec.sampleRate))
+    {
+        mixbusDataSource->setAudioCallbackLoad(audioLoadMeter.getLoad());
+    }
+}
+
 // background thread content for allocating stuff
 void MixingBus::run()
 {
@@ -907,6 +1043,12 @@ void MixingBus::run()
         checkForCursorRedraw();
         // check for buffers to free
         checkForBuffersToFree();
+        // render the samples that are not edited anymore
+        checkForSamplesToFreeze();
+        // pre-render the loop section without the samples being edited
+        checkForLoopBedToRender();
+        // prime the linear phase filters for the loop wraps
+        checkForLinearPhaseFiltersToPrepare();
         // do we need to stop playback because the cursor is not in bounds ?
         pauseIfCursorNotInBound();
         // wait untill next thread iteration
@@ -931,6 +1073,280 @@ void MixingBus::checkForBuffersToFree()
     sharedAudioFileBuffers->releaseUnusedBuffers();
 }
 
+void MixingBus::checkForSamplesToFreeze()
+{
+    for (int i = 0; !threadShouldExit(); i++)
+    {
+        std::shared_ptr<SamplePlayer> sp;
+        {
+            const juce::ScopedLock lock(mixbusMutex);
+            if (i >= samplePlayers.size())
+            {
+                return;
+            }
+            sp = samplePlayers.getUnchecked(i);
+        }
+
+        if (sp == nullptr || !sp->hasBeenInitialized())
+        {
+            continue;
+        }
+
+        // keep memory usage in check
+        if (sp->getLength() > SAMPLEPLAYER_FREEZE_MAX_FRAMES)
+        {
+            sp->unfreeze();
+            continue;
+        }
+
+        // only freeze samples that are not being edited, and not those evicted to stay in the budget
+        juce::uint32 msSinceChange = sp->msSinceLastParametersChange(sp->getParametersHash());
+        if (msSinceChange >= SAMPLEPLAYER_FREEZE_DELAY_MS && sp->isFreezeStale() && !sp->isFreezeEvicted())
+        {
+            if (!makeRoomForFreeze(sp))
+            {
+                continue;
+            }
+            sp->freeze();
+            // rendering can take some time, don't let the cursor lag behind
+            checkForCursorRedraw();
+        }
+    }
+}
+
+bool MixingBus::makeRoomForFreeze(const std::shared_ptr<SamplePlayer> &candidate)
+{
+    size_t budget = freezeMemoryBudget.load();
+    size_t neededBytes = candidate->getFreezeBytes();
+    if (neededBytes > budget)
+    {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<SamplePlayer>> players;
+    {
+        const juce::ScopedLock lock(mixbusMutex);
+        for (int i = 0; i < samplePlayers.size(); i++)
+        {
+            if (samplePlayers.getUnchecked(i) != nullptr && samplePlayers.getUnchecked(i) != candidate)
+            {
+                players.push_back(samplePlayers.getUnchecked(i));
+            }
+        }
+    }
+
+    // the last use times are copied as the audio thread keeps updating them
+    std::vector<std::pair<juce::uint32, std::shared_ptr<SamplePlayer>>> frozenPlayers;
+    size_t usedBytes = 0;
+    for (auto &sp : players)
+    {
+        size_t frozenBytes = sp->getFrozenBufferBytes();
+        if (frozenBytes > 0)
+        {
+            usedBytes += frozenBytes;
+            frozenPlayers.emplace_back(sp->getFrozenBufferLastUseMs(), sp);
+        }
+    }
+
+    // evict the least recently played first
+    std::sort(frozenPlayers.begin(), frozenPlayers.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (size_t i = 0; i < frozenPlayers.size() && usedBytes + neededBytes > budget; i++)
+    {
+        usedBytes -= juce::jmin(usedBytes, frozenPlayers[i].second->getFrozenBufferBytes());
+        frozenPlayers[i].second->evictFrozenBuffer();
+    }
+
+    return true;
+}
+
+void MixingBus::setFreezeMemoryBudget(size_t bytes)
+{
+    freezeMemoryBudget = bytes;
+}
+
+void MixingBus::checkForLinearPhaseFiltersToPrepare()
+{
+    int64_t loopStart;
+    std::vector<std::shared_ptr<SamplePlayer>> players;
+    {
+        const juce::ScopedLock lock(mixbusMutex);
+        if (!loopingToggledOn)
+        {
+            return;
+        }
+        loopStart = loopSectionStartFrame;
+        for (int i = 0; i < samplePlayers.size(); i++)
+        {
+            players.push_back(samplePlayers.getUnchecked(i));
+        }
+    }
+
+    for (auto &sp : players)
+    {
+        if (threadShouldExit())
+        {
+            return;
+        }
+        // this does nothing if the filter was already prepared for this loop start
+        if (sp != nullptr && sp->hasBeenInitialized() && sp->isLinearPhaseFiltering())
+        {
+            sp->prepareLinearPhaseFilterAt(loopStart);
+        }
+    }
+}
+
+void MixingBus::checkForLoopBedToRender()
+{
+    // read generations before the state they describe so that a change
+    // happening while we render makes the bed unusable instead of wrong
+    uint64_t arrangementGen = arrangementGeneration.load();
+    uint64_t selectionGen = mixbusDataSource->getSelectionGeneration();
+
+    // the loop bounds are written by the task handler under the same lock the audio thread reads them with
+    bool looping;
+    int64_t loopStart, loopEnd;
+    {
+        const juce::ScopedLock lock(mixbusMutex);
+        looping = loopingToggledOn;
+        loopStart = loopSectionStartFrame;
+        loopEnd = loopSectionEndFrame;
+        loopBedPlayersSnapshot.clear();
+        for (int i = 0; i < samplePlayers.size(); i++)
+        {
+            loopBedPlayersSnapshot.push_back(samplePlayers.getUnchecked(i));
+        }
+    }
+    int64_t loopLength = (loopEnd - loopStart) + 1;
+
+    // free the bed memory when it can't be used anymore
+    if (!looping || loopLength <= 0 || loopLength > MIXBUS_LOOP_BED_MAX_FRAMES)
+    {
+        loopBedPlayersSnapshot.clear();
+        if (loopBed != nullptr)
+        {
+            std::shared_ptr<juce::AudioSampleBuffer> oldBed;
+            {
+                const juce::ScopedLock lock(mixbusMutex);
+                oldBed.swap(loopBed);
+            }
+        }
+        return;
+    }
+
+    // the selection is being changed, the bits can't be trusted: retry at next iteration
+    if (MixbusDataSource::isSelectionBeingUpdated(selectionGen))
+    {
+        loopBedPlayersSnapshot.clear();
+        return;
+    }
+
+    // hash everything the bed content depends on
+    size_t key = std::hash<int64_t>()(loopStart);
+    // same mixing as boost::hash_combine
+    auto combine = [&key](size_t value) { key ^= value + 0x9e3779b9 + (key << 6) + (key >> 2); };
+    combine(std::hash<int64_t>()(loopEnd));
+    std::vector<std::shared_ptr<SamplePlayer>> bedPlayers;
+    std::vector<char> selectedPlayers(loopBedPlayersSnapshot.size(), 0);
+    for (size_t i = 0; i < loopBedPlayersSnapshot.size(); i++)
+    {
+        auto &sp = loopBedPlayersSnapshot[i];
+        if (sp == nullptr || !sp->hasBeenInitialized())
+        {
+            continue;
+        }
+        bool selected = mixbusDataSource->isTrackSelected(i);
+        selectedPlayers[i] = selected;
+        combine(std::hash<size_t>()(i));
+        combine(std::hash<bool>()(selected));
+        if (selected)
+        {
+            continue;
+        }
+        combine(sp->getParametersHash());
+        combine(std::hash<int64_t>()(sp->getEditingPosition()));
+
+        // filters keep ringing after the sample end, and the linear phase one also rings before its start
+        int64_t playerStart = sp->getEditingPosition() - LINEAR_PHASE_FILTER_LATENCY;
+        int64_t playerEnd = sp->getEditingPosition() + sp->getLength() + SAMPLEPLAYER_FREEZE_TAIL_FRAMES;
+        if (playerStart <= loopEnd && playerEnd >= loopStart)
+        {
+            bedPlayers.push_back(sp);
+        }
+    }
+    loopBedPlayersSnapshot.clear();
+
+    // the selection changed while its bits were read, they may mix the old and new one
+    if (selectionGen != mixbusDataSource->getSelectionGeneration())
+    {
+        return;
+    }
+
+    // nothing changed, the current bed only needs to be marked as up to date
+    if (loopBed != nullptr && key == loopBedKey)
+    {
+        const juce::ScopedLock lock(mixbusMutex);
+        loopBedArrangementGeneration = arrangementGen;
+        loopBedSelectionGeneration = selectionGen;
+        return;
+    }
+
+    auto bed = std::make_shared<juce::AudioSampleBuffer>(2, (int)loopLength);
+    bed->clear();
+    juce::AudioSampleBuffer block(2, SAMPLEPLAYER_FREEZE_BLOCK_SIZE);
+
+    for (auto &sp : bedPlayers)
+    {
+        // give up if the bed would be outdated anyway, we'll retry at next iteration
+        if (threadShouldExit() || arrangementGen != arrangementGeneration.load() ||
+            selectionGen != mixbusDataSource->getSelectionGeneration())
+        {
+            return;
+        }
+
+        std::shared_ptr<SamplePlayer> renderer = sp->createRenderCopy();
+        if (renderer == nullptr)
+        {
+            continue;
+        }
+
+        // start a bit before the loop so that filters are settled when it starts
+        int64_t renderPosition = loopStart - MIXBUS_LOOP_BED_PREROLL_FRAMES;
+        renderer->setNextReadPosition(renderPosition);
+        while (renderPosition < loopStart)
+        {
+            int len = (int)juce::jmin((int64_t)SAMPLEPLAYER_FREEZE_BLOCK_SIZE, loopStart - renderPosition);
+            renderer->getNextAudioBlock(juce::AudioSourceChannelInfo(&block, 0, len));
+            renderPosition += len;
+        }
+
+        for (int64_t offset = 0; offset < loopLength; offset += SAMPLEPLAYER_FREEZE_BLOCK_SIZE)
+        {
+            int len = (int)juce::jmin((int64_t)SAMPLEPLAYER_FREEZE_BLOCK_SIZE, loopLength - offset);
+            renderer->getNextAudioBlock(juce::AudioSourceChannelInfo(&block, 0, len));
+            for (int chan = 0; chan < bed->getNumChannels(); chan++)
+            {
+                bed->addFrom(chan, (int)offset, block, chan, 0, len);
+            }
+        }
+
+        // rendering can take some time, don't let the cursor lag behind
+        checkForCursorRedraw();
+    }
+
+    {
+        const juce::ScopedLock lock(mixbusMutex);
+        loopBed.swap(bed);
+        loopBedSelectedPlayers.swap(selectedPlayers);
+        loopBedStartFrame = loopStart;
+        loopBedEndFrame = loopEnd;
+        loopBedArrangementGeneration = arrangementGen;
+        loopBedSelectionGeneration = selectionGen;
+    }
+    loopBedKey = key;
+    // the previous bed is freed here, outside of the lock
+}
+
 void MixingBus::importNewFile(std::shared_ptr<SampleCreateTask> task)
 {
     // get the necessary task parameters
@@ -1079,6 +1495,8 @@ void MixingBus::deleteSample(std::shared_ptr<SampleDeletionTask> deletionTask)
     // we save a reference to this sample in the tasks list to restore it if
     // users wants to.
     deletionTask->deletedSample = samplePlayers[deletionTask->id];
+    // no need to keep its rendered output around while it sits in history
+    deletionTask->deletedSample->unfreeze();
 
     // clear this sample
     {
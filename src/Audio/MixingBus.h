@@ -6,11 +6,14 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "../Arrangement/ActivityManager.h"
 #include "AudioFilesBufferStore.h"
+#include "AudioLoadMeter.h"
 #include "DataSource.h"
 #include "MixbusDataSource.h"
 #include "SamplePlayer.h"
@@ -39,6 +42,7 @@ class MixingBus : public juce::PositionableAudioSource, public TaskListener, pub
 
     /**
      * @brief reset the state of the mixbus to a fresh new one. (used for reseting app state.)
+     *        The audio callback deadline misses are kept as they count since startup.
      */
     void reset();
 
@@ -118,6 +122,15 @@ class MixingBus : public juce::PositionableAudioSource, public TaskListener, pub
      */
     std::shared_ptr<MixbusDataSource> getMixbusDataSource();
 
+    /**
+     * @brief      Sets how much memory the frozen samples can take. When freezing a sample
+     *             would go over it, the frozen samples played the longest time ago are
+     *             unfrozen. Can be called from any thread.
+     *
+     * @param[in]  bytes  The memory budget in bytes.
+     */
+    void setFreezeMemoryBudget(size_t bytes);
+
     /**
      * @brief      Dump the state of the Mixbus into a JSON string.
      *
@@ -155,11 +168,33 @@ class MixingBus : public juce::PositionableAudioSource, public TaskListener, pub
     int64_t loopSectionStartFrame, loopSectionEndFrame;
 
     // a shared pointer to an instance of a MixbusDataSource we can share with GUI
-    // (it has a builtin lock)
+    // (it never locks)
     std::shared_ptr<MixbusDataSource> mixbusDataSource;
 
     VuMeterData vuMeterVolumes;
 
+    // audio callback timings being aggregated by the audio thread
+    AudioLoadMeter audioLoadMeter;
+
+    // pre-rendered mix of the loop section without the selected samples
+    std::shared_ptr<juce::AudioSampleBuffer> loopBed;
+    // loop section the loop bed was rendered for
+    int64_t loopBedStartFrame, loopBedEndFrame;
+    // flag for each sample player telling if it was selected, and thus left out of the loop bed
+    std::vector<char> loopBedSelectedPlayers;
+    // generations the loop bed was last checked against
+    uint64_t loopBedArrangementGeneration, loopBedSelectionGeneration;
+    // hash of everything the loop bed content depends on (only used by background thread)
+    size_t loopBedKey;
+    // reused by the background thread to copy the sample players list
+    std::vector<std::shared_ptr<SamplePlayer>> loopBedPlayersSnapshot;
+    // incremented each time a task changed what the samples play
+    std::atomic<uint64_t> arrangementGeneration{0};
+    // memory the frozen buffers can take, in bytes
+    std::atomic<size_t> freezeMemoryBudget{(size_t)SAMPLEPLAYER_DEFAULT_FREEZE_MEMORY_MB << 20};
+    // true when non selected samples were skipped because the loop bed was played
+    bool samplePlayersPositionOutdated;
+
     /** NOTES FROM JUCE FORUM ON MIXING Audio Sources:
     You can connect your AudioTransportSources to a MixerAudioSource 10, and call
     the mixers’s getNextAudioBlock() instead (which will then call the individual
@@ -242,6 +277,80 @@ class MixingBus : public juce::PositionableAudioSource, public TaskListener, pub
     // used to manage background thread allocations
     void checkForBuffersToFree();
 
+    /**
+     * @brief      Freeze the processed output of the samples whose parameters
+     *             haven't changed for SAMPLEPLAYER_FREEZE_DELAY_MS so that the audio
+     *             thread only has to copy it. Called from the background thread.
+     */
+    void checkForSamplesToFreeze();
+
+    /**
+     * @brief      Unfreezes the least recently played samples until the frozen buffers
+     *             plus the new one fit in the freeze memory budget.
+     *
+     * @param[in]  candidate  The sample player that is about to be frozen.
+     *
+     * @return     False if the candidate can't fit even once everything else is unfrozen.
+     */
+    bool makeRoomForFreeze(const std::shared_ptr<SamplePlayer> &candidate);
+
+    /**
+     * @brief      Render the loop section without the selected samples so that while
+     *             looping, the audio thread only computes the samples being edited.
+     *             The bed is re-rendered only when the loop bounds, the selection or a
+     *             non selected sample changed. Called from the background thread.
+     */
+    void checkForLoopBedToRender();
+
+    /**
+     * @brief      Prime the linear phase filters of the samples for a playback from the loop
+     *             start, so that the audio thread doesn't have to at each loop wrap.
+     *             Called from the background thread.
+     */
+    void checkForLinearPhaseFiltersToPrepare();
+
+    /**
+     * @brief      Stop using the loop bed until the background thread checked it against
+     *             the sample players again, and wake that thread up.
+     *             Called by the tasks that change what a sample player plays.
+     */
+    void invalidateLoopBed();
+
+    /**
+     * @brief      Mix all the sample players into the buffer, and the selected ones into
+     *             the selection buffer. Called from the audio thread.
+     */
+    void mixAllSamplePlayers(const juce::AudioSourceChannelInfo &bufferToFill);
+
+    /**
+     * @brief      Tells if the loop bed is up to date and covers this whole block.
+     */
+    bool canUseLoopBed(const juce::AudioSourceChannelInfo &bufferToFill);
+
+    /**
+     * @brief      Copy the loop bed into the buffer and mix the selected sample players
+     *             on top of it. Called from the audio thread.
+     */
+    void mixSelectionOverLoopBed(const juce::AudioSourceChannelInfo &bufferToFill);
+
+    /**
+     * @brief      Record in the current load window how long a sample player
+     *             took to compute its audio block. Called from the audio thread.
+     *
+     * @param[in]  playerId  The sample player index.
+     * @param[in]  start     The time at which the sample player started processing.
+     */
+    void recordSamplePlayerCost(size_t playerId, std::chrono::steady_clock::time_point start);
+
+    /**
+     * @brief      Update the audio callback load values and publish them to
+     *             the data source. Called at the end of each audio callback.
+     *
+     * @param[in]  start      The time at which the callback started.
+     * @param[in]  numFrames  The number of audio frames the callback computed.
+     */
+    void recordAudioCallbackLoad(std::chrono::steady_clock::time_point start, int numFrames);
+
     void addSample(std::shared_ptr<SampleCreateTask> import);
     void deleteSample(std::shared_ptr<SampleDeletionTask> task);
     void restoreSample(std::shared_ptr<SampleRestoreTask> task);
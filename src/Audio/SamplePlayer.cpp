@@ -4,7 +4,9 @@
 #include "UnitConverter.h"
 
 #include <complex>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 
@@ -12,7 +14,11 @@ int SamplePlayer::maxFilterFreq = (AUDIO_FRAMERATE >> 1) - 1;
 
 SamplePlayer::SamplePlayer(int64_t position)
     : editingPosition(position), bufferInitialPosition(0), bufferStart(0), bufferEnd(0), position(0),
-      lowPassFreq(maxFilterFreq), highPassFreq(0), audioBufferRef(), isSampleSet(false), numFft(0)
+      lowPassFreq(maxFilterFreq), highPassFreq(0), audioBufferRef(), isSampleSet(false), numFft(0),
+      frozenParametersHash(0), frozenBufferOffset(0), frozenBufferLastUseMs(0), frozenBufferEvicted(false),
+      evictedParametersHash(0), parametersHash(0), lastSeenParametersHash(0), lastParametersChangeMs(0),
+      linearPhaseFiltering(false), linearPhaseFilterNeedsPriming(true), linearPhaseFilterPrimedAtOnce(false),
+      preparedLinearPhasePosition(0), preparedLinearPhaseHash(0), processedLinearPhaseFilter(nullptr)
 {
 
     audioBufferFrequencies = std::make_shared<std::vector<float>>();
@@ -30,6 +36,8 @@ SamplePlayer::SamplePlayer(int64_t position)
     setGainRamp(SAMPLEPLAYER_DEFAULT_FADE_IN_MS);
     setFadeInLength((AUDIO_FRAMERATE / 1000.0) * SAMPLEPLAYER_DEFAULT_FADE_IN_MS);
     setFadeOutLength((AUDIO_FRAMERATE / 1000.0) * SAMPLEPLAYER_DEFAULT_FADE_OUT_MS);
+
+    refreshParametersHash();
 }
 
 SamplePlayer::~SamplePlayer()
@@ -44,11 +52,11 @@ json SamplePlayer::toJSON()
     std::string filePath = "";
     int bufferLen = 0;
 
-    if (audioBufferRef.data != nullptr)
+    if (audioBufferRef.hasAudio())
     {
         filename = juce::File(audioBufferRef.fileFullPath).getFileName().toStdString();
         filePath = audioBufferRef.fileFullPath;
-        bufferLen = audioBufferRef.data->getNumSamples();
+        bufferLen = audioBufferRef.getNumSamples();
     }
 
     json output = {{"file_name", filename},
@@ -63,7 +71,8 @@ json SamplePlayer::toJSON()
                    {"low_pass_repeat", lowPassRepeat},
                    {"high_pass_repeat", highPassRepeat},
                    {"fade_in_frame_len", fadeInFrameLength},
-                   {"fade_out_frame_len", fadeOutFrameLength}};
+                   {"fade_out_frame_len", fadeOutFrameLength},
+                   {"linear_phase_filters", linearPhaseFiltering}};
 
     return output;
 }
@@ -78,7 +87,7 @@ void SamplePlayer::setupFromJSON(json &stateToRestore)
     stateToRestore.at("file_path").get_to(path);
 
     // abort if the sample was not loaded
-    if (audioBufferRef.data == nullptr)
+    if (!audioBufferRef.hasAudio())
     {
         throw std::runtime_error("A sample player had no buffer set when loaded!");
     }
@@ -87,7 +96,7 @@ void SamplePlayer::setupFromJSON(json &stateToRestore)
     // that was loaded at the moment the json was generated
     int desiredBufferLen;
     stateToRestore.at("audio_buffer_len").get_to(desiredBufferLen);
-    if (desiredBufferLen != audioBufferRef.data->getNumSamples())
+    if (desiredBufferLen != audioBufferRef.getNumSamples())
     {
         throw std::runtime_error("A sample player was loaded with a disk file that has different size: " + path);
     }
@@ -154,11 +163,22 @@ void SamplePlayer::setupFromJSON(json &stateToRestore)
 
     fadeInFrameLength = desiredFadeInLen;
     fadeOutFrameLength = desiredFadeOutLen;
+
+    // projects saved before linear phase filters existed don't have this key
+    if (stateToRestore.contains("linear_phase_filters"))
+    {
+        bool desiredLinearPhaseFiltering;
+        stateToRestore.at("linear_phase_filters").get_to(desiredLinearPhaseFiltering);
+        setLinearPhaseFiltering(desiredLinearPhaseFiltering);
+    }
+
+    refreshParametersHash();
 }
 
 void SamplePlayer::setDbGain(float gainDb)
 {
     gainValue = juce::Decibels::decibelsToGain(gainDb);
+    refreshParametersHash();
 }
 
 float SamplePlayer::getDbGain()
@@ -174,13 +194,11 @@ void SamplePlayer::setGainRamp(float ms)
     {
         fadeInFrameLength = 0;
         fadeOutFrameLength = 0;
-        return;
     }
     else if (ms > SAMPLEPLAYER_MAX_FADE_MS)
     {
         fadeInFrameLength = SAMPLEPLAYER_MAX_FADE_MS * (float(AUDIO_FRAMERATE) / 1000.0);
         fadeOutFrameLength = SAMPLEPLAYER_MAX_FADE_MS * (float(AUDIO_FRAMERATE) / 1000.0);
-        return;
     }
     else if (2 * frameLength >= getLength())
     {
@@ -192,6 +210,8 @@ void SamplePlayer::setGainRamp(float ms)
         fadeInFrameLength = frameLength;
         fadeOutFrameLength = frameLength;
     }
+
+    refreshParametersHash();
 }
 
 bool SamplePlayer::setFadeInLength(int length)
@@ -201,6 +221,7 @@ bool SamplePlayer::setFadeInLength(int length)
         return false;
     }
     fadeInFrameLength = length;
+    refreshParametersHash();
     return true;
 }
 
@@ -211,6 +232,7 @@ bool SamplePlayer::setFadeOutLength(int length)
         return false;
     }
     fadeOutFrameLength = length;
+    refreshParametersHash();
     return true;
 }
 
@@ -235,7 +257,13 @@ void SamplePlayer::setBuffer(AudioFileBufferRef targetBuffer)
     const juce::SpinLock::ScopedLockType lock(playerMutex);
     audioBufferRef = targetBuffer;
 
-    int numSamples = targetBuffer.data->getNumSamples();
+    // compressed buffers are played through a cache of decoded blocks
+    if (targetBuffer.compressedData != nullptr)
+    {
+        decodedBlocks.prepare(targetBuffer.getNumChannels());
+    }
+
+    int numSamples = targetBuffer.getNumSamples();
     numFft = FftRunner::getNumFftFromNumSamples(numSamples);
 
     // reset sample length
@@ -249,6 +277,8 @@ void SamplePlayer::setBuffer(AudioFileBufferRef targetBuffer)
     setGainRamp(SAMPLEPLAYER_DEFAULT_FADE_IN_MS);
     setFadeInLength((AUDIO_FRAMERATE / 1000.0) * SAMPLEPLAYER_DEFAULT_FADE_IN_MS);
     setFadeOutLength((AUDIO_FRAMERATE / 1000.0) * SAMPLEPLAYER_DEFAULT_FADE_OUT_MS);
+
+    refreshParametersHash();
 }
 
 int SamplePlayer::getNumFft() const
@@ -261,12 +291,12 @@ int SamplePlayer::getBufferNumChannels() const
     // note: WE DO NOT CHECK THAT AUDIOBUFFERREF IS SET !
     // beware of segfaults if you play with SamplePlayer
     // outside of the tracks SampleManager list!
-    return audioBufferRef.data->getNumChannels();
+    return audioBufferRef.getNumChannels();
 }
 
 std::string SamplePlayer::getFileName()
 {
-    if (audioBufferRef.data == nullptr)
+    if (!audioBufferRef.hasAudio())
     {
         return "None";
     }
@@ -290,16 +320,17 @@ juce::int64 SamplePlayer::getNextReadPosition() const
 void SamplePlayer::setNextReadPosition(juce::int64 p)
 {
     position = p;
+    linearPhaseFilterNeedsPriming = true;
 }
 
 // length of entire buffer
 juce::int64 SamplePlayer::getTotalLength() const
 {
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
-    return audioBufferRef.data->getNumSamples();
+    return audioBufferRef.getNumSamples();
 }
 
 bool SamplePlayer::isLooping() const
@@ -311,7 +342,7 @@ bool SamplePlayer::isLooping() const
 // move the sample to a new track position
 void SamplePlayer::move(juce::int64 newPosition)
 {
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return;
     }
@@ -322,7 +353,7 @@ void SamplePlayer::move(juce::int64 newPosition)
 void SamplePlayer::setLength(juce::int64 length)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return;
     }
@@ -333,13 +364,13 @@ void SamplePlayer::setLength(juce::int64 length)
     }
 
     const juce::SpinLock::ScopedLockType lock(playerMutex);
-    if (bufferStart + length < audioBufferRef.data->getNumSamples())
+    if (bufferStart + length < audioBufferRef.getNumSamples())
     {
         bufferEnd = bufferStart + length - 1;
     }
     else
     {
-        bufferEnd = audioBufferRef.data->getNumSamples() - 1;
+        bufferEnd = audioBufferRef.getNumSamples() - 1;
     }
 
     checkGainRamps();
@@ -349,7 +380,7 @@ void SamplePlayer::setLength(juce::int64 length)
 juce::int64 SamplePlayer::getLength() const
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -359,7 +390,7 @@ juce::int64 SamplePlayer::getLength() const
 
 int SamplePlayer::getBufferStart() const
 {
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -369,7 +400,7 @@ int SamplePlayer::getBufferStart() const
 
 int SamplePlayer::getBufferEnd() const
 {
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -382,7 +413,7 @@ int SamplePlayer::getBufferEnd() const
 int SamplePlayer::tryMovingStart(int desiredShift)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -415,7 +446,7 @@ int SamplePlayer::tryMovingStart(int desiredShift)
 int SamplePlayer::tryMovingEnd(int desiredShift)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -448,7 +479,7 @@ int SamplePlayer::tryMovingEnd(int desiredShift)
 void SamplePlayer::setBufferShift(juce::int64 shift)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return;
     }
@@ -474,12 +505,15 @@ void SamplePlayer::checkGainRamps()
         fadeInFrameLength = float(getLength()) * fadeInProportion;
         fadeOutFrameLength = getLength() - fadeInFrameLength;
     }
+
+    // the bounds changed before the ramps were checked
+    refreshParametersHash();
 }
 
 // get the shift of the buffer shift
 juce::int64 SamplePlayer::getBufferShift() const
 {
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return 0;
     }
@@ -491,7 +525,7 @@ juce::int64 SamplePlayer::getBufferShift() const
 std::shared_ptr<SamplePlayer> SamplePlayer::createDuplicate(juce::int64 newPosition)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return nullptr;
     }
@@ -506,14 +540,16 @@ std::shared_ptr<SamplePlayer> SamplePlayer::createDuplicate(juce::int64 newPosit
     duplicate->setFadeOutLength(fadeOutFrameLength);
     duplicate->setLowPassRepeat(lowPassRepeat);
     duplicate->setHighPassRepeat(highPassRepeat);
+    duplicate->setLinearPhaseFiltering(linearPhaseFiltering);
     duplicate->gainValue = gainValue;
+    duplicate->refreshParametersHash();
     return duplicate;
 }
 
 std::shared_ptr<SamplePlayer> SamplePlayer::splitAtFrequency(float frequencyLimitHz)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return nullptr;
     }
@@ -555,7 +591,9 @@ std::shared_ptr<SamplePlayer> SamplePlayer::splitAtFrequency(float frequencyLimi
     duplicate->setFadeOutLength(fadeOutFrameLength);
     duplicate->setLowPassRepeat(lowPassRepeat);
     duplicate->setHighPassRepeat(highPassRepeat);
+    duplicate->setLinearPhaseFiltering(linearPhaseFiltering);
     duplicate->gainValue = gainValue;
+    duplicate->refreshParametersHash();
 
     // we are now the high end part
     setHighPassFreq(frequencyLimitHz);
@@ -566,7 +604,7 @@ std::shared_ptr<SamplePlayer> SamplePlayer::splitAtFrequency(float frequencyLimi
 std::shared_ptr<SamplePlayer> SamplePlayer::splitAtPosition(juce::int64 positionLimit)
 {
 
-    if (!isSampleSet || audioBufferRef.data == nullptr)
+    if (!isSampleSet || !audioBufferRef.hasAudio())
     {
         return nullptr;
     }
@@ -592,7 +630,9 @@ std::shared_ptr<SamplePlayer> SamplePlayer::splitAtPosition(juce::int64 position
     duplicate->setFadeOutLength(fadeOutFrameLength);
     duplicate->setLowPassRepeat(lowPassRepeat);
     duplicate->setHighPassRepeat(highPassRepeat);
+    duplicate->setLinearPhaseFiltering(linearPhaseFiltering);
     duplicate->gainValue = gainValue;
+    duplicate->refreshParametersHash();
 
     // we are now the first part
     setLength(positionLimit);
@@ -625,6 +665,7 @@ void SamplePlayer::releaseResources()
 {
     isSampleSet = false;
     audioBufferRef = AudioFileBufferRef();
+    refreshParametersHash();
 }
 
 void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
@@ -632,22 +673,67 @@ void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferT
     // return buffer data like in:
     // https://docs.juce.com/master/tutorial_looping_audio_sample_buffer_advanced.html
 
+    // the frozen buffer if there is one rendered with the current parameters
+    std::shared_ptr<juce::AudioSampleBuffer> retainedFrozenBuffer;
+    int retainedFrozenBufferOffset = 0;
+
+    // the linear phase filter if enabled, and the one primed in the background if any
+    std::shared_ptr<LinearPhaseFilter> retainedLinearPhaseFilter;
+    std::shared_ptr<LinearPhaseFilter> retainedPreparedFilter;
+    std::shared_ptr<LinearPhaseFilter> retainedReplacedFilter;
+    int64_t retainedPreparedPosition = 0;
+    size_t retainedPreparedHash = 0;
+
+    // the audio data if the buffer is kept compressed in memory
+    std::shared_ptr<const CompressedAudioBuffer> retainedCompressedBuffer;
+
     // safely get the current buffer
     auto retainedCurrentBuffer = [&]() -> std::shared_ptr<juce::AudioSampleBuffer> {
         // get scoped lock
         const juce::SpinLock::ScopedTryLockType lock(playerMutex);
 
         if (lock.isLocked())
+        {
+            if (frozenBuffer != nullptr && frozenParametersHash == getParametersHash())
+            {
+                retainedFrozenBuffer = frozenBuffer;
+                retainedFrozenBufferOffset = frozenBufferOffset;
+            }
+            retainedLinearPhaseFilter = linearPhaseFilter;
+            retainedPreparedFilter = preparedLinearPhaseFilter;
+            retainedReplacedFilter = replacedLinearPhaseFilter;
+            retainedPreparedPosition = preparedLinearPhasePosition;
+            retainedPreparedHash = preparedLinearPhaseHash;
+            retainedCompressedBuffer = audioBufferRef.compressedData;
             return audioBufferRef.data;
+        }
 
         return nullptr;
     }();
+    bool hasRetainedAudio = retainedCurrentBuffer != nullptr || retainedCompressedBuffer != nullptr;
+
+    // if the output was already rendered, a copy is all we need
+    if (hasRetainedAudio && retainedFrozenBuffer != nullptr)
+    {
+        playFrozenBuffer(bufferToFill, *retainedFrozenBuffer, retainedFrozenBufferOffset);
+        frozenBufferLastUseMs = juce::Time::getMillisecondCounter();
+        // the linear phase filter history is not fed while we play the frozen buffer
+        linearPhaseFilterNeedsPriming = true;
+        return;
+    }
 
     // return cleared buffer if no buffer is set or if lock failed to be locked.
-    if (retainedCurrentBuffer == nullptr)
+    if (!hasRetainedAudio)
     {
         bufferToFill.clearActiveBufferRegion();
-        applyFilters(bufferToFill);
+        if (linearPhaseFiltering)
+        {
+            linearPhaseFilterNeedsPriming = true;
+        }
+        else
+        {
+            applyFilters(bufferToFill);
+        }
         bufferToFill.buffer->applyGain(gainValue);
         position += bufferToFill.numSamples;
         return;
@@ -655,30 +741,110 @@ void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferT
 
     // samplePlayer audio buffer data
     auto *currentAudioSampleBuffer = retainedCurrentBuffer.get();
-    auto numInputChannels = currentAudioSampleBuffer->getNumChannels();
-    auto numOutputChannels = bufferToFill.buffer->getNumChannels();
-    auto outputSamplesRemaining = bufferToFill.numSamples;
-    // how many samples have we already read ? (in this call to getNextAudioBlock)
-    int64_t outputSamplesOffset = 0;
+
+    // The linear phase filter delays its output, so we read the buffer ahead of the play position.
+    // It also keeps ringing for its whole history length after the sample end.
+    int filterLatency = 0;
+    int filterTail = 0;
+    if (retainedLinearPhaseFilter != nullptr)
+    {
+        filterLatency = LINEAR_PHASE_FILTER_LATENCY;
+        filterTail = LINEAR_PHASE_FILTER_TAPS + LINEAR_PHASE_FILTER_BLOCK_SIZE;
+        int64_t localPosition = position - editingPosition;
+        LinearPhaseFilter &filter = *retainedLinearPhaseFilter;
+
+        // a filter rebuilt by a parameter change goes on from the history of the one it replaced, as the
+        // history holds the input spectrums that don't depend on the kernel. The copy is made here as the
+        // replaced filter was processed by this thread up to now.
+        if (!linearPhaseFilterNeedsPriming && !filter.isPrimed() && !filter.isPriming() &&
+            retainedReplacedFilter != nullptr && retainedReplacedFilter->isPrimed() &&
+            retainedReplacedFilter->getNumChannels() == filter.getNumChannels())
+        {
+            filter.copyStateFrom(*retainedReplacedFilter);
+        }
+        processedLinearPhaseFilter = &filter;
+
+        if (linearPhaseFilterNeedsPriming || (!filter.isPrimed() && !filter.isPriming()))
+        {
+            // a jump that was anticipated in the background only needs a copy of the prepared state
+            if (retainedPreparedFilter != nullptr && retainedPreparedFilter->getKernel() == filter.getKernel() &&
+                retainedPreparedPosition == localPosition && retainedPreparedHash == getParametersHash())
+            {
+                filter.copyStateFrom(*retainedPreparedFilter);
+            }
+            else
+            {
+                startLinearPhaseFilterPriming(filter, localPosition);
+            }
+            linearPhaseFilterNeedsPriming = false;
+        }
+
+        if (!filter.isPrimed())
+        {
+            // priming takes LINEAR_PHASE_FILTER_PRIMING_FRAMES frames, which is too much for a single callback
+            // when several samples jump at once, so it is spread over callbacks while we play silence
+            int64_t maxFrames =
+                linearPhaseFilterPrimedAtOnce
+                    ? std::numeric_limits<int64_t>::max()
+                    : bufferToFill.numSamples + (LINEAR_PHASE_FILTER_PRIMING_BLOCKS_PER_CALLBACK *
+                                                 LINEAR_PHASE_FILTER_BLOCK_SIZE);
+            feedLinearPhaseFilter(filter, currentAudioSampleBuffer, retainedCompressedBuffer.get(), decodedBlocks,
+                                  localPosition + filterLatency, maxFrames);
+        }
+
+        if (!filter.isPrimed())
+        {
+            bufferToFill.clearActiveBufferRegion();
+            position += bufferToFill.numSamples;
+            return;
+        }
+    }
 
     // set position relative to bufferStart
-    bufferInitialPosition = position - editingPosition;
+    bufferInitialPosition = position - editingPosition + filterLatency;
 
     // play nothing if sample is not playing
-    if ((bufferInitialPosition + outputSamplesRemaining) < 0 || bufferInitialPosition > bufferEnd - bufferStart)
+    if ((bufferInitialPosition + bufferToFill.numSamples) < 0 ||
+        bufferInitialPosition > bufferEnd - bufferStart + filterTail)
     {
         bufferToFill.clearActiveBufferRegion();
         position += bufferToFill.numSamples;
         return;
     }
 
-    int64_t skippedSamples = 0;
+    copyBufferFrames(bufferToFill, currentAudioSampleBuffer, retainedCompressedBuffer.get(), decodedBlocks,
+                     bufferInitialPosition);
+
+    // update the global track position stored in the samplePlayer
+    position += bufferToFill.numSamples;
+
+    if (retainedLinearPhaseFilter != nullptr)
+    {
+        retainedLinearPhaseFilter->processSamples(bufferToFill);
+    }
+    else
+    {
+        applyFilters(bufferToFill);
+    }
+    bufferToFill.buffer->applyGain(gainValue);
+}
+
+void SamplePlayer::copyBufferFrames(const juce::AudioSourceChannelInfo &bufferToFill, juce::AudioSampleBuffer *source,
+                                    const CompressedAudioBuffer *compressedSource, DecodedBlockCache &blockCache,
+                                    int64_t localPosition)
+{
+    auto numInputChannels = source != nullptr ? source->getNumChannels() : compressedSource->getNumChannels();
+    auto numOutputChannels = bufferToFill.buffer->getNumChannels();
+    int64_t outputSamplesRemaining = bufferToFill.numSamples;
+    // how many samples have we already read ? (in this call to copyBufferFrames)
+    int64_t outputSamplesOffset = 0;
+
     // pad beginning to start copying after the buffers starts
-    if (bufferInitialPosition < 0)
+    if (localPosition < 0)
     {
-        skippedSamples = -bufferInitialPosition;
+        int64_t skippedSamples = juce::jmin(-localPosition, outputSamplesRemaining);
         // clear region untill the sample plays
-        bufferToFill.buffer->clear(bufferToFill.startSample, skippedSamples);
+        bufferToFill.buffer->clear(bufferToFill.startSample, (int)skippedSamples);
         // move output cursors to the beginning of the sample
         outputSamplesOffset += skippedSamples;
         outputSamplesRemaining -= skippedSamples;
@@ -688,8 +854,8 @@ void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferT
     while (outputSamplesRemaining > 0)
     {
         // decide on how many samples to copy
-        int bufferSamplesRemaining = bufferEnd - (bufferStart + bufferInitialPosition + outputSamplesOffset);
-        int samplesThisTime = juce::jmin(outputSamplesRemaining, bufferSamplesRemaining);
+        int64_t bufferSamplesRemaining = bufferEnd - (bufferStart + localPosition + outputSamplesOffset);
+        int samplesThisTime = (int)juce::jmin(outputSamplesRemaining, bufferSamplesRemaining);
 
         if (samplesThisTime <= 0)
         {
@@ -699,11 +865,22 @@ void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferT
         // copy audio for each channel
         for (auto channel = 0; channel < numOutputChannels; ++channel)
         {
-            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + outputSamplesOffset,
-                                          *currentAudioSampleBuffer, channel % numInputChannels,
-                                          bufferStart + bufferInitialPosition + outputSamplesOffset, samplesThisTime);
-            applyGainFade(bufferToFill.buffer->getWritePointer(channel), bufferToFill.startSample + outputSamplesOffset,
-                          samplesThisTime, bufferInitialPosition + outputSamplesOffset);
+            int sourceStart = bufferStart + (int)(localPosition + outputSamplesOffset);
+            if (source != nullptr)
+            {
+                bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + (int)outputSamplesOffset, *source,
+                                              channel % numInputChannels, sourceStart, samplesThisTime);
+            }
+            else
+            {
+                compressedSource->copyFrames(
+                    blockCache,
+                    bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample + (int)outputSamplesOffset),
+                    channel % numInputChannels, sourceStart, samplesThisTime);
+            }
+            applyGainFade(bufferToFill.buffer->getWritePointer(channel),
+                          bufferToFill.startSample + (int)outputSamplesOffset, samplesThisTime,
+                          (int)(localPosition + outputSamplesOffset));
         }
 
         outputSamplesRemaining -= samplesThisTime;
@@ -714,14 +891,243 @@ void SamplePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferT
     // remaining part
     if (outputSamplesRemaining > 0)
     {
-        bufferToFill.buffer->clear(bufferToFill.startSample + outputSamplesOffset, outputSamplesRemaining);
+        bufferToFill.buffer->clear(bufferToFill.startSample + (int)outputSamplesOffset, (int)outputSamplesRemaining);
+    }
+}
+
+void SamplePlayer::startLinearPhaseFilterPriming(LinearPhaseFilter &filter, int64_t localPosition)
+{
+    // the output at localPosition depends on the input from half the impulse before it,
+    // and the filter holds LINEAR_PHASE_FILTER_TAPS + LINEAR_PHASE_FILTER_BLOCK_SIZE input frames
+    int64_t primingStart = localPosition - (LINEAR_PHASE_FILTER_TAPS >> 1);
+    int64_t primingEnd = localPosition + LINEAR_PHASE_FILTER_LATENCY;
+
+    // a reset filter is in the same state as one fed with silence, so we skip the silence around the sample
+    if (primingStart < 0)
+    {
+        primingStart = juce::jmin((int64_t)0, primingEnd);
+    }
+    if (primingStart > bufferEnd - bufferStart)
+    {
+        primingStart = primingEnd;
+    }
+
+    filter.startPriming(primingStart);
+}
+
+void SamplePlayer::feedLinearPhaseFilter(LinearPhaseFilter &filter, juce::AudioSampleBuffer *source,
+                                         const CompressedAudioBuffer *compressedSource, DecodedBlockCache &blockCache,
+                                         int64_t targetPosition, int64_t maxFrames)
+{
+    int64_t primingPosition = filter.getPrimingPosition();
+    int64_t primingEnd = targetPosition - primingPosition > maxFrames ? primingPosition + maxFrames : targetPosition;
+
+    juce::AudioSampleBuffer &scratch = filter.getScratchBuffer();
+    while (primingPosition < primingEnd)
+    {
+        int length = (int)juce::jmin((int64_t)LINEAR_PHASE_FILTER_BLOCK_SIZE, primingEnd - primingPosition);
+        juce::AudioSourceChannelInfo scratchBlock(&scratch, 0, length);
+        copyBufferFrames(scratchBlock, source, compressedSource, blockCache, primingPosition);
+        filter.processSamples(scratchBlock);
+        primingPosition += length;
+    }
+
+    filter.setPrimingPosition(primingPosition);
+    if (primingPosition >= targetPosition)
+    {
+        filter.setPrimed(true);
+    }
+}
+
+void SamplePlayer::playFrozenBuffer(const juce::AudioSourceChannelInfo &bufferToFill, juce::AudioSampleBuffer &frozen,
+                                    int frozenOffset)
+{
+    // the frozen buffer starts frozenOffset frames before the editing position
+    int frozenPosition = position - editingPosition + frozenOffset;
+    int copyStart = juce::jmax(0, frozenPosition);
+    int copyEnd = juce::jmin(frozen.getNumSamples(), frozenPosition + bufferToFill.numSamples);
+
+    if (copyEnd <= copyStart)
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else
+    {
+        int outputOffset = copyStart - frozenPosition;
+        int samplesToCopy = copyEnd - copyStart;
+
+        if (outputOffset > 0)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample, outputOffset);
+        }
+
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+        {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + outputOffset, frozen,
+                                          channel % frozen.getNumChannels(), copyStart, samplesToCopy);
+        }
+
+        int samplesAfter = bufferToFill.numSamples - (outputOffset + samplesToCopy);
+        if (samplesAfter > 0)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + outputOffset + samplesToCopy, samplesAfter);
+        }
     }
 
-    // update the global track position stored in the samplePlayer
     position += bufferToFill.numSamples;
+}
 
-    applyFilters(bufferToFill);
-    bufferToFill.buffer->applyGain(gainValue);
+size_t SamplePlayer::getParametersHash() const
+{
+    return parametersHash.load();
+}
+
+void SamplePlayer::refreshParametersHash()
+{
+    size_t hash = std::hash<const void *>()(audioBufferRef.getAudioIdentity());
+
+    // same mixing as boost::hash_combine
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    combine(std::hash<int>()(bufferStart));
+    combine(std::hash<int>()(bufferEnd));
+    combine(std::hash<float>()(lowPassFreq));
+    combine(std::hash<float>()(highPassFreq));
+    combine(std::hash<int>()(lowPassRepeat));
+    combine(std::hash<int>()(highPassRepeat));
+    combine(std::hash<float>()(gainValue));
+    combine(std::hash<int>()(fadeInFrameLength));
+    combine(std::hash<int>()(fadeOutFrameLength));
+    combine(std::hash<bool>()(linearPhaseFiltering));
+
+    parametersHash = hash;
+}
+
+bool SamplePlayer::isFreezeStale()
+{
+    return frozenBuffer == nullptr || frozenParametersHash != getParametersHash();
+}
+
+void SamplePlayer::freeze()
+{
+    // we render with a copy of this player, so that its filters state
+    // is not shared with the audio thread.
+    std::shared_ptr<SamplePlayer> renderer = createRenderCopy();
+    if (renderer == nullptr)
+    {
+        return;
+    }
+
+    // if parameters were changed while duplicating, this hash won't match
+    // the player one and the frozen buffer will simply be ignored.
+    size_t renderedHash = renderer->getParametersHash();
+
+    int renderOffset = renderer->getFreezeRenderOffset();
+
+    // render the whole sample as well as the tail of the filters after its end
+    int renderLength = renderOffset + int(renderer->getLength()) + SAMPLEPLAYER_FREEZE_TAIL_FRAMES;
+    auto rendered = std::make_shared<juce::AudioSampleBuffer>(2, renderLength);
+
+    renderer->setNextReadPosition(renderer->getEditingPosition() - renderOffset);
+    for (int blockStart = 0; blockStart < renderLength; blockStart += SAMPLEPLAYER_FREEZE_BLOCK_SIZE)
+    {
+        int blockLength = juce::jmin(SAMPLEPLAYER_FREEZE_BLOCK_SIZE, renderLength - blockStart);
+        juce::AudioSourceChannelInfo block(rendered.get(), blockStart, blockLength);
+        renderer->getNextAudioBlock(block);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(playerMutex);
+        frozenBuffer.swap(rendered);
+        frozenParametersHash = renderedHash;
+        frozenBufferOffset = renderOffset;
+    }
+    frozenBufferLastUseMs = juce::Time::getMillisecondCounter();
+    frozenBufferEvicted = false;
+    // the previous frozen buffer is freed here, outside the lock
+
+    // if the copy didn't end up with our exact parameters, wait for another
+    // SAMPLEPLAYER_FREEZE_DELAY_MS before trying again
+    if (renderedHash != getParametersHash())
+    {
+        lastParametersChangeMs = juce::Time::getMillisecondCounter();
+    }
+}
+
+std::shared_ptr<SamplePlayer> SamplePlayer::createRenderCopy()
+{
+    std::shared_ptr<SamplePlayer> renderer = createDuplicate(editingPosition);
+    if (renderer == nullptr)
+    {
+        return nullptr;
+    }
+    // setters can refuse some fades combinations, so copy them directly
+    renderer->fadeInFrameLength = fadeInFrameLength;
+    renderer->fadeOutFrameLength = fadeOutFrameLength;
+    renderer->refreshParametersHash();
+    // render threads have time, and must not output the silence of a spread priming
+    renderer->linearPhaseFilterPrimedAtOnce = true;
+    return renderer;
+}
+
+void SamplePlayer::unfreeze()
+{
+    std::shared_ptr<juce::AudioSampleBuffer> previousFrozenBuffer;
+    {
+        const juce::SpinLock::ScopedLockType lock(playerMutex);
+        frozenBuffer.swap(previousFrozenBuffer);
+    }
+}
+
+void SamplePlayer::evictFrozenBuffer()
+{
+    unfreeze();
+    frozenBufferEvicted = true;
+    evictedParametersHash = getParametersHash();
+}
+
+bool SamplePlayer::isFreezeEvicted() const
+{
+    return frozenBufferEvicted && evictedParametersHash == getParametersHash();
+}
+
+int SamplePlayer::getFreezeRenderOffset() const
+{
+    // the linear phase filter rings before the sample start
+    return linearPhaseFiltering ? (LINEAR_PHASE_FILTER_TAPS >> 1) : 0;
+}
+
+size_t SamplePlayer::getFreezeBytes() const
+{
+    // freeze() renders two channels
+    size_t frames = size_t(getFreezeRenderOffset() + getLength() + SAMPLEPLAYER_FREEZE_TAIL_FRAMES);
+    return 2 * frames * sizeof(float);
+}
+
+size_t SamplePlayer::getFrozenBufferBytes()
+{
+    const juce::SpinLock::ScopedLockType lock(playerMutex);
+    if (frozenBuffer == nullptr)
+    {
+        return 0;
+    }
+    return size_t(frozenBuffer->getNumChannels()) * size_t(frozenBuffer->getNumSamples()) * sizeof(float);
+}
+
+juce::uint32 SamplePlayer::getFrozenBufferLastUseMs() const
+{
+    return frozenBufferLastUseMs.load();
+}
+
+juce::uint32 SamplePlayer::msSinceLastParametersChange(size_t hash)
+{
+    juce::uint32 now = juce::Time::getMillisecondCounter();
+    if (hash != lastSeenParametersHash)
+    {
+        lastSeenParametersHash = hash;
+        lastParametersChangeMs = now;
+    }
+    return now - lastParametersChangeMs;
 }
 
 void SamplePlayer::applyGainFade(float *data, int startIndex, int length, int startIndexLocalPosition)
@@ -820,9 +1226,21 @@ void SamplePlayer::setLowPassFreq(int freq)
         lowPassFreq = 0;
     }
 
-    if (lowPassFreq >= maxFilterFreq)
+    // clamp before building the linear phase kernel so that it uses the same frequency
+    bool lowPassDisabled = lowPassFreq >= maxFilterFreq;
+    if (lowPassDisabled)
     {
         lowPassFreq = maxFilterFreq;
+    }
+
+    if (linearPhaseFiltering)
+    {
+        updateLinearPhaseFilter();
+    }
+    refreshParametersHash();
+
+    if (lowPassDisabled)
+    {
         for (size_t i = 0; i < SAMPLEPLAYER_MAX_FILTER_REPEAT; i++)
         {
             lowPassFilterLeft[i].makeInactive();
@@ -867,6 +1285,16 @@ void SamplePlayer::setHighPassFreq(int freq)
     if (highPassFreq <= SAMPLEPLAYER_MIN_FILTER_FREQ)
     {
         highPassFreq = 0;
+    }
+
+    if (linearPhaseFiltering)
+    {
+        updateLinearPhaseFilter();
+    }
+    refreshParametersHash();
+
+    if (highPassFreq == 0)
+    {
         for (size_t i = 0; i < SAMPLEPLAYER_MAX_FILTER_REPEAT; i++)
         {
             highPassFilterLeft[i].makeInactive();
@@ -980,6 +1408,12 @@ void SamplePlayer::setHighPassRepeat(int repeat)
         return;
     }
     highPassRepeat = repeat;
+
+    if (linearPhaseFiltering)
+    {
+        updateLinearPhaseFilter();
+    }
+    refreshParametersHash();
 }
 
 int SamplePlayer::getLowPassRepeat()
@@ -994,4 +1428,99 @@ void SamplePlayer::setLowPassRepeat(int v)
         return;
     }
     lowPassRepeat = v;
+
+    if (linearPhaseFiltering)
+    {
+        updateLinearPhaseFilter();
+    }
+    refreshParametersHash();
+}
+
+void SamplePlayer::setLinearPhaseFiltering(bool enabled)
+{
+    if (enabled == linearPhaseFiltering)
+    {
+        return;
+    }
+    linearPhaseFiltering = enabled;
+    updateLinearPhaseFilter();
+    refreshParametersHash();
+}
+
+bool SamplePlayer::isLinearPhaseFiltering() const
+{
+    return linearPhaseFiltering;
+}
+
+void SamplePlayer::prepareLinearPhaseFilterAt(juce::int64 p)
+{
+    int64_t localPosition = p - editingPosition;
+    // read before the parameters so that a change while we prime makes the prepared state unusable
+    size_t hash = getParametersHash();
+
+    std::shared_ptr<LinearPhaseFilter> currentFilter;
+    std::shared_ptr<juce::AudioSampleBuffer> source;
+    std::shared_ptr<const CompressedAudioBuffer> compressedSource;
+    {
+        const juce::SpinLock::ScopedLockType lock(playerMutex);
+        bool hasAudio = audioBufferRef.data != nullptr || audioBufferRef.compressedData != nullptr;
+        if (linearPhaseFilter == nullptr || !hasAudio)
+        {
+            return;
+        }
+        if (preparedLinearPhaseFilter != nullptr &&
+            preparedLinearPhaseFilter->getKernel() == linearPhaseFilter->getKernel() &&
+            preparedLinearPhasePosition == localPosition && preparedLinearPhaseHash == hash)
+        {
+            return;
+        }
+        currentFilter = linearPhaseFilter;
+        source = audioBufferRef.data;
+        compressedSource = audioBufferRef.compressedData;
+    }
+
+    // the filter and the decoded blocks of the audio thread can't be used from here
+    auto prepared = std::make_shared<LinearPhaseFilter>(currentFilter->getKernel(), currentFilter->getNumChannels());
+    DecodedBlockCache blockCache;
+    blockCache.prepare(source != nullptr ? source->getNumChannels() : compressedSource->getNumChannels());
+
+    startLinearPhaseFilterPriming(*prepared, localPosition);
+    feedLinearPhaseFilter(*prepared, source.get(), compressedSource.get(), blockCache,
+                          localPosition + LINEAR_PHASE_FILTER_LATENCY, std::numeric_limits<int64_t>::max());
+
+    {
+        const juce::SpinLock::ScopedLockType lock(playerMutex);
+        preparedLinearPhaseFilter.swap(prepared);
+        preparedLinearPhasePosition = localPosition;
+        preparedLinearPhaseHash = hash;
+    }
+    // the previously prepared filter is freed here, outside the lock
+}
+
+void SamplePlayer::updateLinearPhaseFilter()
+{
+    std::shared_ptr<LinearPhaseFilter> newFilter;
+    if (linearPhaseFiltering)
+    {
+        auto kernel =
+            std::make_shared<const LinearPhaseKernel>(highPassFreq, highPassRepeat, lowPassFreq, lowPassRepeat);
+        newFilter = std::make_shared<LinearPhaseFilter>(kernel, 2);
+    }
+
+    std::shared_ptr<LinearPhaseFilter> droppedFilter;
+    {
+        const juce::SpinLock::ScopedLockType lock(playerMutex);
+        // if the audio thread didn't process the current filter yet, the replaced one is still the last it did
+        if (newFilter == nullptr ||
+            (linearPhaseFilter != nullptr && linearPhaseFilter.get() == processedLinearPhaseFilter.load()))
+        {
+            droppedFilter.swap(replacedLinearPhaseFilter);
+            if (newFilter != nullptr)
+            {
+                replacedLinearPhaseFilter = linearPhaseFilter;
+            }
+        }
+        linearPhaseFilter.swap(newFilter);
+    }
+    // the previous filters are freed here, outside the lock
 }
\ No newline at end of file
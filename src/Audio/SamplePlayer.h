@@ -11,6 +11,7 @@
 #include "../Config.h"
 #include "AudioFilesBufferStore.h"
 #include "FftRunner.h"
+#include "LinearPhaseFilter.h"
 #include "UnitConverter.h"
 
 using json = nlohmann::json;
@@ -171,6 +172,32 @@ class SamplePlayer : public juce::PositionableAudioSource
      */
     void setHighPassRepeat(int repeat);
 
+    /**
+     * @brief      Switch between the cascade of 12dB/octave IIR filters and a linear phase FFT
+     *             convolution filter with the same magnitude response. The latter doesn't smear
+     *             phases around the cut frequencies, at the cost of more computing and of
+     *             LINEAR_PHASE_FILTER_TAPS/2 frames of pre-ringing before transients.
+     *
+     * @param[in]  enabled  True to use the linear phase filter
+     */
+    void setLinearPhaseFiltering(bool enabled);
+
+    /**
+     * @brief      Tells if the linear phase FFT filter is used instead of the IIR filters.
+     */
+    bool isLinearPhaseFiltering() const;
+
+    /**
+     * @brief      Prime a copy of the linear phase filter for a playback starting at this position,
+     *             so that when the playback jumps there (like at each loop start) the audio thread
+     *             only has to copy its state instead of priming the filter over several callbacks.
+     *             It is slow and meant for background threads. Does nothing if linear phase filtering
+     *             is disabled or if the filter is already prepared for this position.
+     *
+     * @param[in]  position  The track position the playback will jump to.
+     */
+    void prepareLinearPhaseFilterAt(juce::int64 position);
+
     /**
      * @brief       Find the frequency at which the filter
      *              (low pass or high pass) will have reduced
@@ -200,6 +227,87 @@ class SamplePlayer : public juce::PositionableAudioSource
      */
     void setupFromJSON(json &object);
 
+    /**
+     * @brief      Gets a hash of every parameter that changes the processed
+     *             output of this player (audio buffer, bounds, filters, fades, gain).
+     *             The track position is not part of it. The hash is computed by the
+     *             setters, so it can be read from any thread without reading the
+     *             parameters themselves.
+     *
+     * @return     The parameters hash.
+     */
+    size_t getParametersHash() const;
+
+    /**
+     * @brief      Tells if the player has no frozen buffer matching its current
+     *             parameters.
+     */
+    bool isFreezeStale();
+
+    /**
+     * @brief      Renders the processed output of the whole sample (and its filters
+     *             tail) into a buffer that getNextAudioBlock will play with a plain copy
+     *             as long as the parameters hash does not change. Meant to be called
+     *             from a background thread, as it can take a while on long samples.
+     */
+    void freeze();
+
+    /**
+     * @brief      Drops the frozen buffer, if any.
+     */
+    void unfreeze();
+
+    /**
+     * @brief      Drops the frozen buffer to make room for other ones. The sample is
+     *             not frozen again until its parameters change, see isFreezeEvicted.
+     */
+    void evictFrozenBuffer();
+
+    /**
+     * @brief      Tells if the frozen buffer was evicted and the parameters didn't change since.
+     */
+    bool isFreezeEvicted() const;
+
+    /**
+     * @brief      Gets how much memory freeze() would take with the current parameters.
+     *
+     * @return     The size in bytes.
+     */
+    size_t getFreezeBytes() const;
+
+    /**
+     * @brief      Gets how much memory the current frozen buffer takes.
+     *
+     * @return     The size in bytes, 0 if not frozen.
+     */
+    size_t getFrozenBufferBytes();
+
+    /**
+     * @brief      Gets when the frozen buffer was last played, or rendered if it was never played.
+     *
+     * @return     The time from juce::Time::getMillisecondCounter.
+     */
+    juce::uint32 getFrozenBufferLastUseMs() const;
+
+    /**
+     * @brief      Creates a copy of this player with the exact same parameters and
+     *             its own filters state, that can be used to render audio from a
+     *             background thread without disturbing the audio thread.
+     *
+     * @return     The copy, or nullptr if no sample is set.
+     */
+    std::shared_ptr<SamplePlayer> createRenderCopy();
+
+    /**
+     * @brief      Called from a background thread with the current parameters hash to
+     *             know for how long the parameters haven't changed.
+     *
+     * @param[in]  hash  The current parameters hash.
+     *
+     * @return     Milliseconds since the parameters last changed as seen by this function.
+     */
+    juce::uint32 msSinceLastParametersChange(size_t hash);
+
   private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplePlayer)
 
@@ -256,7 +364,118 @@ class SamplePlayer : public juce::PositionableAudioSource
     juce::IIRFilter highPassFilterLeft[SAMPLEPLAYER_MAX_FILTER_REPEAT];
     juce::IIRFilter highPassFilterRight[SAMPLEPLAYER_MAX_FILTER_REPEAT];
 
+    // the processed output rendered by freeze(), starting at editingPosition
+    std::shared_ptr<juce::AudioSampleBuffer> frozenBuffer;
+    // the parameters hash frozenBuffer was rendered with
+    size_t frozenParametersHash;
+
+    // how many frames before the editing position the frozen buffer starts at
+    int frozenBufferOffset;
+    // last time the audio thread played the frozen buffer
+    std::atomic<juce::uint32> frozenBufferLastUseMs;
+    // the parameters hash the frozen buffer was evicted with, if it was
+    bool frozenBufferEvicted;
+    size_t evictedParametersHash;
+
+    // the hash returned by getParametersHash, refreshed by the setters
+    std::atomic<size_t> parametersHash;
+
+    // last parameters hash seen by msSinceLastParametersChange and when it changed
+    size_t lastSeenParametersHash;
+    juce::uint32 lastParametersChangeMs;
+
+    // do we filter with the linear phase FFT filter instead of the IIR ones ?
+    bool linearPhaseFiltering;
+    // the linear phase filter matching the current filters parameters, if enabled
+    std::shared_ptr<LinearPhaseFilter> linearPhaseFilter;
+    // set when the read position jumped and the linear phase filter history is wrong
+    bool linearPhaseFilterNeedsPriming;
+    // render copies prime the filter in one go instead of spreading it over callbacks
+    bool linearPhaseFilterPrimedAtOnce;
+
+    // a copy of the linear phase filter primed by a background thread for a playback starting at
+    // the local position, with the parameters of the hash
+    std::shared_ptr<LinearPhaseFilter> preparedLinearPhaseFilter;
+    int64_t preparedLinearPhasePosition;
+    size_t preparedLinearPhaseHash;
+
+    // the last filter the audio thread processed before the filters parameters changed, whose history
+    // the new linear phase filter takes over so that the playback goes on without priming again
+    std::shared_ptr<LinearPhaseFilter> replacedLinearPhaseFilter;
+    // the linear phase filter the audio thread processed last, only compared with, never dereferenced
+    std::atomic<const LinearPhaseFilter *> processedLinearPhaseFilter;
+
+    // decoded blocks of the buffer if it is compressed, only used by the thread that plays the sample
+    DecodedBlockCache decodedBlocks;
+
     void applyFilters(const juce::AudioSourceChannelInfo &bufferToFill);
+
+    /**
+     * @brief      Recomputes the parameters hash. Called by the setters once they changed
+     *             the parameters, from the thread that edits this player.
+     */
+    void refreshParametersHash();
+
+    /**
+     * @brief      How many frames before the editing position freeze() starts rendering.
+     */
+    int getFreezeRenderOffset() const;
+
+    /**
+     * @brief      Rebuild the linear phase filter from the current filters parameters,
+     *             or drop it if linear phase filtering is disabled. The audio thread copies
+     *             the history of the replaced filter into the new one before using it.
+     */
+    void updateLinearPhaseFilter();
+
+    /**
+     * @brief      Start priming the linear phase filter so that once it was fed the audio preceding the
+     *             position, its next output frames are the same as if it had been playing all along.
+     *             The silence before and after the sample is skipped.
+     *
+     * @param      filter         The filter to prime
+     * @param[in]  localPosition  The position of the next output frame relative to the sample start
+     */
+    void startLinearPhaseFilterPriming(LinearPhaseFilter &filter, int64_t localPosition);
+
+    /**
+     * @brief      Feed a filter being primed with the sample audio up to the target position, or with
+     *             at most maxFrames frames. The filter is marked as primed once it reached the target.
+     *
+     * @param      filter            The filter being primed
+     * @param      source            The float audio buffer retained by the caller, null if compressed
+     * @param[in]  compressedSource  The compressed audio buffer retained by the caller, null if stored as floats
+     * @param      blockCache        The decoded blocks cache of the calling thread
+     * @param[in]  targetPosition    The input position relative to the sample start the filter must reach
+     * @param[in]  maxFrames         The maximum number of frames to feed
+     */
+    void feedLinearPhaseFilter(LinearPhaseFilter &filter, juce::AudioSampleBuffer *source,
+                               const CompressedAudioBuffer *compressedSource, DecodedBlockCache &blockCache,
+                               int64_t targetPosition, int64_t maxFrames);
+
+    /**
+     * @brief      Copy the sample audio frames with the gain fades applied into the buffer,
+     *             and clear the parts of the buffer that are out of the sample bounds.
+     *
+     * @param[in]  bufferToFill      The buffer to fill
+     * @param      source            The float audio buffer retained by the caller, null if compressed
+     * @param[in]  compressedSource  The compressed audio buffer retained by the caller, null if stored as floats
+     * @param      blockCache        The decoded blocks cache of the calling thread
+     * @param[in]  localPosition     The position of the first frame to copy relative to the sample start
+     */
+    void copyBufferFrames(const juce::AudioSourceChannelInfo &bufferToFill, juce::AudioSampleBuffer *source,
+                          const CompressedAudioBuffer *compressedSource, DecodedBlockCache &blockCache,
+                          int64_t localPosition);
+
+    /**
+     * @brief      Fill the block by copying the frozen buffer.
+     *
+     * @param[in]  bufferToFill  The buffer to fill
+     * @param[in]  frozen        The frozen buffer retained by the caller
+     * @param[in]  frozenOffset  How many frames before the editing position the frozen buffer starts at
+     */
+    void playFrozenBuffer(const juce::AudioSourceChannelInfo &bufferToFill, juce::AudioSampleBuffer &frozen,
+                          int frozenOffset);
     void applyGainFade(float *data, int startIndex, int length, int startIndexLocalPositon);
 
     /**
@@ -0,0 +1,50 @@
+#include "SpectrogramHitGrid.h"
+
+#include "../Config.h"
+#include <algorithm>
+
+// number of cells over the frequencies of one channel
+#define SPECTROGRAM_HIT_GRID_CELLS_Y (FFT_STORAGE_SCOPE_SIZE / SPECTROGRAM_HIT_GRID_FREQS_PER_CELL)
+
+SpectrogramHitGrid::SpectrogramHitGrid(const std::vector<float> &storedFfts, int nFfts, int nChannels)
+    : numFfts(nFfts), numChannels(nChannels),
+      numCellsX((nFfts + SPECTROGRAM_HIT_GRID_FFTS_PER_CELL - 1) / SPECTROGRAM_HIT_GRID_FFTS_PER_CELL)
+{
+    cells.assign((size_t)numChannels * (size_t)numCellsX * SPECTROGRAM_HIT_GRID_CELLS_Y, MIN_DB);
+
+    // the ffts are read in the order they are stored
+    size_t valueIndex = 0;
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        for (int fft = 0; fft < numFfts; fft++)
+        {
+            size_t cellsRowIndex =
+                (size_t)channel * (size_t)numCellsX + (size_t)(fft / SPECTROGRAM_HIT_GRID_FFTS_PER_CELL);
+            float *cellsRow = &cells[cellsRowIndex * SPECTROGRAM_HIT_GRID_CELLS_Y];
+            for (int freq = 0; freq < FFT_STORAGE_SCOPE_SIZE; freq++)
+            {
+                float &cell = cellsRow[freq / SPECTROGRAM_HIT_GRID_FREQS_PER_CELL];
+                cell = std::max(cell, storedFfts[valueIndex++]);
+            }
+        }
+    }
+}
+
+float SpectrogramHitGrid::getMaxDb(int fftDataIndex, int fftIndex) const
+{
+    int channelSize = numFfts * FFT_STORAGE_SCOPE_SIZE;
+    int channel = fftDataIndex / channelSize;
+    int freq = fftDataIndex - (channel * channelSize);
+    if (channel < 0 || channel >= numChannels || fftIndex < 0 || fftIndex >= numFfts)
+    {
+        return MIN_DB;
+    }
+
+    size_t cellsRow = (size_t)channel * (size_t)numCellsX + (size_t)(fftIndex / SPECTROGRAM_HIT_GRID_FFTS_PER_CELL);
+    return cells[(cellsRow * SPECTROGRAM_HIT_GRID_CELLS_Y) + (size_t)(freq / SPECTROGRAM_HIT_GRID_FREQS_PER_CELL)];
+}
+
+size_t SpectrogramHitGrid::getNumBytes() const
+{
+    return cells.size() * sizeof(float);
+}
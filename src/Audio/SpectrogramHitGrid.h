@@ -0,0 +1,57 @@
+#ifndef DEF_SPECTROGRAM_HIT_GRID_HPP
+#define DEF_SPECTROGRAM_HIT_GRID_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**< Number of consecutive ffts pooled in each cell of the grid */
+#define SPECTROGRAM_HIT_GRID_FFTS_PER_CELL 4
+
+/**< Number of consecutive stored frequencies pooled in each cell of the grid. It must divide FFT_STORAGE_SCOPE_SIZE. */
+#define SPECTROGRAM_HIT_GRID_FREQS_PER_CELL 16
+
+/**
+ * @brief      A coarse copy of the stored ffts of a sample, where each cell keeps the loudest
+ *             decibels of a block of ffts and frequencies. It is all that is needed to tell if the
+ *             mouse is over the visible part of a sample, so the user interface never has to read
+ *             the full ffts. It is immutable once built and can be shared by any number of threads.
+ */
+class SpectrogramHitGrid
+{
+  public:
+    /**
+     * @brief      Builds the grid. It reads all the ffts, so it is meant for loading threads.
+     *
+     * @param[in]  storedFfts   The stored ffts, as computed by FftRunner.
+     * @param[in]  numFfts      The number of ffts per channel.
+     * @param[in]  numChannels  The number of channels.
+     */
+    SpectrogramHitGrid(const std::vector<float> &storedFfts, int numFfts, int numChannels);
+
+    /**
+     * @brief      Gets the loudest decibels of the cell a stored fft value falls in. The value
+     *             is addressed as in the stored ffts, by its index in the first fft and its fft index.
+     *
+     * @param[in]  fftDataIndex  The index of the value in the first fft, the second channel
+     *                           starting after all the ffts of the first one.
+     * @param[in]  fftIndex      The fft index.
+     *
+     * @return     The decibels, between MIN_DB and MAX_DB.
+     */
+    float getMaxDb(int fftDataIndex, int fftIndex) const;
+
+    /**
+     * @brief      Gets the memory taken by the grid cells.
+     */
+    size_t getNumBytes() const;
+
+  private:
+    int numFfts;
+    int numChannels;
+    int numCellsX;
+
+    // loudest decibels of each cell, channel by channel, then fft block by fft block
+    std::vector<float> cells;
+};
+
+#endif // DEF_SPECTROGRAM_HIT_GRID_HPP
@@ -0,0 +1,108 @@
+#ifndef DEF_TRIPLE_BUFFER_HPP
+#define DEF_TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief      A lock free channel to send values from one writer thread (generally
+ *             the audio thread) to one reader thread (generally the message thread).
+ *             It holds three copies of the value: one the writer fills, one the reader
+ *             reads, and a middle one they exchange with a single atomic operation.
+ *             Neither side ever blocks or drops the latest value, and the reader never
+ *             sees a partially written value.
+ *
+ *             T must be default constructible and copy assignable. Copies made by
+ *             write() don't allocate as long as T assignment doesn't (fixed size
+ *             vectors and arrays are fine).
+ */
+template <typename T> class TripleBuffer
+{
+  public:
+    TripleBuffer() : writeIndex(0), readIndex(1), middleState(2)
+    {
+    }
+
+    /**
+     * @brief      Gets the value the writer can fill before calling publish().
+     *             Only call it from the writer thread.
+     */
+    T &getWriteBuffer()
+    {
+        return buffers[writeIndex];
+    }
+
+    /**
+     * @brief      Makes the value filled in the write buffer the latest one available
+     *             to the reader. Only call it from the writer thread.
+     */
+    void publish()
+    {
+        // give our buffer with the fresh flag and take the middle one
+        uint8_t freshState = uint8_t(writeIndex | TRIPLE_BUFFER_FRESH_FLAG);
+        uint8_t previous = middleState.exchange(freshState, std::memory_order_acq_rel);
+        writeIndex = previous & TRIPLE_BUFFER_INDEX_MASK;
+    }
+
+    /**
+     * @brief      Copies the value in the write buffer and publishes it.
+     *             Only call it from the writer thread.
+     */
+    void write(const T &value)
+    {
+        getWriteBuffer() = value;
+        publish();
+    }
+
+    /**
+     * @brief      Fetch the last published value if there is a newer one than the
+     *             one currently read. Only call it from the reader thread.
+     *
+     * @return     True if a new value was fetched.
+     */
+    bool update()
+    {
+        if ((middleState.load(std::memory_order_relaxed) & TRIPLE_BUFFER_FRESH_FLAG) == 0)
+        {
+            return false;
+        }
+        // give our already read buffer and take the fresh one
+        uint8_t previous = middleState.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & TRIPLE_BUFFER_INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief      Gets the latest value fetched by update(). Only call it from the reader
+     *             thread. The reference stays valid and unchanged until the next update().
+     */
+    const T &getReadBuffer() const
+    {
+        return buffers[readIndex];
+    }
+
+    /**
+     * @brief      Fetch the latest published value and return it.
+     *             Only call it from the reader thread.
+     */
+    const T &read()
+    {
+        update();
+        return getReadBuffer();
+    }
+
+  private:
+    static constexpr uint8_t TRIPLE_BUFFER_INDEX_MASK = 0x3;
+    static constexpr uint8_t TRIPLE_BUFFER_FRESH_FLAG = 0x4;
+
+    T buffers[3];
+
+    // only used by the writer thread
+    uint8_t writeIndex;
+    // only used by the reader thread
+    uint8_t readIndex;
+    // index of the exchanged buffer, with TRIPLE_BUFFER_FRESH_FLAG if the reader didn't fetch it yet
+    std::atomic<uint8_t> middleState;
+};
+
+#endif // DEF_TRIPLE_BUFFER_HPP
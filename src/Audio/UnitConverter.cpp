@@ -49,6 +49,34 @@ float UnitConverter::magnifyTextureFrequencyIndexInv(float k)
     return juce::jlimit(0.0f, float(FFT_STORAGE_SCOPE_SIZE - 1), index);
 }
 
+UnitConverter::LookupTables::LookupTables()
+    : magnifiedFftIndexes(FFT_STORAGE_SCOPE_SIZE + 1), magnifiedTextureFrequencyIndexes(FFT_STORAGE_SCOPE_SIZE + 1)
+{
+    for (size_t k = 0; k <= FFT_STORAGE_SCOPE_SIZE; k++)
+    {
+        magnifiedFftIndexes[k] = magnifyFftIndex(float(k));
+        magnifiedTextureFrequencyIndexes[k] = magnifyTextureFrequencyIndex(float(k));
+    }
+}
+
+const UnitConverter::LookupTables &UnitConverter::getLookupTables()
+{
+    static const LookupTables tables;
+    return tables;
+}
+
+float UnitConverter::magnifyFftIndexAt(int k)
+{
+    const std::vector<float> &table = getLookupTables().magnifiedFftIndexes;
+    return k >= 0 && (size_t)k < table.size() ? table[(size_t)k] : magnifyFftIndex(float(k));
+}
+
+float UnitConverter::magnifyTextureFrequencyIndexAt(int k)
+{
+    const std::vector<float> &table = getLookupTables().magnifiedTextureFrequencyIndexes;
+    return k >= 0 && (size_t)k < table.size() ? table[(size_t)k] : magnifyTextureFrequencyIndex(float(k));
+}
+
 float UnitConverter::sigmoid(float val)
 {
     return 1 / (1 + exp(-val));
@@ -129,25 +157,27 @@ float UnitConverter::freqToPositionRatio(float freq)
 
 float UnitConverter::zoomInRange(float v)
 {
-    if (v < 0.4f)
+    if (v < POLYLENS_KNEE_INPUT)
     {
-        return 0.3f * v;
+        return v * (POLYLENS_KNEE_OUTPUT / POLYLENS_KNEE_INPUT);
     }
     else
     {
-        return 0.12f + ((v - 0.4f) * 1.4666666666666668f);
+        return POLYLENS_KNEE_OUTPUT +
+               ((v - POLYLENS_KNEE_INPUT) * ((1.0f - POLYLENS_KNEE_OUTPUT) / (1.0f - POLYLENS_KNEE_INPUT)));
     }
 }
 
 float UnitConverter::zoomInRangeInv(float v)
 {
-    if (v < 0.12f)
+    if (v < POLYLENS_KNEE_OUTPUT)
     {
-        return v * 3.3333333333333335f;
+        return v * (POLYLENS_KNEE_INPUT / POLYLENS_KNEE_OUTPUT);
     }
     else
     {
-        return 0.4f + ((v - 0.12f) * 0.6818181818181818f);
+        return POLYLENS_KNEE_INPUT +
+               ((v - POLYLENS_KNEE_OUTPUT) * ((1.0f - POLYLENS_KNEE_INPUT) / (1.0f - POLYLENS_KNEE_OUTPUT)));
     }
 }
 
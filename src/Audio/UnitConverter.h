@@ -4,6 +4,7 @@
 #include "../Config.h"
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_gui_extra/juce_gui_extra.h>
+#include <vector>
 
 class UnitConverter
 {
@@ -41,6 +42,16 @@ class UnitConverter
      */
     static float magnifyTextureFrequencyIndexInv(float k);
 
+    /**
+     * Same as magnifyFftIndex and magnifyTextureFrequencyIndex for an integer index,
+     * read from a table computed on first use. Indexes outside of the input range of
+     * the function are computed instead.
+     * @param  k index in the input range of the matching function.
+     * @return   the same value as the matching function.
+     */
+    static float magnifyFftIndexAt(int k);
+    static float magnifyTextureFrequencyIndexAt(int k);
+
     /**
      * Increase contrast from stored ffts to displayed
      * texture. Maps from the range [MIN_DB, MAX_DB] to
@@ -111,6 +122,22 @@ class UnitConverter
     static float dbFromBufferChannel(const juce::AudioSourceChannelInfo &buffer, int chan);
 
   private:
+    /**
+     * The index magnifying functions for every integer index of their input range.
+     */
+    struct LookupTables
+    {
+        LookupTables();
+
+        std::vector<float> magnifiedFftIndexes;              /**< [0, FFT_STORAGE_SCOPE_SIZE] */
+        std::vector<float> magnifiedTextureFrequencyIndexes; /**< [0, FFT_STORAGE_SCOPE_SIZE] */
+    };
+
+    /**
+     * Gets the tables, computed by the first call.
+     */
+    static const LookupTables &getLookupTables();
+
     static float magnifyFftPrecomputedFactor1;
     static float magnifyFftPrecomputedFactor2;
 
@@ -24,6 +24,12 @@ Config::Config()
     errMsg = "Not initialized";
     name = "test user";
     mail = "test@user.com";
+    inMemoryCompression = false;
+    freezeMemoryMb = SAMPLEPLAYER_DEFAULT_FREEZE_MEMORY_MB;
+    spectrogramMinDb = MIN_DB;
+    spectrogramMaxDb = MAX_DB;
+    spectrogramColormap = false;
+    spectrogramGpuMemoryMb = SPECTROGRAM_DEFAULT_GPU_MEMORY_MB;
 }
 
 Config::Config(std::string configFilePath)
@@ -69,6 +75,12 @@ Config::Config(std::string configFilePath)
 
         parseBufferSize(config);
 
+        parseInMemoryCompression(config);
+
+        parseFreezeMemory(config);
+
+        parseDisplaySettings(config);
+
         invalid = false;
     }
     catch (std::runtime_error err)
@@ -379,6 +391,11 @@ std::string Config::getDataFolderPath() const
     return dataLibraryPath;
 };
 
+std::string Config::getConfigFolderPath() const
+{
+    return configDirectoryPath;
+}
+
 void Config::parseBufferSize(YAML::Node &n)
 {
     bufferSize = 0;
@@ -402,4 +419,109 @@ void Config::parseBufferSize(YAML::Node &n)
 int Config::getBufferSize() const
 {
     return bufferSize;
-}
\ No newline at end of file
+}
+
+void Config::parseInMemoryCompression(YAML::Node &n)
+{
+    inMemoryCompression = false;
+
+    if (n["AudioSettings"] && n["AudioSettings"].IsMap())
+    {
+        YAML::Node audioParams = n["AudioSettings"];
+        if (audioParams["compressSamplesInMemory"] && audioParams["compressSamplesInMemory"].IsScalar())
+        {
+            inMemoryCompression = audioParams["compressSamplesInMemory"].as<bool>();
+        }
+    }
+}
+
+bool Config::isInMemoryCompressionEnabled() const
+{
+    return inMemoryCompression;
+}
+
+void Config::parseFreezeMemory(YAML::Node &n)
+{
+    freezeMemoryMb = SAMPLEPLAYER_DEFAULT_FREEZE_MEMORY_MB;
+
+    if (n["AudioSettings"] && n["AudioSettings"].IsMap())
+    {
+        YAML::Node audioParams = n["AudioSettings"];
+        if (audioParams["freezeMemoryMb"] && audioParams["freezeMemoryMb"].IsScalar())
+        {
+            freezeMemoryMb = audioParams["freezeMemoryMb"].as<int>();
+
+            // abort if the budget is invalid
+            if (freezeMemoryMb <= 0)
+            {
+                throw std::runtime_error("invalid freeze memory");
+            }
+        }
+    }
+}
+
+int Config::getFreezeMemoryMb() const
+{
+    return freezeMemoryMb;
+}
+
+void Config::parseDisplaySettings(YAML::Node &n)
+{
+    spectrogramMinDb = MIN_DB;
+    spectrogramMaxDb = MAX_DB;
+    spectrogramColormap = false;
+    spectrogramGpuMemoryMb = SPECTROGRAM_DEFAULT_GPU_MEMORY_MB;
+
+    if (n["DisplaySettings"] && n["DisplaySettings"].IsMap())
+    {
+        YAML::Node displayParams = n["DisplaySettings"];
+        if (displayParams["spectrogramMinDb"] && displayParams["spectrogramMinDb"].IsScalar())
+        {
+            spectrogramMinDb = displayParams["spectrogramMinDb"].as<float>();
+        }
+        if (displayParams["spectrogramMaxDb"] && displayParams["spectrogramMaxDb"].IsScalar())
+        {
+            spectrogramMaxDb = displayParams["spectrogramMaxDb"].as<float>();
+        }
+        if (displayParams["spectrogramColormap"] && displayParams["spectrogramColormap"].IsScalar())
+        {
+            spectrogramColormap = displayParams["spectrogramColormap"].as<bool>();
+        }
+        if (displayParams["spectrogramGpuMemoryMb"] && displayParams["spectrogramGpuMemoryMb"].IsScalar())
+        {
+            spectrogramGpuMemoryMb = displayParams["spectrogramGpuMemoryMb"].as<int>();
+
+            // abort if the budget is invalid
+            if (spectrogramGpuMemoryMb <= 0)
+            {
+                throw std::runtime_error("invalid spectrogram GPU memory");
+            }
+        }
+
+        // abort if the range is empty or out of what the ffts store
+        if (spectrogramMinDb >= spectrogramMaxDb || spectrogramMinDb < MIN_DB || spectrogramMaxDb > MAX_DB)
+        {
+            throw std::runtime_error("invalid spectrogram decibels range");
+        }
+    }
+}
+
+float Config::getSpectrogramMinDb() const
+{
+    return spectrogramMinDb;
+}
+
+float Config::getSpectrogramMaxDb() const
+{
+    return spectrogramMaxDb;
+}
+
+bool Config::isSpectrogramColormapEnabled() const
+{
+    return spectrogramColormap;
+}
+
+int Config::getSpectrogramGpuMemoryMb() const
+{
+    return spectrogramGpuMemoryMb;
+}
@@ -27,6 +27,10 @@
 // minimum sizes to draw freqview (arrangement) area
 #define FREQVIEW_MIN_WIDTH 300
 #define FREQVIEW_MIN_HEIGHT 150
+// how many rendered frames between two logs of the rendering statistics, while the perf overlay or CSV is enabled
+#define FREQVIEW_RENDER_STATS_LOG_INTERVAL 600
+// folder of the data folder where the frame costs CSV files are written
+#define FREQVIEW_PERF_CSV_FOLDER "FrameProfiles"
 
 #define FREQVIEW_LABEL_HEIGHT 24
 #define FREQVIEW_LABELS_CORNER_ROUNDING 4.0f
@@ -137,6 +141,20 @@
 #define SAMPLEPLAYER_DEFAULT_FADE_IN_MS 2.0
 #define SAMPLEPLAYER_MAX_FADE_MS 1000.0
 #define SAMPLEPLAYER_MIN_FREQ_DISTANCE_FACTOR 0.06
+// how long a sample parameters must stay unchanged before its processed output is frozen
+#define SAMPLEPLAYER_FREEZE_DELAY_MS 2000
+// samples longer than this are never frozen to bound the memory used by frozen buffers
+#define SAMPLEPLAYER_FREEZE_MAX_FRAMES (60 * AUDIO_FRAMERATE)
+// how many frames after the sample end are rendered to keep the filters tail
+#define SAMPLEPLAYER_FREEZE_TAIL_FRAMES (AUDIO_FRAMERATE >> 2)
+// size of the blocks used to render frozen buffers
+#define SAMPLEPLAYER_FREEZE_BLOCK_SIZE 4096
+// memory the frozen buffers can take when the config doesn't tell
+#define SAMPLEPLAYER_DEFAULT_FREEZE_MEMORY_MB 512
+// loop sections longer than this are never pre-rendered
+#define MIXBUS_LOOP_BED_MAX_FRAMES (120 * AUDIO_FRAMERATE)
+// how many frames are rendered before the loop start to let the filters settle
+#define MIXBUS_LOOP_BED_PREROLL_FRAMES (AUDIO_FRAMERATE >> 2)
 
 #define PLAYCURSOR_WIDTH 3
 #define PLAYCURSOR_GRAB_WIDTH 4
@@ -147,6 +165,9 @@
 #define KEYMAP_SPLIT_SAMPLE_AT_TIME "s"
 #define KEYMAP_UNDO "ctrl + z"
 #define KEYMAP_REDO "ctrl + shift + z"
+#define KEYMAP_TOGGLE_PERF_OVERLAY "ctrl + p"
+#define KEYMAP_TOGGLE_PERF_CSV "ctrl + shift + p"
+#define KEYMAP_TOGGLE_LINEAR_PHASE "l"
 
 // How many frequencies we will store for each fft.
 #define FFT_STORAGE_SCOPE_SIZE 4096
@@ -173,10 +194,17 @@
 #define FFT_MAGNIFY_C 0.88
 
 #define POLYLENS_ONE_ON_TWO_POW_7_10TH 0.6155722066724582
+// knee of the piecewise linear frequency zoom: UnitConverter::zoomInRange maps the
+// input position ratio to the output one, and is linear on both sides of it
+#define POLYLENS_KNEE_INPUT 0.4f
+#define POLYLENS_KNEE_OUTPUT 0.12f
 
 #define MIN_DB -64.0f
 #define MAX_DB 0.0f
 
+// GPU memory the spectrogram tiles can take when the config doesn't tell
+#define SPECTROGRAM_DEFAULT_GPU_MEMORY_MB 64
+
 #define LIBRARY_IDEAL_SEARCH_SIZE_PROPORTION 0.45
 #define LIBRARY_MIN_SEARCH_SIZE 365
 
@@ -290,6 +318,14 @@ class Config
      */
     std::string getDataFolderPath() const;
 
+    /**
+     * @brief      Gets the path to the config folder, ~/.kholors by default.
+     *             It also holds the caches that only make sense on this machine.
+     *
+     * @return     The config folder path.
+     */
+    std::string getConfigFolderPath() const;
+
     /**
      * @brief      Get the size of the audio buffer user picked.
      *
@@ -297,6 +333,51 @@ class Config
      */
     int getBufferSize() const;
 
+    /**
+     * @brief      Tells if the user asked for the samples audio to be kept compressed in memory.
+     *
+     * @return     True if samples are to be compressed.
+     */
+    bool isInMemoryCompressionEnabled() const;
+
+    /**
+     * @brief      Gets the memory the frozen samples can take. When it is full, the frozen
+     *             samples that were not played for the longest time are unfrozen.
+     *
+     * @return     The memory in megabytes.
+     */
+    int getFreezeMemoryMb() const;
+
+    /**
+     * @brief      Gets the lowest decibels displayed by the spectrograms, drawn fully transparent.
+     *
+     * @return     The decibels, between MIN_DB and MAX_DB.
+     */
+    float getSpectrogramMinDb() const;
+
+    /**
+     * @brief      Gets the highest decibels displayed by the spectrograms, drawn fully opaque.
+     *
+     * @return     The decibels, between MIN_DB and MAX_DB.
+     */
+    float getSpectrogramMaxDb() const;
+
+    /**
+     * @brief      Tells if the user asked for spectrograms to be colored by intensity
+     *             instead of using the sample color.
+     *
+     * @return     True if the colormap is to be used.
+     */
+    bool isSpectrogramColormapEnabled() const;
+
+    /**
+     * @brief      Gets the GPU memory the spectrograms can take. When it is full, the spectrograms
+     *             that were not displayed for the longest time are unloaded.
+     *
+     * @return     The memory in megabytes.
+     */
+    int getSpectrogramGpuMemoryMb() const;
+
     /**
      * @brief      Gets the mail.
      *
@@ -323,6 +404,12 @@ class Config
     std::string name;
     std::string mail;
     int bufferSize;
+    bool inMemoryCompression;
+    int freezeMemoryMb;
+    float spectrogramMinDb;
+    float spectrogramMaxDb;
+    bool spectrogramColormap;
+    int spectrogramGpuMemoryMb;
 
     void checkMandatoryParameters(YAML::Node &);
     void checkApiVersion(YAML::Node &);
@@ -335,6 +422,9 @@ class Config
     void parseName(YAML::Node &);
     void parseMail(YAML::Node &);
     void parseBufferSize(YAML::Node &);
+    void parseInMemoryCompression(YAML::Node &);
+    void parseFreezeMemory(YAML::Node &);
+    void parseDisplaySettings(YAML::Node &);
     void parseConfigDirectory(YAML::Node &);
     void parseDataDirectory(YAML::Node &);
 
@@ -0,0 +1,100 @@
+#include "LazyInit.h"
+#include "StartupTracer.h"
+
+#include <algorithm>
+#include <juce_events/juce_events.h>
+
+LazyInit::LazyInit(std::string n, std::function<void()> i) : state(std::make_shared<State>())
+{
+    state->name = std::move(n);
+    state->init = std::move(i);
+    state->done = false;
+
+    std::scoped_lock<std::mutex> lock(getRegistryMutex());
+    getRegistry().push_back(state);
+}
+
+LazyInit::~LazyInit()
+{
+    {
+        std::scoped_lock<std::mutex> lock(getRegistryMutex());
+        std::vector<std::shared_ptr<State>> &registry = getRegistry();
+        registry.erase(std::remove(registry.begin(), registry.end(), state), registry.end());
+    }
+
+    // waits for the initialization if another thread is running it, or makes sure it never runs,
+    // as it uses the object owning this one
+    std::call_once(state->initOnce, [] {});
+}
+
+void LazyInit::ensure()
+{
+    ensure(*state);
+}
+
+void LazyInit::ensure(State &s)
+{
+    // cheap check for the usual case where it already ran
+    if (s.done)
+    {
+        return;
+    }
+
+    std::call_once(s.initOnce, [&s] {
+        StartupPhase phase(s.name);
+        s.init();
+        s.done = true;
+    });
+}
+
+bool LazyInit::isDone() const
+{
+    return state->done;
+}
+
+void LazyInit::runPendingInits()
+{
+    juce::MessageManager::callAsync(&LazyInit::runNextPendingInit);
+}
+
+void LazyInit::runNextPendingInit()
+{
+    // the registry is not locked while running, as initializations can take long and other
+    // threads may create or destroy lazy initializations meanwhile
+    std::shared_ptr<State> next = findPendingInit();
+    if (next != nullptr)
+    {
+        ensure(*next);
+    }
+
+    if (findPendingInit() != nullptr)
+    {
+        juce::MessageManager::callAsync(&LazyInit::runNextPendingInit);
+    }
+    else
+    {
+        juce::SharedResourcePointer<StartupTracer> tracer;
+        tracer->markStartupDone();
+    }
+}
+
+std::shared_ptr<LazyInit::State> LazyInit::findPendingInit()
+{
+    std::scoped_lock<std::mutex> lock(getRegistryMutex());
+    std::vector<std::shared_ptr<State>> &registry = getRegistry();
+    auto next = std::find_if(registry.begin(), registry.end(),
+                             [](const std::shared_ptr<State> &s) { return !s->done; });
+    return next != registry.end() ? *next : nullptr;
+}
+
+std::mutex &LazyInit::getRegistryMutex()
+{
+    static std::mutex registryMutex;
+    return registryMutex;
+}
+
+std::vector<std::shared_ptr<LazyInit::State>> &LazyInit::getRegistry()
+{
+    static std::vector<std::shared_ptr<State>> registry;
+    return registry;
+}
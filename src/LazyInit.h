@@ -0,0 +1,78 @@
+#ifndef DEF_LAZY_INIT_HPP
+#define DEF_LAZY_INIT_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The initialization of a subsystem that is not needed to show the first frame.
+ *        It runs the first time ensure() is called, or once the window is shown when
+ *        runPendingInits() is called, whichever comes first. Each initialization is recorded
+ *        as a startup phase by the StartupTracer.
+ *        ensure() can be called from any thread, and waits if another thread is running
+ *        the initialization. The initializations run by runPendingInits() are run on the
+ *        message thread, one per message loop iteration so that the UI stays responsive.
+ *        Once none is left, the StartupTracer is told that the startup is over.
+ *        Destroying it waits for its initialization if it's running, and prevents it
+ *        from running after.
+ */
+class LazyInit
+{
+  public:
+    /**
+     * @brief Registers an initialization to run later.
+     *
+     * @param name  The name of the startup phase of the initialization
+     * @param init  The initialization, that must not call runPendingInits()
+     */
+    LazyInit(std::string name, std::function<void()> init);
+    ~LazyInit();
+
+    /**
+     * @brief Runs the initialization if it did not run yet.
+     */
+    void ensure();
+    bool isDone() const;
+
+    /**
+     * @brief Runs the registered initializations that did not run yet on the message thread.
+     *        Can be called from any thread.
+     */
+    static void runPendingInits();
+
+  private:
+    /**
+     * @brief The initialization itself, shared with the registry so that the message thread can
+     *        run it without keeping the registry locked.
+     */
+    struct State
+    {
+        std::string name;
+        std::function<void()> init;
+        std::once_flag initOnce;
+        std::atomic<bool> done;
+    };
+
+    static void ensure(State &state);
+
+    /**
+     * @brief Runs the first pending initialization and posts a message for the next one.
+     */
+    static void runNextPendingInit();
+
+    /**
+     * @brief Gets the first registered initialization that did not run yet, or nullptr.
+     */
+    static std::shared_ptr<State> findPendingInit();
+
+    static std::mutex &getRegistryMutex();
+    static std::vector<std::shared_ptr<State>> &getRegistry();
+
+    std::shared_ptr<State> state;
+};
+
+#endif // DEF_LAZY_INIT_HPP
@@ -1,5 +1,6 @@
 #include "Config.h"
 #include "DefaultConfigPath.h"
+#include "StartupTracer.h"
 #include "UserInterface/MainComponent.h"
 
 //==============================================================================
@@ -38,9 +39,16 @@ class GuiAppApplication : public juce::JUCEApplication
         std::string configpath = parseConfigPath(commandLine);
         std::cerr << "Config file location used: " << configpath << std::endl;
 
-        mainWindow.reset(new MainWindow(getApplicationName()));
+        {
+            StartupPhase phase("main window creation");
+            mainWindow.reset(new MainWindow(getApplicationName()));
+        }
 
-        Config kholorsConfig(configpath);
+        Config kholorsConfig;
+        {
+            StartupPhase phase("config parsing");
+            kholorsConfig = Config(configpath);
+        }
         mainWindow->getMainComponent()->configureApp(kholorsConfig);
 
         if (kholorsConfig.isInvalid())
@@ -130,6 +138,8 @@ class GuiAppApplication : public juce::JUCEApplication
     };
 
   private:
+    // created first so that the startup phases are timed from the app creation
+    juce::SharedResourcePointer<StartupTracer> startupTracer;
     std::unique_ptr<MainWindow> mainWindow;
 };
 
@@ -0,0 +1,87 @@
+#ifndef COLORMAP_TEXTURE_LOADER_HPP
+#define COLORMAP_TEXTURE_LOADER_HPP
+
+#include "../Config.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <juce_opengl/juce_opengl.h>
+
+using namespace juce::gl;
+
+/**< Number of colors of the colormap lookup texture */
+#define COLORMAP_TEXTURE_WIDTH 256
+
+/**
+ Class responsible for loading the colormap lookup texture the fragment
+ shader uses to color the spectrograms when colormaps are enabled.
+ The texture is a single row going from silent to loud intensities.
+ */
+class ColormapTextureLoader
+{
+  public:
+    ColormapTextureLoader() : tbo(0){};
+    ~ColormapTextureLoader(){};
+    void loadTexture()
+    {
+        loadHeatColormap();
+        createOpenGlTexture();
+    };
+
+    void bindTexture()
+    {
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, tbo);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+  private:
+    std::vector<float> textureData;
+    GLuint tbo;
+
+    void loadHeatColormap()
+    {
+        // black, purple, red, orange, yellow and white, evenly spaced
+        const float controlPoints[][3] = {{0.0f, 0.0f, 0.0f}, {0.35f, 0.05f, 0.5f}, {0.8f, 0.1f, 0.3f},
+                                          {1.0f, 0.5f, 0.0f}, {1.0f, 0.9f, 0.2f},   {1.0f, 1.0f, 1.0f}};
+        const int numSegments = 5;
+
+        textureData.resize(COLORMAP_TEXTURE_WIDTH * 4);
+
+        for (int i = 0; i < COLORMAP_TEXTURE_WIDTH; i++)
+        {
+            float position = float(i * numSegments) / float(COLORMAP_TEXTURE_WIDTH - 1);
+            int segment = juce::jmin(int(position), numSegments - 1);
+            float ratio = position - float(segment);
+
+            int texturePos = i * 4;
+            for (int c = 0; c < 3; c++)
+            {
+                textureData[(size_t)(texturePos + c)] =
+                    controlPoints[segment][c] + ratio * (controlPoints[segment + 1][c] - controlPoints[segment][c]);
+            }
+            textureData[(size_t)(texturePos + 3)] = 1.0f;
+        }
+    }
+
+    void createOpenGlTexture()
+    {
+        // register the texture
+        glGenTextures(1, &tbo);
+        glBindTexture(GL_TEXTURE_2D, tbo);
+        // set the texture wrapping
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        // set the filtering parameters
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // send the texture to the gpu
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, COLORMAP_TEXTURE_WIDTH, 1, 0, GL_RGBA, GL_FLOAT, textureData.data());
+
+        GLenum err;
+        while ((err = glGetError()) != GL_NO_ERROR)
+        {
+            std::cerr << "got following open gl error after uploading colormap texture data: " << err << std::endl;
+        }
+    }
+};
+
+#endif // COLORMAP_TEXTURE_LOADER_HPP
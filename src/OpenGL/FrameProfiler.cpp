@@ -0,0 +1,268 @@
+#include "FrameProfiler.h"
+
+#include <iostream>
+
+using namespace juce::gl;
+
+FrameProfiler::FrameProfiler()
+    : enabled(false), glObjectsCreated(false), currentFrame(0), currentPass(-1), measuringFrame(false),
+      framesCount(0), nextRecordedFrame(0)
+{
+    for (int i = 0; i < FRAME_PROFILER_QUERY_FRAMES; i++)
+    {
+        pendingFrames[i].pending = false;
+        for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+        {
+            queries[i][pass] = 0;
+        }
+    }
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    stopCsv();
+}
+
+void FrameProfiler::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
+bool FrameProfiler::isEnabled() const
+{
+    return enabled;
+}
+
+void FrameProfiler::beginFrame()
+{
+    currentPass = -1;
+    measuringFrame = false;
+
+    if (!enabled)
+    {
+        // frames measured before being disabled are dropped
+        for (int i = 0; i < FRAME_PROFILER_QUERY_FRAMES; i++)
+        {
+            pendingFrames[i].pending = false;
+        }
+        return;
+    }
+
+    if (!glObjectsCreated)
+    {
+        glGenQueries(FRAME_PROFILER_QUERY_FRAMES * FRAME_PASSES_COUNT, &queries[0][0]);
+        glObjectsCreated = true;
+    }
+
+    // record the frames the GPU finished, oldest first. The oldest one is the one whose queries
+    // are about to be reused, so it is waited for if the GPU is that late.
+    for (int i = 1; i <= FRAME_PROFILER_QUERY_FRAMES; i++)
+    {
+        int slot = (currentFrame + i) % FRAME_PROFILER_QUERY_FRAMES;
+        if (pendingFrames[slot].pending && !resolveFrame(slot, i == 1))
+        {
+            break;
+        }
+    }
+
+    currentFrame = (currentFrame + 1) % FRAME_PROFILER_QUERY_FRAMES;
+    for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+    {
+        pendingFrames[currentFrame].passQueried[pass] = false;
+    }
+    measuringFrame = true;
+}
+
+void FrameProfiler::beginPass(FrameProfilerPass pass)
+{
+    if (!enabled || !measuringFrame || currentPass >= 0)
+    {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[currentFrame][pass]);
+    pendingFrames[currentFrame].passQueried[pass] = true;
+    currentPass = pass;
+}
+
+void FrameProfiler::endPass()
+{
+    if (currentPass < 0)
+    {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    currentPass = -1;
+}
+
+void FrameProfiler::endFrame(double cpuMs, int drawCalls, size_t residentTextureBytes, size_t uploadedBytes)
+{
+    if (!enabled || !measuringFrame)
+    {
+        return;
+    }
+    measuringFrame = false;
+
+    PendingFrame &pendingFrame = pendingFrames[currentFrame];
+    pendingFrame.profile.frame = framesCount++;
+    pendingFrame.profile.cpuMs = cpuMs;
+    pendingFrame.profile.drawCalls = drawCalls;
+    pendingFrame.profile.residentTextureBytes = residentTextureBytes;
+    pendingFrame.profile.uploadedBytes = uploadedBytes;
+    pendingFrame.pending = true;
+}
+
+bool FrameProfiler::resolveFrame(int slot, bool wait)
+{
+    PendingFrame &pendingFrame = pendingFrames[slot];
+    if (!wait)
+    {
+        for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+        {
+            if (!pendingFrame.passQueried[pass])
+            {
+                continue;
+            }
+            GLuint available = 0;
+            glGetQueryObjectuiv(queries[slot][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+    {
+        pendingFrame.profile.gpuMs[pass] = 0.0;
+        if (pendingFrame.passQueried[pass])
+        {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(queries[slot][pass], GL_QUERY_RESULT, &elapsedNs);
+            pendingFrame.profile.gpuMs[pass] = double(elapsedNs) / 1000000.0;
+        }
+    }
+
+    pendingFrame.pending = false;
+    recordFrame(pendingFrame.profile);
+    return true;
+}
+
+void FrameProfiler::recordFrame(const FrameProfile &profile)
+{
+    const juce::ScopedLock lock(recordMutex);
+
+    if (recordedFrames.size() < FRAME_PROFILER_AVERAGED_FRAMES)
+    {
+        recordedFrames.push_back(profile);
+    }
+    else
+    {
+        recordedFrames[nextRecordedFrame] = profile;
+    }
+    nextRecordedFrame = (nextRecordedFrame + 1) % FRAME_PROFILER_AVERAGED_FRAMES;
+
+    if (csvStream != nullptr)
+    {
+        *csvStream << juce::String(profile.frame) << "," << juce::String(profile.cpuMs, 3);
+        for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+        {
+            *csvStream << "," << juce::String(profile.gpuMs[pass], 3);
+        }
+        *csvStream << "," << profile.drawCalls << "," << juce::String(profile.residentTextureBytes) << ","
+                   << juce::String(profile.uploadedBytes) << "\n";
+    }
+}
+
+FrameProfile FrameProfiler::getAverageProfile() const
+{
+    const juce::ScopedLock lock(recordMutex);
+
+    FrameProfile average = {0, 0.0, {0.0, 0.0, 0.0}, 0, 0, 0};
+    if (recordedFrames.empty())
+    {
+        return average;
+    }
+
+    double drawCalls = 0.0;
+    double residentTextureBytes = 0.0;
+    double uploadedBytes = 0.0;
+    for (const FrameProfile &profile : recordedFrames)
+    {
+        average.frame = juce::jmax(average.frame, profile.frame);
+        average.cpuMs += profile.cpuMs;
+        for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+        {
+            average.gpuMs[pass] += profile.gpuMs[pass];
+        }
+        drawCalls += profile.drawCalls;
+        residentTextureBytes += double(profile.residentTextureBytes);
+        uploadedBytes += double(profile.uploadedBytes);
+    }
+
+    double count = double(recordedFrames.size());
+    average.cpuMs /= count;
+    for (int pass = 0; pass < FRAME_PASSES_COUNT; pass++)
+    {
+        average.gpuMs[pass] /= count;
+    }
+    average.drawCalls = juce::roundToInt(drawCalls / count);
+    average.residentTextureBytes = (size_t)(residentTextureBytes / count);
+    average.uploadedBytes = (size_t)(uploadedBytes / count);
+    return average;
+}
+
+bool FrameProfiler::startCsv(const juce::File &file)
+{
+    const juce::ScopedLock lock(recordMutex);
+
+    file.getParentDirectory().createDirectory();
+    std::unique_ptr<juce::FileOutputStream> stream = std::make_unique<juce::FileOutputStream>(file);
+    if (stream->failedToOpen())
+    {
+        std::cerr << "Unable to open the frame profile file " << file.getFullPathName() << ": "
+                  << stream->getStatus().getErrorMessage() << std::endl;
+        return false;
+    }
+
+    stream->setPosition(0);
+    stream->truncate();
+    *stream << "frame,cpu_ms,gpu_grid_ms,gpu_samples_ms,gpu_overlays_ms,draw_calls,resident_texture_bytes,"
+               "uploaded_bytes\n";
+    csvStream = std::move(stream);
+    std::cout << "Writing frame profiles to " << file.getFullPathName() << std::endl;
+    return true;
+}
+
+void FrameProfiler::stopCsv()
+{
+    const juce::ScopedLock lock(recordMutex);
+
+    if (csvStream != nullptr)
+    {
+        csvStream->flush();
+        csvStream.reset();
+    }
+}
+
+bool FrameProfiler::isWritingCsv() const
+{
+    const juce::ScopedLock lock(recordMutex);
+    return csvStream != nullptr;
+}
+
+void FrameProfiler::releaseGlObjects()
+{
+    if (glObjectsCreated)
+    {
+        glDeleteQueries(FRAME_PROFILER_QUERY_FRAMES * FRAME_PASSES_COUNT, &queries[0][0]);
+        glObjectsCreated = false;
+    }
+    for (int i = 0; i < FRAME_PROFILER_QUERY_FRAMES; i++)
+    {
+        pendingFrames[i].pending = false;
+    }
+    currentPass = -1;
+    measuringFrame = false;
+}
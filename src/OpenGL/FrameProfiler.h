@@ -0,0 +1,145 @@
+#ifndef DEF_FRAME_PROFILER_HPP
+#define DEF_FRAME_PROFILER_HPP
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <atomic>
+#include <cstdint>
+#include <juce_opengl/juce_opengl.h>
+#include <memory>
+#include <vector>
+
+/**< Number of frames whose GPU timings can be in flight before their queries are reused */
+#define FRAME_PROFILER_QUERY_FRAMES 4
+/**< Number of frames the displayed timings are averaged over */
+#define FRAME_PROFILER_AVERAGED_FRAMES 60
+
+// the render passes timed on the GPU
+enum FrameProfilerPass
+{
+    FRAME_PASS_GRID,
+    FRAME_PASS_SAMPLES,
+    FRAME_PASS_OVERLAYS,
+    FRAME_PASSES_COUNT
+};
+
+// what a frame cost
+struct FrameProfile
+{
+    uint64_t frame;
+    // time spent submitting the frame on the OpenGL thread
+    double cpuMs;
+    // GPU time of each pass, zero for the passes the frame skipped
+    double gpuMs[FRAME_PASSES_COUNT];
+    int drawCalls;
+    size_t residentTextureBytes;
+    size_t uploadedBytes;
+};
+
+/**
+ * @brief      Measures the cost of the frames of an OpenGL renderer: the CPU time and counters
+ *             it reports, and the GPU time of each pass with GL_TIME_ELAPSED queries.
+ *             Query results are read a few frames later so that the CPU never waits for the GPU,
+ *             so a frame is only recorded once the GPU finished it.
+ *             Recorded frames are averaged for display and can be written to a CSV file.
+ *             beginFrame, beginPass, endPass, endFrame and releaseGlObjects must be called from
+ *             the OpenGL thread, the other functions can be called from any thread.
+ */
+class FrameProfiler
+{
+  public:
+    FrameProfiler();
+    ~FrameProfiler();
+
+    /**
+     * @brief      Starts or stops measuring frames. Nothing is measured by default.
+     */
+    void setEnabled(bool enable);
+    bool isEnabled() const;
+
+    /**
+     * @brief      Starts measuring a frame, and records the previous ones the GPU finished.
+     */
+    void beginFrame();
+
+    /**
+     * @brief      Starts timing a pass on the GPU. Passes can't be nested.
+     */
+    void beginPass(FrameProfilerPass pass);
+
+    /**
+     * @brief      Stops timing the current pass.
+     */
+    void endPass();
+
+    /**
+     * @brief      Ends the frame started with beginFrame.
+     *
+     * @param[in]  cpuMs                 The time spent submitting the frame
+     * @param[in]  drawCalls             The number of draw calls of the frame
+     * @param[in]  residentTextureBytes  The GPU memory used by textures
+     * @param[in]  uploadedBytes         The bytes sent to the GPU during the frame
+     */
+    void endFrame(double cpuMs, int drawCalls, size_t residentTextureBytes, size_t uploadedBytes);
+
+    /**
+     * @brief      Gets the average of the last recorded frames.
+     *
+     * @return     The average profile, whose frame field is the last recorded frame.
+     */
+    FrameProfile getAverageProfile() const;
+
+    /**
+     * @brief      Starts writing a line per recorded frame to a CSV file, which is replaced if it exists.
+     *
+     * @return     false if the file could not be opened.
+     */
+    bool startCsv(const juce::File &file);
+
+    /**
+     * @brief      Stops writing to the CSV file and closes it.
+     */
+    void stopCsv();
+    bool isWritingCsv() const;
+
+    /**
+     * @brief      Deletes the queries. To be called before the OpenGL context goes away.
+     */
+    void releaseGlObjects();
+
+  private:
+    struct PendingFrame
+    {
+        FrameProfile profile;
+        bool passQueried[FRAME_PASSES_COUNT];
+        bool pending;
+    };
+
+    /**
+     * @brief      Reads the query results of a pending frame and records it.
+     *
+     * @param[in]  slot  The index of the pending frame
+     * @param[in]  wait  If true, waits for the GPU to finish the frame, otherwise
+     *                   returns false if it didn't yet.
+     */
+    bool resolveFrame(int slot, bool wait);
+    void recordFrame(const FrameProfile &profile);
+
+    std::atomic<bool> enabled;
+
+    GLuint queries[FRAME_PROFILER_QUERY_FRAMES][FRAME_PASSES_COUNT];
+    bool glObjectsCreated;
+    PendingFrame pendingFrames[FRAME_PROFILER_QUERY_FRAMES];
+    int currentFrame;
+    int currentPass;
+    // true between the beginFrame and endFrame of a measured frame
+    bool measuringFrame;
+    uint64_t framesCount;
+
+    // last recorded frames, used as a ring
+    std::vector<FrameProfile> recordedFrames;
+    size_t nextRecordedFrame;
+    std::unique_ptr<juce::FileOutputStream> csvStream;
+    juce::CriticalSection recordMutex;
+};
+
+#endif // DEF_FRAME_PROFILER_HPP
@@ -12,13 +12,20 @@ layout (location = 2) in vec2 aTexCoord;
 
 out vec4 ourColor;
 out vec2 TexCoord;
+flat out int meshIndex;
 
 uniform float viewPosition;
 uniform float viewWidth;
+uniform int verticesPerMesh;
+// the last component of each mesh data is its horizontal offset, set while dragging it
+uniform samplerBuffer meshData;
 
 void main()
 {
-    gl_Position = vec4( (2.0*((aPos.x-viewPosition)/viewWidth))-1.0, aPos.y, aPos.z, aPos.w);
+    // all the samples meshes share the same vertex buffer, in slots of the same size
+    meshIndex = gl_VertexID / verticesPerMesh;
+    float x = aPos.x + texelFetch(meshData, meshIndex).a;
+    gl_Position = vec4( (2.0*((x-viewPosition)/viewWidth))-1.0, aPos.y, aPos.z, aPos.w);
     ourColor = aColor;
     TexCoord = aTexCoord;
 }
@@ -31,17 +38,90 @@ out vec4 FragColor;
   
 in vec4 ourColor;
 in vec2 TexCoord;
+flat in int meshIndex;
 
-uniform sampler2D ourTexture;
+uniform sampler2DArray ourTexture;
 uniform sampler2D alphaMask;
+// number of ffts, page table offset and page table width of each mesh
+uniform samplerBuffer meshData;
+uniform samplerBuffer pageTables;
+uniform vec2 tileSize;
+uniform float spectrogramRows;
+// knee of the frequency lens, as an (output, input) position ratio
+uniform vec2 lensKnee;
+// decibels displayed as fully transparent and fully opaque
+uniform vec2 dbRange;
+uniform bool useColormap;
+uniform sampler2D colormap;
+
+// part of a texel width over which neighbouring ffts are blended
+const float fftBlendWidth = 0.33;
+
+// the polynomial lens that zooms in the frequencies, as UnitConverter::magnifyTextureFrequencyIndex
+float magnifyFrequencyIndex(float k, float scopeSize)
+{
+    float v = 1.0 - (k / (scopeSize - 1.0));
+    float zoomed = v < lensKnee.x ? v * (lensKnee.y / lensKnee.x)
+                                  : lensKnee.y + ((v - lensKnee.x) * ((1.0 - lensKnee.y) / (1.0 - lensKnee.x)));
+    return clamp((1.0 - zoomed) * (scopeSize - 1.0), 0.0, scopeSize - 1.0);
+}
+
+// row of the tiles, where each channel has its frequencies in storage order, for a displayed row
+float storageRow(float displayedRow)
+{
+    float scopeSize = spectrogramRows * 0.5;
+    float k = displayedRow - 0.5;
+    if (k < scopeSize)
+    {
+        // lower frequencies are at the bottom of the first channel
+        return scopeSize - magnifyFrequencyIndex(k, scopeSize) - 0.5;
+    }
+    // and at the top of the second channel
+    k = scopeSize - 1.0 - (k - scopeSize);
+    return spectrogramRows - magnifyFrequencyIndex(k, scopeSize) - 0.5;
+}
+
+float spectrogramIntensity()
+{
+    // find the page table entry of the level 0 tile below this fragment
+    vec4 mesh = texelFetch(meshData, meshIndex);
+    ivec2 pageTableSize = ivec2(int(mesh.b), int(spectrogramRows / tileSize.y));
+    vec2 texel = vec2(TexCoord.x * mesh.r, storageRow(TexCoord.y * spectrogramRows));
+    ivec2 page = clamp(ivec2(floor(texel / tileSize)), ivec2(0), pageTableSize - 1);
+    vec4 entry = texelFetch(pageTables, int(mesh.g) + (page.y * pageTableSize.x) + page.x);
+    if (entry.r < 0.0)
+    {
+        return 0.0;
+    }
+
+    // position in the resident tile, whose ffts are decimated by its level
+    int level = int(entry.a + 0.5);
+    vec2 tileTexel = vec2(texel.x / exp2(float(level)) - float(page.x >> level) * tileSize.x,
+                          texel.y - float(page.y) * tileSize.y);
+
+    // we have way less ffts than frequencies, so a plain linear filtering
+    // leaks each fft over its neighbours. Only blend around the texel edges
+    // and move the horizontal coordinate to the texel center elsewhere.
+    float fftPosition = tileTexel.x - 0.5;
+    float fftBlend = clamp((fract(fftPosition) - 0.5) / fftBlendWidth + 0.5, 0.0, 1.0);
+    tileTexel.x = floor(fftPosition) + 0.5 + fftBlend;
+
+    // stay inside the tile so that linear filtering never reads its atlas neighbours
+    tileTexel = clamp(tileTexel, vec2(0.5), tileSize - 0.5);
+    vec2 atlasTexel = entry.gb * tileSize + tileTexel;
+    vec2 atlasSize = vec2(textureSize(ourTexture, 0).xy);
+    float db = texture(ourTexture, vec3(atlasTexel / atlasSize, entry.r)).r;
+    return clamp((db - dbRange.x) / (dbRange.y - dbRange.x), 0.0, 1.0);
+}
 
 void main()
 {
     vec4 alphaMask = texture(alphaMask, TexCoord);
-    vec4 sampleWaveform = texture(ourTexture, TexCoord);
-    float alphaLevel = min(alphaMask.r, sampleWaveform.a);
+    float sampleIntensity = spectrogramIntensity();
+    float alphaLevel = min(alphaMask.r, sampleIntensity);
     alphaLevel = ourColor.a * alphaLevel;
-    FragColor = vec4(ourColor.x, ourColor.y, ourColor.z, alphaLevel);
+    vec3 color = useColormap ? texture(colormap, vec2(sampleIntensity, 0.5)).rgb : ourColor.rgb;
+    FragColor = vec4(color, alphaLevel);
 }
 )";
 
@@ -101,4 +181,66 @@ void main()
 }
 )";
 
+std::string labelVertexShader =
+    R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in vec2 aBoxPos;
+layout (location = 4) in vec4 aBoxShape;
+
+out vec4 ourColor;
+out vec2 TexCoord;
+out vec2 boxPosition;
+out vec4 boxShape;
+
+// size of the view in the pixels the labels are positioned in
+uniform vec2 viewSize;
+
+void main()
+{
+    gl_Position = vec4((2.0 * aPos.x / viewSize.x) - 1.0, 1.0 - (2.0 * aPos.y / viewSize.y), 0.0, 1.0);
+    ourColor = aColor;
+    TexCoord = aTexCoord;
+    boxPosition = aBoxPos;
+    boxShape = aBoxShape;
+}
+)";
+
+std::string labelFragmentShader =
+    R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec4 ourColor;
+in vec2 TexCoord;
+in vec2 boxPosition;
+// half width, half height, corner radius and border thickness, or zeros for glyphs
+in vec4 boxShape;
+
+uniform sampler2D glyphAtlas;
+
+void main()
+{
+    // glyphs take their coverage from the atlas
+    if (boxShape.x <= 0.0)
+    {
+        FragColor = vec4(ourColor.rgb, ourColor.a * texture(glyphAtlas, TexCoord).r);
+        return;
+    }
+
+    // signed distance to the rounded box outline, negative inside
+    vec2 q = abs(boxPosition) - boxShape.xy + boxShape.z;
+    float distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - boxShape.z;
+    float coverage = clamp(0.5 - distance, 0.0, 1.0);
+    // borders only keep the inner ring of the box
+    if (boxShape.w > 0.0)
+    {
+        coverage *= clamp(0.5 + distance + boxShape.w, 0.0, 1.0);
+    }
+    FragColor = vec4(ourColor.rgb, ourColor.a * coverage);
+}
+)";
+
 #endif // DEF_FREQVIEW_SHADERS_HPP
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "LabelBatch.h"
+
+#include "../UserInterface/FontsLoader.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+using namespace juce::gl;
+
+// each quad is drawn as two triangles
+#define LABEL_VERTICES_PER_QUAD 6
+
+LabelBatch::LabelBatch()
+    : vao(0), vbo(0), glyphAtlasTexture(0), glObjectsCreated(false), glyphAtlasChanged(false), glyphAtlasWidth(0),
+      glyphAtlasHeight(0), numGlyphs(0), glyphCellWidth(0), glyphCellHeight(0), glyphAdvance(0.0f),
+      submittedChanged(false), submittedGlyphAtlasChanged(false), gpuVertices(0), gpuCapacity(0), lastDrawCalls(0),
+      uploadedBytes(0)
+{
+    rasterizeGlyphs();
+    submittedGlyphAtlas = glyphAtlas;
+}
+
+void LabelBatch::rasterizeGlyphs()
+{
+    juce::SharedResourcePointer<FontsLoader> sharedFonts;
+    glyphFont = sharedFonts->monospaceFont.withHeight(LABEL_GLYPHS_FONT_HEIGHT * LABEL_GLYPHS_OVERSAMPLING);
+
+    // one pixel of padding around each glyph so that linear filtering never reads the neighbour glyphs
+    float advance = glyphFont.getStringWidthFloat("M");
+    glyphAdvance = advance / LABEL_GLYPHS_OVERSAMPLING;
+    glyphCellWidth = int(std::ceil(advance)) + 2;
+    glyphCellHeight = int(std::ceil(glyphFont.getHeight())) + 2;
+
+    // the atlas size is fixed so that the texture coordinates of the built labels stay valid
+    glyphAtlasWidth = LABEL_GLYPHS_ATLAS_COLUMNS * glyphCellWidth;
+    glyphAtlasHeight = LABEL_GLYPHS_ATLAS_ROWS * glyphCellHeight;
+    glyphAtlas.assign((size_t)(glyphAtlasWidth * glyphAtlasHeight), 0);
+
+    numGlyphs = LABEL_GLYPHS_LAST_CHAR - LABEL_GLYPHS_FIRST_CHAR + 1;
+    for (int i = 0; i < numGlyphs; i++)
+    {
+        rasterizeGlyph(juce::juce_wchar(LABEL_GLYPHS_FIRST_CHAR + i), i);
+    }
+}
+
+void LabelBatch::rasterizeGlyph(juce::juce_wchar character, int cell)
+{
+    // glyphs wider than the cell are cut rather than drawn over the neighbour ones
+    juce::Image image(juce::Image::SingleChannel, glyphCellWidth, glyphCellHeight, true);
+    {
+        juce::Graphics g(image);
+        g.setFont(glyphFont);
+        g.setColour(juce::Colours::white);
+        g.drawSingleLineText(juce::String::charToString(character), 1, 1 + juce::roundToInt(glyphFont.getAscent()));
+    }
+
+    int cellX = (cell % LABEL_GLYPHS_ATLAS_COLUMNS) * glyphCellWidth;
+    int cellY = (cell / LABEL_GLYPHS_ATLAS_COLUMNS) * glyphCellHeight;
+    juce::Image::BitmapData pixels(image, juce::Image::BitmapData::readOnly);
+    for (int y = 0; y < glyphCellHeight; y++)
+    {
+        for (int x = 0; x < glyphCellWidth; x++)
+        {
+            glyphAtlas[(size_t)(((cellY + y) * glyphAtlasWidth) + cellX + x)] = *pixels.getPixelPointer(x, y);
+        }
+    }
+    glyphAtlasChanged = true;
+}
+
+int LabelBatch::findGlyph(juce::juce_wchar character)
+{
+    if (character >= LABEL_GLYPHS_FIRST_CHAR && character <= LABEL_GLYPHS_LAST_CHAR)
+    {
+        return int(character) - LABEL_GLYPHS_FIRST_CHAR;
+    }
+
+    if (character > LABEL_GLYPHS_LAST_CHAR)
+    {
+        auto existing = extraGlyphs.find(character);
+        if (existing != extraGlyphs.end())
+        {
+            return existing->second;
+        }
+
+        if (numGlyphs < LABEL_GLYPHS_ATLAS_COLUMNS * LABEL_GLYPHS_ATLAS_ROWS)
+        {
+            int cell = numGlyphs++;
+            rasterizeGlyph(character, cell);
+            extraGlyphs[character] = cell;
+            return cell;
+        }
+    }
+
+    return int('?') - LABEL_GLYPHS_FIRST_CHAR;
+}
+
+float LabelBatch::getTextWidth(const juce::String &text) const
+{
+    return float(text.length()) * glyphAdvance;
+}
+
+void LabelBatch::clear()
+{
+    builtVertices.clear();
+
+    // the cells are rasterized again when the new labels use them
+    if (numGlyphs == LABEL_GLYPHS_ATLAS_COLUMNS * LABEL_GLYPHS_ATLAS_ROWS)
+    {
+        extraGlyphs.clear();
+        numGlyphs = LABEL_GLYPHS_LAST_CHAR - LABEL_GLYPHS_FIRST_CHAR + 1;
+    }
+}
+
+void LabelBatch::addQuad(juce::Rectangle<float> quad, juce::Rectangle<float> textureQuad, juce::Colour colour,
+                         const float (&boxShape)[4])
+{
+    const float corners[LABEL_VERTICES_PER_QUAD][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 0}, {1, 1}, {0, 1}};
+    for (int i = 0; i < LABEL_VERTICES_PER_QUAD; i++)
+    {
+        float x = corners[i][0];
+        float y = corners[i][1];
+        builtVertices.push_back(
+            {{quad.getX() + x * quad.getWidth(), quad.getY() + y * quad.getHeight()},
+             {textureQuad.getX() + x * textureQuad.getWidth(), textureQuad.getY() + y * textureQuad.getHeight()},
+             {colour.getFloatRed(), colour.getFloatGreen(), colour.getFloatBlue(), colour.getFloatAlpha()},
+             {(x - 0.5f) * quad.getWidth(), (y - 0.5f) * quad.getHeight()},
+             {boxShape[0], boxShape[1], boxShape[2], boxShape[3]}});
+    }
+}
+
+void LabelBatch::addBox(juce::Rectangle<float> box, juce::Colour colour, float cornerRadius)
+{
+    const float boxShape[4] = {box.getWidth() / 2.0f, box.getHeight() / 2.0f, cornerRadius, 0.0f};
+    addQuad(box, {}, colour, boxShape);
+}
+
+void LabelBatch::addBorder(juce::Rectangle<float> box, juce::Colour colour, float cornerRadius, float thickness)
+{
+    const float boxShape[4] = {box.getWidth() / 2.0f, box.getHeight() / 2.0f, cornerRadius, thickness};
+    addQuad(box, {}, colour, boxShape);
+}
+
+void LabelBatch::addText(const juce::String &text, juce::Rectangle<float> box, juce::Colour colour)
+{
+    int maxGlyphs = int(box.getWidth() / glyphAdvance);
+    if (maxGlyphs <= 0)
+    {
+        return;
+    }
+
+    juce::String displayedText = text;
+    if (displayedText.length() > maxGlyphs)
+    {
+        displayedText = maxGlyphs > 3 ? text.substring(0, maxGlyphs - 3) + "..." : text.substring(0, maxGlyphs);
+    }
+
+    const float noBox[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float cellWidth = float(glyphCellWidth) / LABEL_GLYPHS_OVERSAMPLING;
+    float cellHeight = float(glyphCellHeight) / LABEL_GLYPHS_OVERSAMPLING;
+    float padding = 1.0f / LABEL_GLYPHS_OVERSAMPLING;
+    float top = box.getCentreY() - (LABEL_GLYPHS_FONT_HEIGHT / 2.0f) - padding;
+
+    for (int i = 0; i < displayedText.length(); i++)
+    {
+        juce::juce_wchar character = displayedText[i];
+        if (character == ' ')
+        {
+            continue;
+        }
+
+        int glyph = findGlyph(character);
+        juce::Rectangle<float> textureQuad(
+            float((glyph % LABEL_GLYPHS_ATLAS_COLUMNS) * glyphCellWidth) / float(glyphAtlasWidth),
+            float((glyph / LABEL_GLYPHS_ATLAS_COLUMNS) * glyphCellHeight) / float(glyphAtlasHeight),
+            float(glyphCellWidth) / float(glyphAtlasWidth), float(glyphCellHeight) / float(glyphAtlasHeight));
+        juce::Rectangle<float> quad(box.getX() + (float(i) * glyphAdvance) - padding, top, cellWidth, cellHeight);
+        addQuad(quad, textureQuad, colour, noBox);
+    }
+}
+
+bool LabelBatch::submit()
+{
+    const juce::ScopedLock lock(verticesMutex);
+
+    bool changed = builtVertices.size() != submittedVertices.size() ||
+                   (!builtVertices.empty() && std::memcmp(builtVertices.data(), submittedVertices.data(),
+                                                          builtVertices.size() * sizeof(LabelVertex)) != 0);
+
+    // the atlas is handed over along with the labels using its new glyphs
+    if (glyphAtlasChanged)
+    {
+        submittedGlyphAtlas = glyphAtlas;
+        submittedGlyphAtlasChanged = true;
+        glyphAtlasChanged = false;
+        changed = true;
+    }
+
+    if (changed)
+    {
+        submittedVertices = builtVertices;
+        submittedChanged = true;
+    }
+    return changed;
+}
+
+void LabelBatch::uploadChanges()
+{
+    if (!glObjectsCreated)
+    {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+        GLsizei stride = sizeof(LabelVertex);
+        // position
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(LabelVertex, position));
+        glEnableVertexAttribArray(0);
+        // texture
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(LabelVertex, texturePosition));
+        glEnableVertexAttribArray(1);
+        // color
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(LabelVertex, colour));
+        glEnableVertexAttribArray(2);
+        // position in the box
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(LabelVertex, boxPosition));
+        glEnableVertexAttribArray(3);
+        // shape of the box
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(LabelVertex, boxShape));
+        glEnableVertexAttribArray(4);
+
+        // the glyph atlas is a single channel of coverage
+        glGenTextures(1, &glyphAtlasTexture);
+        glBindTexture(GL_TEXTURE_2D, glyphAtlasTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, glyphAtlasWidth, glyphAtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     submittedGlyphAtlas.data());
+        uploadedBytes += submittedGlyphAtlas.size();
+        submittedGlyphAtlasChanged = false;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glObjectsCreated = true;
+    }
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (submittedChanged)
+    {
+        // the labels are few, so they are sent again as a whole when any of them changed
+        gpuVertices = submittedVertices.size();
+        if (gpuVertices > gpuCapacity)
+        {
+            gpuCapacity = juce::jmax(gpuVertices, gpuCapacity * 2);
+            glBufferData(GL_ARRAY_BUFFER, (long)(sizeof(LabelVertex) * gpuCapacity), nullptr, GL_DYNAMIC_DRAW);
+        }
+        if (gpuVertices > 0)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, (long)(sizeof(LabelVertex) * gpuVertices), submittedVertices.data());
+            uploadedBytes += sizeof(LabelVertex) * gpuVertices;
+        }
+        submittedChanged = false;
+
+        if (submittedGlyphAtlasChanged)
+        {
+            glBindTexture(GL_TEXTURE_2D, glyphAtlasTexture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, glyphAtlasWidth, glyphAtlasHeight, GL_RED, GL_UNSIGNED_BYTE,
+                            submittedGlyphAtlas.data());
+            uploadedBytes += submittedGlyphAtlas.size();
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            submittedGlyphAtlasChanged = false;
+        }
+
+        GLenum err;
+        while ((err = glGetError()) != GL_NO_ERROR)
+        {
+            std::cerr << "got following open gl error after uploading the labels: " << err << std::endl;
+        }
+    }
+}
+
+void LabelBatch::draw(juce::OpenGLShaderProgram &shader, int viewWidth, int viewHeight)
+{
+    const juce::ScopedLock lock(verticesMutex);
+
+    uploadChanges();
+
+    lastDrawCalls = 0;
+    if (gpuVertices > 0)
+    {
+        shader.setUniform("viewSize", (GLfloat)viewWidth, (GLfloat)viewHeight);
+
+        // the glyph atlas goes on the sixth texture unit
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, glyphAtlasTexture);
+        glActiveTexture(GL_TEXTURE0);
+
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)gpuVertices);
+        lastDrawCalls = 1;
+    }
+
+    glBindVertexArray(0);
+}
+
+int LabelBatch::getLastDrawCallsCount() const
+{
+    return lastDrawCalls;
+}
+
+size_t LabelBatch::takeUploadedBytes()
+{
+    size_t bytes = uploadedBytes;
+    uploadedBytes = 0;
+    return bytes;
+}
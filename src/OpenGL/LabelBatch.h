@@ -0,0 +1,146 @@
+#ifndef DEF_LABEL_BATCH_HPP
+#define DEF_LABEL_BATCH_HPP
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <juce_opengl/juce_opengl.h>
+#include <unordered_map>
+#include <vector>
+
+/**< First and last characters rendered in the glyph atlas on creation. Characters above are rendered in it
+ * the first time they are drawn, and the ones below are drawn as question marks */
+#define LABEL_GLYPHS_FIRST_CHAR 32
+#define LABEL_GLYPHS_LAST_CHAR 126
+/**< Height of the labels text in pixels */
+#define LABEL_GLYPHS_FONT_HEIGHT 14.0f
+/**< The glyphs are rasterized bigger than displayed so that they stay sharp on high density screens */
+#define LABEL_GLYPHS_OVERSAMPLING 2
+/**< Number of glyphs per row of the glyph atlas */
+#define LABEL_GLYPHS_ATLAS_COLUMNS 16
+/**< Number of rows of the glyph atlas, which bounds how many different characters the labels can show at once */
+#define LABEL_GLYPHS_ATLAS_ROWS 32
+
+// a vertex of the labels, in pixels from the upper left corner of the view
+struct LabelVertex
+{
+    float position[2];
+    float texturePosition[2];
+    float colour[4];
+    // position from the center of the box, to draw its rounded corners in the fragment shader
+    float boxPosition[2];
+    // half width, half height, corner radius and border thickness of the box,
+    // or zeros for the glyphs
+    float boxShape[4];
+};
+
+/**
+ * @brief      Draws the boxes and text of the samples labels with a single draw call.
+ *             The text is made of quads textured from an atlas of the glyphs of the
+ *             embedded monospace font. Printable ASCII glyphs are rasterized once, and
+ *             other characters the first time they are drawn. Boxes are quads whose rounded
+ *             corners and borders are computed in the fragment shader.
+ *             The labels are built on the message thread with the add functions and
+ *             submit, and are sent to the GPU from the OpenGL thread right before drawing.
+ */
+class LabelBatch
+{
+  public:
+    LabelBatch();
+
+    /**
+     * @brief      Gets the width the text takes once drawn, in pixels.
+     */
+    float getTextWidth(const juce::String &text) const;
+
+    /**
+     * @brief      Removes the labels being built, the ones submitted are still drawn.
+     *             If the glyph atlas is full, the glyphs that were rasterized on demand are
+     *             forgotten so that the new labels can use their cells.
+     */
+    void clear();
+
+    /**
+     * @brief      Adds a filled box with rounded corners.
+     */
+    void addBox(juce::Rectangle<float> box, juce::Colour colour, float cornerRadius);
+
+    /**
+     * @brief      Adds the border of a box with rounded corners, drawn inside the box.
+     */
+    void addBorder(juce::Rectangle<float> box, juce::Colour colour, float cornerRadius, float thickness);
+
+    /**
+     * @brief      Adds a single line of text, left aligned and vertically centered in the box.
+     *             Text that doesn't fit is cut and ends with an ellipsis.
+     */
+    void addText(const juce::String &text, juce::Rectangle<float> box, juce::Colour colour);
+
+    /**
+     * @brief      Makes the labels built since the last clear the ones drawn.
+     *
+     * @return     true if they are different from the ones drawn before.
+     */
+    bool submit();
+
+    /**
+     * @brief      Draws the submitted labels, with the label shader in use. To be called from the OpenGL thread.
+     *
+     * @param      shader      The label shader, whose glyph atlas sampler must be set to the sixth texture unit.
+     * @param[in]  viewWidth   The view width, in the pixels the labels are positioned in
+     * @param[in]  viewHeight  The view height, in the pixels the labels are positioned in
+     */
+    void draw(juce::OpenGLShaderProgram &shader, int viewWidth, int viewHeight);
+
+    /**
+     * @brief      Gets how many draw calls were sent to the GPU by the last draw.
+     */
+    int getLastDrawCallsCount() const;
+
+    /**
+     * @brief      Gets the bytes sent to the GPU since the last call. To be called from the OpenGL thread.
+     */
+    size_t takeUploadedBytes();
+
+  private:
+    void rasterizeGlyphs();
+    void rasterizeGlyph(juce::juce_wchar character, int cell);
+    int findGlyph(juce::juce_wchar character);
+    void uploadChanges();
+    void addQuad(juce::Rectangle<float> quad, juce::Rectangle<float> textureQuad, juce::Colour colour,
+                 const float (&boxShape)[4]);
+
+    GLuint vao;
+    GLuint vbo;
+    GLuint glyphAtlasTexture;
+    bool glObjectsCreated;
+
+    // glyph atlas content, rasterized on creation and updated by addText on the message thread
+    std::vector<unsigned char> glyphAtlas;
+    bool glyphAtlasChanged;
+    int glyphAtlasWidth;
+    int glyphAtlasHeight;
+    juce::Font glyphFont;
+    // cell of the characters rasterized on demand, and the number of cells in use
+    std::unordered_map<juce::juce_wchar, int> extraGlyphs;
+    int numGlyphs;
+    // size of the cell of each glyph in the atlas, in atlas pixels
+    int glyphCellWidth;
+    int glyphCellHeight;
+    // horizontal distance between glyphs in view pixels, the font being monospace
+    float glyphAdvance;
+
+    std::vector<LabelVertex> builtVertices;
+    std::vector<LabelVertex> submittedVertices;
+    bool submittedChanged;
+    // copy of the glyph atlas the submitted labels were built with, for the OpenGL thread
+    std::vector<unsigned char> submittedGlyphAtlas;
+    bool submittedGlyphAtlasChanged;
+    // number of vertices in the GPU buffer
+    size_t gpuVertices;
+    size_t gpuCapacity;
+    int lastDrawCalls;
+    size_t uploadedBytes;
+
+    juce::CriticalSection verticesMutex;
+};
+
+#endif // DEF_LABEL_BATCH_HPP
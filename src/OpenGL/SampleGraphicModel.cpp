@@ -19,6 +19,9 @@ using namespace juce::gl;
 SampleGraphicModel::SampleGraphicModel(std::shared_ptr<SamplePlayer> sp, juce::Colour col)
 {
     reuseTexture = false;
+    meshSlot = -1;
+    dragOffset = 0.0f;
+    dragStartOffset = 0.0f;
 
     displayedSample = sp;
 
@@ -45,115 +48,23 @@ SampleGraphicModel::SampleGraphicModel(std::shared_ptr<SamplePlayer> sp, juce::C
     if (reuseTexture)
     {
         tbo = *optionalTextureId;
-        texture = textureManager->getTextureDataFromId(tbo);
         textureManager->declareTextureUsage(tbo);
     }
 
-    // set a values related to fft data navigation
-    std::shared_ptr<std::vector<float>> ffts = sp->getFftData();
-
-    // the texture scaling in opengl use either manhatan distance or linear sum
-    // of neigbouring pixels. So as we have less pixel over time than pixel over
-    // frequencies, a glitch appear and the values leak to the sides.
-    // This multiplier should help reduce horizontal leakage of textures.
-    // If this is raised too high, this can blow up the GPU memory real fast.
-    // If you change this value, make sure to stress test the loading a bit on shitty GPUs.
-    horizontalScaleMultiplier = 3;
-
+    // NOTE: the texture is a virtual one of one intensity per fft and frequency, and
+    // only the tiles of its visible parts are built from the ffts and sent to the GPU.
     numFfts = sp->getNumFft();
-    numChannels = sp->getBufferNumChannels();
+    textureChannels = sp->getBufferNumChannels();
     textureHeight = 2 * FFT_STORAGE_SCOPE_SIZE;
-    textureWidth = numFfts * horizontalScaleMultiplier;
-    channelTextureShift = textureWidth * (textureHeight >> 1) * 4;
+    textureWidth = numFfts;
 
     if (!reuseTexture)
     {
-        // strangely enough, passing the initializer list is required otherwise the vector
-        // object is broken
-        texture = std::make_shared<std::vector<float>>();
-        // reserve the size of the displayed texture
-        texture->resize((size_t)textureHeight * (size_t)textureWidth * 4); // 4 is for rgba values
-        std::fill(texture->begin(), texture->end(), 1.0f);
-
-        loadFftDataToTexture(ffts);
+        texture = sp->getFftData();
     }
-}
-
-void SampleGraphicModel::loadFftDataToTexture(std::shared_ptr<std::vector<float>> ffts)
-{
-
-    // NOTE: we store the texture colors (fft intensity) as RGBA.
-    // This implies some harsh data duplication, but openGL
-    // requires texture lines to be 4bytes aligned and they
-    // end up compressed and in this format anyway down the line.
-    // We won't put the color in as we will mix it later in the
-    // opengl shader with the vertex color.
-
-    // NOTE: according to
-    // https://gamedev.stackexchange.com/questions/133849/row-order-in-opengl-dxt-texture
-    // which seems to quote an outdated version of the OpenGL doc, texture
-    // data start from bottom left corner and fill the row left to right, then
-    // all the rows above up to the final top right corner.
-
-    float intensity = 0.0f;
-
-    int texturePos = 0;
-    int freqiZoomed = 0;
-
-    int channelFftsShift = numFfts * FFT_STORAGE_SCOPE_SIZE;
 
-    // for each fourier transform over time
-    for (int ffti = 0; ffti < numFfts; ffti++)
-    {
-        // for each frequency of the texture (linear to displayed texture)
-        for (int freqi = 0; freqi < FFT_STORAGE_SCOPE_SIZE; freqi++)
-        {
-            // we apply our polynomial lens freqi transformation to zoom in a bit
-            freqiZoomed = UnitConverter::magnifyTextureFrequencyIndex(freqi);
-            // as the frequencies in the ffts goes from low to high, we have
-            // to flip the freqi to fetch the frequency and it's all good !
-            intensity =
-                (*ffts)[((size_t)ffti * FFT_STORAGE_SCOPE_SIZE) + (FFT_STORAGE_SCOPE_SIZE - ((size_t)freqiZoomed + 1))];
-            // increase contrast and map between 0 and 1
-            intensity = UnitConverter::magnifyIntensity(intensity);
-
-            for (int nDuplicate = 0; nDuplicate < horizontalScaleMultiplier; nDuplicate++)
-            {
-                texturePos = getTextureIndex(freqi, ffti, nDuplicate, true);
-                // now we write the intensity into the texture
-                texture->data()[texturePos] = 1.0f;
-                texture->data()[texturePos + 1] = 1.0f;
-                texture->data()[texturePos + 2] = 1.0f;
-                texture->data()[texturePos + 3] = intensity;
-            }
-
-            // now we write the other channel on bottom part (if not exists, write
-            // first channel instead)
-
-            // pick freq index in the fft
-            freqiZoomed = FFT_STORAGE_SCOPE_SIZE -
-                          (UnitConverter::magnifyTextureFrequencyIndex((FFT_STORAGE_SCOPE_SIZE - (freqi + 1))) + 1);
-            // get the value depending on if we got a second channel or not
-            if (numChannels == 2)
-            {
-                intensity = (*ffts)[(size_t)(channelFftsShift + (ffti * FFT_STORAGE_SCOPE_SIZE) + freqiZoomed)];
-            }
-            else
-            {
-                intensity = (*ffts)[(size_t)((ffti * FFT_STORAGE_SCOPE_SIZE) + freqiZoomed)];
-            }
-            intensity = UnitConverter::magnifyIntensity(intensity);
-
-            for (int nDuplicate = 0; nDuplicate < horizontalScaleMultiplier; nDuplicate++)
-            {
-                texturePos = getTextureIndex(freqi, ffti, nDuplicate, false);
-                texture->data()[texturePos] = 1.0f;
-                texture->data()[texturePos + 1] = 1.0f;
-                texture->data()[texturePos + 2] = 1.0f;
-                texture->data()[texturePos + 3] = intensity;
-            }
-        }
-    }
+    // hover and clicks are tested against the coarse grid instead of the ffts
+    hitGrid = sp->getBufferRef().hitGrid;
 }
 
 void SampleGraphicModel::reloadSampleData(std::shared_ptr<SamplePlayer> sp)
@@ -171,35 +82,59 @@ void SampleGraphicModel::reloadSampleData(std::shared_ptr<SamplePlayer> sp)
     lastFadeInFrameLength = sp->getFadeInLength();
     lastFadeOutFrameLength = sp->getFadeOutLength();
 
+    // the mesh is only created once, then only the lines of vertices that changed are updated
+    bool newMesh = vertices.empty();
+    bool lowPassChanged =
+        newMesh || sp->getLowPassFreq() != lastLowPassFreq || sp->getLowPassRepeat() != lastLowPassRepeat;
+    bool highPassChanged =
+        newMesh || sp->getHighPassFreq() != lastHighPassFreq || sp->getHighPassRepeat() != lastHighPassRepeat;
+
     // vertical frequency positions
     lastLowPassFreq = sp->getLowPassFreq();
     lastHighPassFreq = sp->getHighPassFreq();
+    lastLowPassRepeat = sp->getLowPassRepeat();
+    lastHighPassRepeat = sp->getHighPassRepeat();
 
-    updateFiltersGainReductionSteps(sp);
+    if (newMesh)
+    {
+        generateMesh();
+    }
 
-    // call the function that dynamically generates the vertices
-    generateAndUploadVerticesToGPU(leftX, rightX, lastFadeInFrameLength, lastFadeOutFrameLength);
+    if (lowPassChanged || highPassChanged)
+    {
+        updateFiltersGainReductionSteps(sp, lowPassChanged, highPassChanged);
+        updateFilterVertices();
+    }
+
+    // the vertices now hold the sample position, so any drag offset is cleared
+    dragOffset = 0.0f;
+    updateTimeVertices(leftX, rightX, lastFadeInFrameLength, lastFadeOutFrameLength);
+
+    uploadVerticesToGpu(newMesh);
 }
 
-void SampleGraphicModel::updateFiltersGainReductionSteps(std::shared_ptr<SamplePlayer> sp)
+void SampleGraphicModel::updateFiltersGainReductionSteps(std::shared_ptr<SamplePlayer> sp, bool lowPass,
+                                                         bool highPass)
 {
-    lowPassGainReductionSteps.reserve(FILTERS_FADE_DEFINITION);
-    lowPassGainReductionSteps.clear();
-
-    highPassGainReductionSteps.reserve(FILTERS_FADE_DEFINITION);
-    highPassGainReductionSteps.clear();
+    lowPassGainReductionSteps.resize(FILTERS_FADE_DEFINITION);
+    highPassGainReductionSteps.resize(FILTERS_FADE_DEFINITION);
 
     for (size_t i = 0; i < FILTERS_FADE_DEFINITION; i++)
     {
-        lowPassGainReductionSteps.push_back(SamplePlayer::freqForFilterDbReduction(
-            false, sp->getLowPassFreq(), (i + 1) * FILTERS_FADE_STEP_DB, sp->getLowPassRepeat()));
-        highPassGainReductionSteps.push_back(SamplePlayer::freqForFilterDbReduction(
-            true, sp->getHighPassFreq(), (i + 1) * FILTERS_FADE_STEP_DB, sp->getHighPassRepeat()));
+        if (lowPass)
+        {
+            lowPassGainReductionSteps[i] = SamplePlayer::freqForFilterDbReduction(
+                false, sp->getLowPassFreq(), (i + 1) * FILTERS_FADE_STEP_DB, sp->getLowPassRepeat());
+        }
+        if (highPass)
+        {
+            highPassGainReductionSteps[i] = SamplePlayer::freqForFilterDbReduction(
+                true, sp->getHighPassFreq(), (i + 1) * FILTERS_FADE_STEP_DB, sp->getHighPassRepeat());
+        }
     }
 }
 
-void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float rightX, float fadeInFrames,
-                                                        float fadeOutFrames)
+void SampleGraphicModel::generateMesh()
 {
     // how many vertice line there are vertically (sample fade start, sample start, sample end, sample fade end)
     noVerticalVerticeLines = 4;
@@ -226,13 +161,58 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
 
     // NOTE: We count vertices from left to right and top to bottom (like western text reading order)
 
+    int lastTopPartIndex = (noHorizontalVerticeLines >> 1) - 1;
+
+    // the filters fade out step lines get more transparent away from the filter frequency
+    for (int i = 0; i < FILTERS_FADE_DEFINITION; i++)
+    {
+        float alphaLevel =
+            juce::jlimit(0.0f, 1.0f, (float(FILTERS_FADE_DEFINITION - 1 - i) / float(FILTERS_FADE_DEFINITION)));
+
+        // low pass filter
+        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE, FILTERS_FADE_DEFINITION - 1 - i, alphaLevel);
+        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE,
+                            noHorizontalVerticeLines - FILTERS_FADE_DEFINITION + i, alphaLevel);
+
+        // high pass filter
+        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE,
+                            lastTopPartIndex - FILTERS_FADE_DEFINITION + 1 + i, alphaLevel);
+        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE, lastTopPartIndex + FILTERS_FADE_DEFINITION - i,
+                            alphaLevel);
+    }
+
+    setVerticeLineValue(VERTEX_ALPHA_LEVEL, VERTICAL_VERTEX_LINE, 0, 0.0f);
+    setVerticeLineValue(VERTEX_ALPHA_LEVEL, VERTICAL_VERTEX_LINE, 3, 0.0f);
+
+    // we loop over all squares to connect them together (the square connection actually append trangle ids to be picked
+    // by opengl)
+    for (int i = 0; i < noHorizontalVerticeLines - 1; i++)
+    {
+        // we do not connect the top and bottom part (left and right audio channel drawing)
+        if (i == (noHorizontalVerticeLines >> 1) - 1)
+        {
+            continue;
+        }
+
+        int horizontalLineTopLeftVerticeId = i * noVerticalVerticeLines;
+        int horizontalLineBottomLeftVerticeId = horizontalLineTopLeftVerticeId + noVerticalVerticeLines;
+
+        for (int j = 0; j < noVerticalVerticeLines - 1; j++)
+        {
+            connectSquareFromVertexIds(
+                (size_t)(horizontalLineTopLeftVerticeId + j), (size_t)(horizontalLineTopLeftVerticeId + j + 1),
+                (size_t)(horizontalLineBottomLeftVerticeId + j + 1), (size_t)(horizontalLineBottomLeftVerticeId + j));
+        }
+    }
+}
+
+void SampleGraphicModel::updateFilterVertices()
+{
     // set values of low pass filter fade out step lines
     for (int i = 0; i < FILTERS_FADE_DEFINITION; i++)
     {
         float glDistanceToCenter = UnitConverter::freqToPositionRatio(lowPassGainReductionSteps[(size_t)i]);
         float textureDistanceToCenter = glDistanceToCenter * 0.5;
-        float alphaLevel =
-            juce::jlimit(0.0f, 1.0f, (float(FILTERS_FADE_DEFINITION - 1 - i) / float(FILTERS_FADE_DEFINITION)));
 
         setVerticeLineValue(TEXTURE_POSITION_Y, HORIZONTAL_VERTEX_LINE, FILTERS_FADE_DEFINITION - 1 - i,
                             0.5f + textureDistanceToCenter);
@@ -243,10 +223,6 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
                             -glDistanceToCenter);
         setVerticeLineValue(VERTEX_POSITION_Y, HORIZONTAL_VERTEX_LINE,
                             noHorizontalVerticeLines - FILTERS_FADE_DEFINITION + i, glDistanceToCenter);
-
-        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE, FILTERS_FADE_DEFINITION - 1 - i, alphaLevel);
-        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE,
-                            noHorizontalVerticeLines - FILTERS_FADE_DEFINITION + i, alphaLevel);
     }
 
     int lastTopPartIndex = (noHorizontalVerticeLines >> 1) - 1;
@@ -256,8 +232,6 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
     {
         float glDistanceToCenter = UnitConverter::freqToPositionRatio(highPassGainReductionSteps[(size_t)i]);
         float textureDistanceToCenter = glDistanceToCenter * 0.5;
-        float alphaLevel =
-            juce::jlimit(0.0f, 1.0f, (float(FILTERS_FADE_DEFINITION - 1 - i) / float(FILTERS_FADE_DEFINITION)));
 
         setVerticeLineValue(TEXTURE_POSITION_Y, HORIZONTAL_VERTEX_LINE,
                             lastTopPartIndex - FILTERS_FADE_DEFINITION + 1 + i, 0.5f + textureDistanceToCenter);
@@ -268,11 +242,6 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
                             lastTopPartIndex - FILTERS_FADE_DEFINITION + 1 + i, -glDistanceToCenter);
         setVerticeLineValue(VERTEX_POSITION_Y, HORIZONTAL_VERTEX_LINE, lastTopPartIndex + FILTERS_FADE_DEFINITION - i,
                             glDistanceToCenter);
-
-        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE,
-                            lastTopPartIndex - FILTERS_FADE_DEFINITION + 1 + i, alphaLevel);
-        setVerticeLineValue(VERTEX_ALPHA_LEVEL, HORIZONTAL_VERTEX_LINE, lastTopPartIndex + FILTERS_FADE_DEFINITION - i,
-                            alphaLevel);
     }
 
     // set the two lines of the top and bottom part low pass filters frequencies
@@ -294,7 +263,10 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
     float highPassTexturePos = highPassGlPosition / 2.0f;
     setVerticeLineValue(TEXTURE_POSITION_Y, HORIZONTAL_VERTEX_LINE, topHighPassLineIndex, 0.5f + highPassTexturePos);
     setVerticeLineValue(TEXTURE_POSITION_Y, HORIZONTAL_VERTEX_LINE, botHighPassLineIndex, 0.5f - highPassTexturePos);
+}
 
+void SampleGraphicModel::updateTimeVertices(float leftX, float rightX, float fadeInFrames, float fadeOutFrames)
+{
     // now we set the parameters of the four vertical lines of vertices
     setVerticeLineValue(VERTEX_POSITION_X, VERTICAL_VERTEX_LINE, 0, leftX);
     setVerticeLineValue(VERTEX_POSITION_X, VERTICAL_VERTEX_LINE, 1, leftX + fadeInFrames);
@@ -305,32 +277,6 @@ void SampleGraphicModel::generateAndUploadVerticesToGPU(float leftX, float right
     setVerticeLineValue(TEXTURE_POSITION_X, VERTICAL_VERTEX_LINE, 1, bufferStartPosRatioAfterFadeIn);
     setVerticeLineValue(TEXTURE_POSITION_X, VERTICAL_VERTEX_LINE, 2, bufferEndPosRatioBeforeFadeOut);
     setVerticeLineValue(TEXTURE_POSITION_X, VERTICAL_VERTEX_LINE, 3, bufferEndPosRatio);
-
-    setVerticeLineValue(VERTEX_ALPHA_LEVEL, VERTICAL_VERTEX_LINE, 0, 0.0f);
-    setVerticeLineValue(VERTEX_ALPHA_LEVEL, VERTICAL_VERTEX_LINE, 3, 0.0f);
-
-    // we loop over all squares to connect them together (the square connection actually append trangle ids to be picked
-    // by opengl)
-    for (int i = 0; i < noHorizontalVerticeLines - 1; i++)
-    {
-        // we do not connect the top and bottom part (left and right audio channel drawing)
-        if (i == (noHorizontalVerticeLines >> 1) - 1)
-        {
-            continue;
-        }
-
-        int horizontalLineTopLeftVerticeId = i * noVerticalVerticeLines;
-        int horizontalLineBottomLeftVerticeId = horizontalLineTopLeftVerticeId + noVerticalVerticeLines;
-
-        for (int j = 0; j < noVerticalVerticeLines - 1; j++)
-        {
-            connectSquareFromVertexIds(
-                (size_t)(horizontalLineTopLeftVerticeId + j), (size_t)(horizontalLineTopLeftVerticeId + j + 1),
-                (size_t)(horizontalLineBottomLeftVerticeId + j + 1), (size_t)(horizontalLineBottomLeftVerticeId + j));
-        }
-    }
-
-    uploadVerticesToGpu();
 }
 
 Vertex &SampleGraphicModel::getUpperLeftCorner()
@@ -343,6 +289,16 @@ Vertex &SampleGraphicModel::getUpperRightCorner()
     return vertices[((FILTERS_FADE_DEFINITION + 1) * (size_t)noVerticalVerticeLines) - 1];
 }
 
+float SampleGraphicModel::getLeftFrame()
+{
+    return getUpperLeftCorner().position[0] + dragOffset;
+}
+
+float SampleGraphicModel::getRightFrame()
+{
+    return getUpperRightCorner().position[0] + dragOffset;
+}
+
 void SampleGraphicModel::connectSquareFromVertexIds(size_t topLeft, size_t topRight, size_t bottomRight,
                                                     size_t bottomLeft)
 {
@@ -357,68 +313,84 @@ void SampleGraphicModel::connectSquareFromVertexIds(size_t topLeft, size_t topRi
     triangleIds.push_back(bottomRight);
 }
 
-int SampleGraphicModel::getTextureIndex(int freqIndex, int timeIndex, int freqDuplicateShift, bool isLeftChannel)
+void SampleGraphicModel::requestVisibleTiles(float viewStartFrame, float viewEndFrame, float framesPerPixel)
 {
-    if (isLeftChannel)
+    const juce::ScopedLock lock(loadingMutex);
+
+    if (!loaded || disabled)
     {
-        return ((freqIndex * numFfts * horizontalScaleMultiplier) +
-                (freqDuplicateShift + (timeIndex * horizontalScaleMultiplier))) *
-               4;
+        return;
     }
-    else
+
+    float leftX = getLeftFrame();
+    float rightX = getRightFrame();
+    float visibleStart = juce::jmax(leftX, viewStartFrame);
+    float visibleEnd = juce::jmin(rightX, viewEndFrame);
+    if (visibleEnd <= visibleStart)
     {
-        return channelTextureShift + ((freqIndex * numFfts * horizontalScaleMultiplier) +
-                                      (freqDuplicateShift + (timeIndex * horizontalScaleMultiplier))) *
-                                         4;
+        return;
     }
+
+    // convert the visible frames into the ffts of the audio buffer part we display
+    float fftsPerFrame = (bufferEndPosRatio - bufferStartPosRatio) * float(numFfts) / (rightX - leftX);
+    float firstFft = (bufferStartPosRatio * float(numFfts)) + ((visibleStart - leftX) * fftsPerFrame);
+    float lastFft = (bufferStartPosRatio * float(numFfts)) + ((visibleEnd - leftX) * fftsPerFrame);
+
+    tileAtlas->requestTiles(tbo, firstFft, lastFft, fftsPerFrame * framesPerPixel);
 }
 
 // To run on opengl thread, will recolor track
 void SampleGraphicModel::setColor(juce::Colour &col)
 {
-    float leftX = getUpperLeftCorner().position[0];
-    float rightX = getUpperRightCorner().position[0];
     color = col;
-    generateAndUploadVerticesToGPU(leftX, rightX, lastFadeInFrameLength, lastFadeOutFrameLength);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        vertices[i].colour[0] = color.getFloatRed();
+        vertices[i].colour[1] = color.getFloatGreen();
+        vertices[i].colour[2] = color.getFloatBlue();
+    }
+    uploadVerticesToGpu(false);
 }
 
-// Save position and width when selection dragging begins.
+// Save the offset when selection dragging begins.
 void SampleGraphicModel::initDrag()
 {
-    dragStartPosition = getUpperLeftCorner().position[0];
-    lastWidth = getUpperRightCorner().position[0] - getUpperLeftCorner().position[0];
+    dragStartOffset = dragOffset;
 }
 
-// To run on opengl thread, will update track position to account
-// for the new shift during selection dragging.
+// Will update track position to account for the new shift during selection dragging.
+// The vertices stay the same, the offset is added to them by the vertex shader.
 void SampleGraphicModel::updateDrag(int frameMove)
 {
-    int position = dragStartPosition + frameMove;
-    generateAndUploadVerticesToGPU(position, position + lastWidth, lastFadeInFrameLength, lastFadeOutFrameLength);
+    const juce::ScopedLock lock(loadingMutex);
+
+    dragOffset = dragStartOffset + float(frameMove);
+    if (meshSlot >= 0)
+    {
+        meshBatch->setMeshOffset(meshSlot, dragOffset);
+    }
 }
 
-void SampleGraphicModel::uploadVerticesToGpu()
+void SampleGraphicModel::uploadVerticesToGpu(bool trianglesChanged)
 {
     const juce::ScopedLock lock(loadingMutex);
 
-    glBindVertexArray(vao);
-
-    // register and upload the vertices data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, (long)(sizeof(Vertex) * vertices.size()), vertices.data(), GL_STATIC_DRAW);
-    // register and upload indices of the vertices to form the triangles
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (long)(sizeof(unsigned int) * triangleIds.size()), triangleIds.data(),
-                 GL_STATIC_DRAW);
-
-    GLenum err;
-    while ((err = glGetError()) != GL_NO_ERROR)
+    // the mesh batch sends the changed slots to the GPU right before drawing
+    if (meshSlot >= 0)
     {
-        std::cerr << "got following open gl error after upploading vertices data: " << err << std::endl;
+        if (trianglesChanged)
+        {
+            meshBatch->setMeshVertices(meshSlot, vertices, triangleIds);
+        }
+        else
+        {
+            meshBatch->updateMeshVertices(meshSlot, vertices);
+        }
+        meshBatch->setMeshOffset(meshSlot, dragOffset);
     }
 }
 
-float SampleGraphicModel::textureIntensity(float x, float y)
+float SampleGraphicModel::textureIntensity(float x, float y, float minDb, float maxDb)
 {
     if (x < 0.0 || x > 1.0 || y < 0.0 || y > 1.0)
     {
@@ -431,7 +403,7 @@ float SampleGraphicModel::textureIntensity(float x, float y)
     }
 
     float xInAudioBuffer = juce::jmap(x, bufferStartPosRatio, bufferEndPosRatio);
-    int timeIndex = xInAudioBuffer * numFfts;
+    int timeIndex = juce::jmin(int(xInAudioBuffer * numFfts), numFfts - 1);
     // index of zoomed frequencies, not linear to logarithm of frequencies
     int freqIndexNormalised = 0;
     if (y < 0.5)
@@ -440,10 +412,16 @@ float SampleGraphicModel::textureIntensity(float x, float y)
     }
     else
     {
-        freqIndexNormalised = (y - 0.5) * 2 * FFT_STORAGE_SCOPE_SIZE;
+        freqIndexNormalised = FFT_STORAGE_SCOPE_SIZE + int((y - 0.5) * 2 * FFT_STORAGE_SCOPE_SIZE);
     }
 
-    float intensity = texture->data()[getTextureIndex(freqIndexNormalised, timeIndex, 1, y < 0.5) + 3];
+    if (hitGrid == nullptr)
+    {
+        return 0.0f;
+    }
+
+    float intensity = SpectrogramTileAtlas::getTexelIntensity(*hitGrid, numFfts, textureChannels, freqIndexNormalised,
+                                                              timeIndex, minDb, maxDb);
 
     // now we apply the gain ramps if it falls in the
     if (xInAudioBuffer < bufferStartPosRatioAfterFadeIn)
@@ -534,7 +512,7 @@ int SampleGraphicModel::getFilteringLevel(float yPosition)
 
 juce::int64 SampleGraphicModel::getFramePosition()
 {
-    return juce::int64(getUpperLeftCorner().position[0]);
+    return juce::int64(getLeftFrame());
 }
 
 juce::int64 SampleGraphicModel::getFrameLength()
@@ -542,6 +520,16 @@ juce::int64 SampleGraphicModel::getFrameLength()
     return juce::int64(getUpperRightCorner().position[0] - getUpperLeftCorner().position[0]);
 }
 
+float SampleGraphicModel::getLowPassPositionRatio()
+{
+    return UnitConverter::freqToPositionRatio(lastLowPassFreq);
+}
+
+float SampleGraphicModel::getHighPassPositionRatio()
+{
+    return UnitConverter::freqToPositionRatio(lastHighPassFreq);
+}
+
 std::vector<juce::Rectangle<float>> SampleGraphicModel::getPixelBounds(float viewPosition, float viewScale,
                                                                        float viewHeight)
 {
@@ -552,11 +540,11 @@ std::vector<juce::Rectangle<float>> SampleGraphicModel::getPixelBounds(float vie
     std::vector<juce::Rectangle<float>> rectangles;
 
     rectangles.push_back(juce::Rectangle<float>(
-        (getUpperLeftCorner().position[0] - viewPosition) / viewScale, (1.0 - freqRatioLowPass) * (viewHeight / 2.0),
+        (getLeftFrame() - viewPosition) / viewScale, (1.0 - freqRatioLowPass) * (viewHeight / 2.0),
         (getUpperRightCorner().position[0] - getUpperLeftCorner().position[0]) / viewScale, height / 2.0));
 
     rectangles.push_back(juce::Rectangle<float>(
-        (getUpperLeftCorner().position[0] - viewPosition) / viewScale,
+        (getLeftFrame() - viewPosition) / viewScale,
         (viewHeight / 2.0) + ((freqRatioHighPass) * (viewHeight / 2.0)),
         (getUpperRightCorner().position[0] - getUpperLeftCorner().position[0]) / viewScale, height / 2.0));
 
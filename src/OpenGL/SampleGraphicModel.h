@@ -39,7 +39,8 @@ class SampleGraphicModel : public TexturedModel
     void initDrag();
 
     /**
-     * @brief      Update position drag of this object.
+     * @brief      Update position drag of this object. Only the horizontal offset of the mesh
+     *             changes, so it can be called from any thread.
      *
      * @param[in]  frameMove  How many audio frame the sample must be moved from prev pos.
      */
@@ -50,10 +51,12 @@ class SampleGraphicModel : public TexturedModel
      *
      * @param[in]  x     horizontal texture position ratio (between 0 and 1)
      * @param[in]  y     vertical texture position ratio (between 0 and 1)
+     * @param[in]  minDb  decibels displayed as fully transparent
+     * @param[in]  maxDb  decibels displayed as fully opaque
      *
      * @return     texture intensity between 0 and 1
      */
-    float textureIntensity(float x, float y);
+    float textureIntensity(float x, float y, float minDb, float maxDb);
 
     /**
      * @brief      Get the position of this sample in the global
@@ -70,6 +73,18 @@ class SampleGraphicModel : public TexturedModel
      */
     juce::int64 getFrameLength();
 
+    /**
+     * @brief      Get the vertical position ratio of the low pass filter frequency,
+     *             which is the top of the sample core section in each channel.
+     */
+    float getLowPassPositionRatio();
+
+    /**
+     * @brief      Get the vertical position ratio of the high pass filter frequency,
+     *             which is the bottom of the sample core section in each channel.
+     */
+    float getHighPassPositionRatio();
+
     /**
      * @brief      Change the color of the sample
      */
@@ -96,33 +111,54 @@ class SampleGraphicModel : public TexturedModel
      */
     std::vector<juce::Rectangle<float>> getPixelBounds(float viewPosition, float viewScale, float viewHeight);
 
+    /**
+     * @brief      Requests the spectrogram tiles of the part of this sample that is inside the view,
+     *             at the detail level that fits the zoom. To be called from the OpenGL thread before drawing.
+     *
+     * @param[in]  viewStartFrame  The first frame of the view
+     * @param[in]  viewEndFrame    The last frame of the view
+     * @param[in]  framesPerPixel  The view scale
+     */
+    void requestVisibleTiles(float viewStartFrame, float viewEndFrame, float framesPerPixel);
+
   private:
-    int getTextureIndex(int freqIndex, int timeIndex, int freqDuplicateShift, bool isLeftChannel);
+    /**
+     * @brief      Creates the vertices, with their color and transparency, and the triangles of the mesh.
+     *             Their positions are set by updateFilterVertices and updateTimeVertices.
+     */
+    void generateMesh();
 
-    void generateAndUploadVerticesToGPU(float leftX, float rightX, float fadeInFrames, float fadeOutFrames);
+    /**
+     * @brief      Sets the vertical positions of the horizontal lines of vertices from the filters.
+     */
+    void updateFilterVertices();
 
-    void connectSquareFromVertexIds(size_t, size_t, size_t, size_t);
+    /**
+     * @brief      Sets the horizontal positions of the vertical lines of vertices from the sample
+     *             position and fades.
+     */
+    void updateTimeVertices(float leftX, float rightX, float fadeInFrames, float fadeOutFrames);
 
-    void uploadVerticesToGpu();
-    int isFullyFilteredArea(float y);
+    void connectSquareFromVertexIds(size_t, size_t, size_t, size_t);
 
     /**
-     * Read the data from the stored fft, and load it into the texture array
-     * in a format friendly to OpenGL textures.
-     * @param ffts         The array holding the stored fft data loaded by SamplePlayer.
-     * @param fftCount     How many fft this array contains.
-     * @param channelCount How many channels this array contains.
+     * @brief      Sends the vertices and mesh offset to the mesh batch.
+     *
+     * @param[in]  trianglesChanged  If the triangles must be sent too
      */
-    void loadFftDataToTexture(std::shared_ptr<std::vector<float>> ffts);
+    void uploadVerticesToGpu(bool trianglesChanged);
+    int isFullyFilteredArea(float y);
 
     /**
      * @brief      Updates the filters gain reduction steps we store for visualization.
      *             Will find for each FILTERS_FADE_STEP_DB decibels increment the freq at which
      *             the filters are reducting volume to this intensity.
      *
-     * @param      sp    The samplePlayer object that holds the filters.
+     * @param      sp        The samplePlayer object that holds the filters.
+     * @param[in]  lowPass   If the low pass filter steps must be updated
+     * @param[in]  highPass  If the high pass filter steps must be updated
      */
-    void updateFiltersGainReductionSteps(std::shared_ptr<SamplePlayer> sp);
+    void updateFiltersGainReductionSteps(std::shared_ptr<SamplePlayer> sp, bool lowPass, bool highPass);
 
     /**
      * @brief      For each sample object vertice in the specified line, set its values.
@@ -157,6 +193,13 @@ class SampleGraphicModel : public TexturedModel
      */
     Vertex &getUpperRightCorner();
 
+    /**
+     * @brief      Gets the frame position of the left and right sides of the sample core section,
+     *             including the drag offset.
+     */
+    float getLeftFrame();
+    float getRightFrame();
+
     /**
      * @brief      Gets the filtering level. It's 0 if the area is unfiltered, and goes
      *             from 1 to FILTERS_FADE_DEFINITION for the filtered area. If equal to
@@ -178,15 +221,16 @@ class SampleGraphicModel : public TexturedModel
     // by the high pass filter for each FILTERS_FADE_STEP_DB decibels per step.
     std::vector<float> highPassGainReductionSteps;
 
-    int dragStartPosition;
-    int lastWidth;
+    // horizontal offset of the mesh, in frames, since its vertices were last generated
+    float dragOffset;
+    float dragStartOffset;
 
     int numFfts;
-    int numChannels;
-    int channelTextureShift;
+    // coarse copy of the ffts used for hit tests, shared by all samples of the same audio
+    std::shared_ptr<const SpectrogramHitGrid> hitGrid;
     juce::Colour color;
     float lastLowPassFreq, lastHighPassFreq;
-    int horizontalScaleMultiplier;
+    int lastLowPassRepeat, lastHighPassRepeat;
     float lastFadeInFrameLength, lastFadeOutFrameLength;
 
     // number of vertices lines in the mesh grid
@@ -0,0 +1,375 @@
+#include "SampleMeshBatch.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+using namespace juce::gl;
+
+SampleMeshBatch::SampleMeshBatch()
+    : vao(0), vbo(0), ebo(0), meshDataBuffer(0), meshDataTexture(0), glObjectsCreated(false),
+      verticesPerMeshUniformLocation(-1), verticesPerMesh(0), indicesPerMesh(0), gpuCapacity(0), slotsInUse(0),
+      lastDrawnMeshes(0), lastDrawCalls(0), uploadedBytes(0)
+{
+}
+
+int SampleMeshBatch::allocateMesh(int numVertices, int numIndices)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    // the first mesh gives the size of all the slots
+    if (verticesPerMesh == 0)
+    {
+        verticesPerMesh = numVertices;
+        indicesPerMesh = numIndices;
+    }
+    else if (numVertices != verticesPerMesh || numIndices != indicesPerMesh)
+    {
+        throw std::runtime_error("a mesh of a different size than the others was added to the sample mesh batch");
+    }
+
+    int slot = 0;
+    while (slot < (int)usedSlots.size() && usedSlots[(size_t)slot])
+    {
+        slot++;
+    }
+
+    ensureCapacity(slot);
+    usedSlots[(size_t)slot] = true;
+    slotsInUse = juce::jmax(slotsInUse, slot + 1);
+    return slot;
+}
+
+void SampleMeshBatch::ensureCapacity(int slot)
+{
+    if (slot < (int)usedSlots.size())
+    {
+        return;
+    }
+
+    size_t capacity = juce::jmax((size_t)SAMPLE_MESH_BATCH_INITIAL_CAPACITY, usedSlots.size() * 2);
+    usedSlots.resize(capacity, false);
+    // unused slots have all their vertices at the same place so their triangles draw nothing
+    vertices.resize(capacity * (size_t)verticesPerMesh, {{0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}});
+    meshData.resize(capacity * 4, 0.0f);
+    meshBounds.resize(capacity * 2, 0.0f);
+
+    // the triangles of all slots are the same, only shifted to the slot vertices
+    size_t previousIndices = indices.size();
+    indices.resize(capacity * (size_t)indicesPerMesh, 0);
+    for (size_t i = previousIndices; i < indices.size(); i++)
+    {
+        indices[i] = (unsigned int)((i / (size_t)indicesPerMesh) * (size_t)verticesPerMesh);
+    }
+}
+
+void SampleMeshBatch::releaseMesh(int slot)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= (int)usedSlots.size())
+    {
+        return;
+    }
+
+    usedSlots[(size_t)slot] = false;
+    meshRanges.removeRange(slot);
+    std::fill(vertices.begin() + (long)slot * verticesPerMesh, vertices.begin() + (long)(slot + 1) * verticesPerMesh,
+              Vertex{{0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}});
+    meshData[((size_t)slot * 4) + 3] = 0.0f;
+
+    while (slotsInUse > 0 && !usedSlots[(size_t)(slotsInUse - 1)])
+    {
+        slotsInUse--;
+    }
+
+    dirtyVertices.add(slot);
+    dirtyMeshData.add(slot);
+}
+
+void SampleMeshBatch::setMeshVertices(int slot, const std::vector<Vertex> &meshVertices,
+                                      const std::vector<unsigned int> &triangleIds)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= (int)usedSlots.size() || !usedSlots[(size_t)slot])
+    {
+        return;
+    }
+
+    if ((int)meshVertices.size() != verticesPerMesh || (int)triangleIds.size() != indicesPerMesh)
+    {
+        throw std::runtime_error("a mesh changed its size in the sample mesh batch");
+    }
+
+    unsigned int firstVertex = (unsigned int)(slot * verticesPerMesh);
+    for (size_t i = 0; i < triangleIds.size(); i++)
+    {
+        indices[((size_t)slot * (size_t)indicesPerMesh) + i] = firstVertex + triangleIds[i];
+    }
+    dirtyIndices.add(slot);
+
+    updateMeshVertices(slot, meshVertices);
+}
+
+void SampleMeshBatch::updateMeshVertices(int slot, const std::vector<Vertex> &meshVertices)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= (int)usedSlots.size() || !usedSlots[(size_t)slot])
+    {
+        return;
+    }
+
+    if ((int)meshVertices.size() != verticesPerMesh)
+    {
+        throw std::runtime_error("a mesh changed its size in the sample mesh batch");
+    }
+
+    std::copy(meshVertices.begin(), meshVertices.end(), vertices.begin() + (long)slot * verticesPerMesh);
+
+    auto horizontalBounds =
+        std::minmax_element(meshVertices.begin(), meshVertices.end(),
+                            [](const Vertex &a, const Vertex &b) { return a.position[0] < b.position[0]; });
+    meshBounds[(size_t)slot * 2] = horizontalBounds.first->position[0];
+    meshBounds[((size_t)slot * 2) + 1] = horizontalBounds.second->position[0];
+    updateMeshRange(slot);
+
+    dirtyVertices.add(slot);
+}
+
+void SampleMeshBatch::setMeshOffset(int slot, float frames)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= (int)usedSlots.size() || !usedSlots[(size_t)slot])
+    {
+        return;
+    }
+
+    meshData[((size_t)slot * 4) + 3] = frames;
+    updateMeshRange(slot);
+
+    dirtyMeshData.add(slot);
+}
+
+void SampleMeshBatch::updateMeshRange(int slot)
+{
+    float offset = meshData[((size_t)slot * 4) + 3];
+    meshRanges.setRange(slot, meshBounds[(size_t)slot * 2] + offset, meshBounds[((size_t)slot * 2) + 1] + offset);
+}
+
+void SampleMeshBatch::setMeshSpectrogram(int slot, int numFfts, int pageTableOffset, int pageTableWidth)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= (int)usedSlots.size())
+    {
+        return;
+    }
+
+    meshData[(size_t)slot * 4] = float(numFfts);
+    meshData[((size_t)slot * 4) + 1] = float(pageTableOffset);
+    meshData[((size_t)slot * 4) + 2] = float(pageTableWidth);
+
+    dirtyMeshData.add(slot);
+}
+
+void SampleMeshBatch::setVerticesPerMeshUniformLocation(GLint location)
+{
+    verticesPerMeshUniformLocation = location;
+}
+
+void SampleMeshBatch::uploadChanges()
+{
+    if (!glObjectsCreated)
+    {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glGenBuffers(1, &meshDataBuffer);
+        glGenTextures(1, &meshDataTexture);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+        // position
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(0);
+        // color
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        // texture
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+
+        glObjectsCreated = true;
+    }
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_TEXTURE_BUFFER, meshDataBuffer);
+
+    // reallocate the GPU buffers if they grew, otherwise only send the slots that changed
+    if (gpuCapacity != (int)usedSlots.size())
+    {
+        gpuCapacity = (int)usedSlots.size();
+        glBufferData(GL_ARRAY_BUFFER, (long)(sizeof(Vertex) * vertices.size()), vertices.data(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (long)(sizeof(unsigned int) * indices.size()), indices.data(),
+                     GL_DYNAMIC_DRAW);
+        glBufferData(GL_TEXTURE_BUFFER, (long)(sizeof(float) * meshData.size()), meshData.data(), GL_DYNAMIC_DRAW);
+        uploadedBytes += (sizeof(Vertex) * vertices.size()) + (sizeof(unsigned int) * indices.size()) +
+                         (sizeof(float) * meshData.size());
+
+        glBindTexture(GL_TEXTURE_BUFFER, meshDataTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, meshDataBuffer);
+    }
+    else
+    {
+        // moving samples only changes their offset, and changing their filters or fades only their
+        // vertices, so each buffer only gets the slots that changed in it
+        if (!dirtyVertices.isEmpty())
+        {
+            size_t firstSlot = (size_t)dirtyVertices.first;
+            size_t numSlots = (size_t)(dirtyVertices.last - dirtyVertices.first + 1);
+            glBufferSubData(GL_ARRAY_BUFFER, (long)(sizeof(Vertex) * firstSlot * (size_t)verticesPerMesh),
+                            (long)(sizeof(Vertex) * numSlots * (size_t)verticesPerMesh),
+                            &vertices[firstSlot * (size_t)verticesPerMesh]);
+            uploadedBytes += sizeof(Vertex) * numSlots * (size_t)verticesPerMesh;
+        }
+        if (!dirtyIndices.isEmpty())
+        {
+            size_t firstSlot = (size_t)dirtyIndices.first;
+            size_t numSlots = (size_t)(dirtyIndices.last - dirtyIndices.first + 1);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                            (long)(sizeof(unsigned int) * firstSlot * (size_t)indicesPerMesh),
+                            (long)(sizeof(unsigned int) * numSlots * (size_t)indicesPerMesh),
+                            &indices[firstSlot * (size_t)indicesPerMesh]);
+            uploadedBytes += sizeof(unsigned int) * numSlots * (size_t)indicesPerMesh;
+        }
+        if (!dirtyMeshData.isEmpty())
+        {
+            size_t firstSlot = (size_t)dirtyMeshData.first;
+            size_t numSlots = (size_t)(dirtyMeshData.last - dirtyMeshData.first + 1);
+            glBufferSubData(GL_TEXTURE_BUFFER, (long)(sizeof(float) * firstSlot * 4),
+                            (long)(sizeof(float) * numSlots * 4), &meshData[firstSlot * 4]);
+            uploadedBytes += sizeof(float) * numSlots * 4;
+        }
+    }
+    dirtyVertices.reset();
+    dirtyIndices.reset();
+    dirtyMeshData.reset();
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    GLenum err;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        std::cerr << "got following open gl error after uploading the sample meshes: " << err << std::endl;
+    }
+
+    // the per mesh data goes on the fourth texture unit
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, meshDataTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    if (verticesPerMeshUniformLocation >= 0)
+    {
+        glUniform1i(verticesPerMeshUniformLocation, verticesPerMesh);
+    }
+}
+
+void SampleMeshBatch::drawVisible(float viewStartFrame, float viewEndFrame)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    lastDrawnMeshes = 0;
+    lastDrawCalls = 0;
+    if (slotsInUse == 0)
+    {
+        dirtyVertices.reset();
+        dirtyIndices.reset();
+        dirtyMeshData.reset();
+        return;
+    }
+
+    uploadChanges();
+
+    meshRanges.findOverlapping(viewStartFrame, viewEndFrame, visibleSlots);
+    if (visibleSlots.empty())
+    {
+        glBindVertexArray(0);
+        return;
+    }
+
+    // merge consecutive slots so that they are drawn by the same call
+    std::sort(visibleSlots.begin(), visibleSlots.end());
+    runCounts.clear();
+    runOffsets.clear();
+    size_t runStart = 0;
+    for (size_t i = 1; i <= visibleSlots.size(); i++)
+    {
+        if (i == visibleSlots.size() || visibleSlots[i] != visibleSlots[i - 1] + 1)
+        {
+            runCounts.push_back((GLsizei)((i - runStart) * (size_t)indicesPerMesh));
+            runOffsets.push_back(
+                (const void *)(sizeof(unsigned int) * (size_t)visibleSlots[runStart] * (size_t)indicesPerMesh));
+            runStart = i;
+        }
+    }
+
+    glMultiDrawElements(GL_TRIANGLES, runCounts.data(), GL_UNSIGNED_INT, runOffsets.data(),
+                        (GLsizei)runCounts.size());
+    glBindVertexArray(0);
+
+    lastDrawnMeshes = (int)visibleSlots.size();
+    lastDrawCalls = (int)runCounts.size();
+}
+
+bool SampleMeshBatch::hasPendingChanges()
+{
+    const juce::ScopedLock lock(meshesMutex);
+    return !dirtyVertices.isEmpty() || !dirtyIndices.isEmpty() || !dirtyMeshData.isEmpty() ||
+           (slotsInUse > 0 && gpuCapacity != (int)usedSlots.size());
+}
+
+int SampleMeshBatch::getMeshesCount()
+{
+    const juce::ScopedLock lock(meshesMutex);
+    return meshRanges.size();
+}
+
+int SampleMeshBatch::getLastDrawnMeshesCount() const
+{
+    return lastDrawnMeshes;
+}
+
+int SampleMeshBatch::getLastDrawCallsCount() const
+{
+    return lastDrawCalls;
+}
+
+size_t SampleMeshBatch::takeUploadedBytes()
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    size_t bytes = uploadedBytes;
+    uploadedBytes = 0;
+    return bytes;
+}
+
+void SampleMeshBatch::drawMesh(int slot)
+{
+    const juce::ScopedLock lock(meshesMutex);
+
+    if (slot < 0 || slot >= slotsInUse || !usedSlots[(size_t)slot])
+    {
+        return;
+    }
+
+    uploadChanges();
+    glDrawElements(GL_TRIANGLES, indicesPerMesh, GL_UNSIGNED_INT,
+                   (void *)(sizeof(unsigned int) * (size_t)slot * (size_t)indicesPerMesh));
+    glBindVertexArray(0);
+}
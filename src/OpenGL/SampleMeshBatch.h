@@ -0,0 +1,197 @@
+#ifndef DEF_SAMPLE_MESH_BATCH_HPP
+#define DEF_SAMPLE_MESH_BATCH_HPP
+
+#include "TimeRangeIndex.h"
+#include "Vertex.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <juce_opengl/juce_opengl.h>
+#include <vector>
+
+/**< How many meshes the batch buffers can hold before they are first grown */
+#define SAMPLE_MESH_BATCH_INITIAL_CAPACITY 64
+
+/**
+ * @brief      Holds the meshes of all the samples in one vertex buffer and one index buffer,
+ *             so that they are all drawn with a single draw call. Each mesh gets a slot of
+ *             fixed size, and the per sample data the shaders need (its spectrogram page table
+ *             location and its horizontal offset) lives in a buffer texture indexed by slot. The
+ *             vertex shader finds the slot of each vertex from its index. Only the meshes
+ *             overlapping the viewed time range are drawn, found through an index of their time ranges.
+ *             Meshes can be updated from any thread, and only the slots whose vertices, triangles or
+ *             data changed are sent to the GPU, from the OpenGL thread right before drawing.
+ */
+class SampleMeshBatch
+{
+  public:
+    SampleMeshBatch();
+
+    /**
+     * @brief      Reserves a slot for a mesh. All meshes must have the same number of vertices
+     *             and triangle indices.
+     *
+     * @return     The slot index.
+     */
+    int allocateMesh(int numVertices, int numIndices);
+
+    /**
+     * @brief      Frees a slot. Its triangles are collapsed so that it draws nothing anymore.
+     */
+    void releaseMesh(int slot);
+
+    /**
+     * @brief      Sets the vertices and triangles of a mesh.
+     *
+     * @param[in]  slot         The slot index
+     * @param[in]  vertices     The vertices
+     * @param[in]  triangleIds  The triangle indices, relative to the mesh vertices
+     */
+    void setMeshVertices(int slot, const std::vector<Vertex> &vertices, const std::vector<unsigned int> &triangleIds);
+
+    /**
+     * @brief      Sets the vertices of a mesh whose triangles didn't change since they were set.
+     *
+     * @param[in]  slot      The slot index
+     * @param[in]  vertices  The vertices
+     */
+    void updateMeshVertices(int slot, const std::vector<Vertex> &vertices);
+
+    /**
+     * @brief      Moves a mesh horizontally without changing its vertices, the offset being
+     *             added by the vertex shader. Used to drag samples around cheaply.
+     *
+     * @param[in]  slot    The slot index
+     * @param[in]  frames  The offset in audio frames
+     */
+    void setMeshOffset(int slot, float frames);
+
+    /**
+     * @brief      Sets where the fragment shader finds the spectrogram displayed by a mesh.
+     *
+     * @param[in]  slot             The slot index
+     * @param[in]  numFfts          The number of ffts of the spectrogram
+     * @param[in]  pageTableOffset  The first entry of the spectrogram page table
+     * @param[in]  pageTableWidth   The number of entries of each page table row
+     */
+    void setMeshSpectrogram(int slot, int numFfts, int pageTableOffset, int pageTableWidth);
+
+    /**
+     * @brief      Sets the location of the shader uniform receiving the number of vertices of each mesh.
+     */
+    void setVerticesPerMeshUniformLocation(GLint location);
+
+    /**
+     * @brief      Draws the meshes overlapping a time range, with one draw call if possible
+     *             and one per run of consecutive visible slots at most. The spectrogram textures
+     *             must be bound. To be called from the OpenGL thread.
+     *
+     * @param[in]  viewStartFrame  The first visible audio frame
+     * @param[in]  viewEndFrame    The last visible audio frame
+     */
+    void drawVisible(float viewStartFrame, float viewEndFrame);
+
+    /**
+     * @brief      Tells if some meshes changed since they were last drawn.
+     */
+    bool hasPendingChanges();
+
+    /**
+     * @brief      Gets the number of meshes in the batch.
+     */
+    int getMeshesCount();
+
+    /**
+     * @brief      Gets how many meshes and draw calls were sent to the GPU by the last drawVisible.
+     */
+    int getLastDrawnMeshesCount() const;
+    int getLastDrawCallsCount() const;
+
+    /**
+     * @brief      Gets the bytes sent to the GPU since the last call. To be called from the OpenGL thread.
+     */
+    size_t takeUploadedBytes();
+
+    /**
+     * @brief      Draws a single mesh. To be called from the OpenGL thread.
+     */
+    void drawMesh(int slot);
+
+  private:
+    // range of slots changed since last upload
+    struct DirtySlots
+    {
+        int first = -1;
+        int last = -1;
+
+        void add(int slot)
+        {
+            first = first < 0 ? slot : juce::jmin(first, slot);
+            last = juce::jmax(last, slot);
+        }
+        bool isEmpty() const
+        {
+            return first < 0;
+        }
+        void reset()
+        {
+            first = -1;
+            last = -1;
+        }
+    };
+
+    /**
+     * @brief      Creates the GL objects if needed, and uploads what changed since last frame.
+     *             To be called from the OpenGL thread.
+     */
+    void uploadChanges();
+
+    /**
+     * @brief      Grows the CPU copies of the buffers if the slot is out of them.
+     */
+    void ensureCapacity(int slot);
+
+    /**
+     * @brief      Updates the time range of a mesh in the index from its bounds and offset.
+     */
+    void updateMeshRange(int slot);
+
+    GLuint vao;
+    GLuint vbo;
+    GLuint ebo;
+    GLuint meshDataBuffer;
+    GLuint meshDataTexture;
+    bool glObjectsCreated;
+    GLint verticesPerMeshUniformLocation;
+
+    int verticesPerMesh;
+    int indicesPerMesh;
+    // number of slots the GPU buffers were allocated for
+    int gpuCapacity;
+    // one past the highest slot in use, which bounds the drawn indices
+    int slotsInUse;
+
+    std::vector<bool> usedSlots;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    // number of ffts, page table offset, page table width and horizontal offset of each slot
+    std::vector<float> meshData;
+    // leftmost and rightmost vertex positions of each slot, without their offset
+    std::vector<float> meshBounds;
+
+    DirtySlots dirtyVertices;
+    DirtySlots dirtyIndices;
+    DirtySlots dirtyMeshData;
+
+    // time range covered by each mesh
+    TimeRangeIndex meshRanges;
+    // draw calls parameters, kept between frames to avoid allocations
+    std::vector<int> visibleSlots;
+    std::vector<GLsizei> runCounts;
+    std::vector<const void *> runOffsets;
+    int lastDrawnMeshes;
+    int lastDrawCalls;
+    size_t uploadedBytes;
+
+    juce::CriticalSection meshesMutex;
+};
+
+#endif // DEF_SAMPLE_MESH_BATCH_HPP
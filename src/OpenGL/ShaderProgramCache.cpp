@@ -0,0 +1,244 @@
+#include "ShaderProgramCache.h"
+
+#include "../Config.h"
+#include <iomanip>
+#include <iostream>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <sstream>
+#include <stdexcept>
+
+using namespace juce::gl;
+
+// a stored program starts with the binary format and the time it took to build from source
+#define SHADER_CACHE_HEADER_BYTES (sizeof(juce::int32) + sizeof(float))
+
+ShaderProgramCache::ShaderProgramCache()
+    : folderFromConfig(true), builtPrograms(0), loadedPrograms(0), buildMs(0), compileMsOfLoadedPrograms(0)
+{
+}
+
+ShaderProgramCache::ShaderProgramCache(const juce::File &f)
+    : folder(f), folderFromConfig(false), builtPrograms(0), loadedPrograms(0), buildMs(0),
+      compileMsOfLoadedPrograms(0)
+{
+}
+
+juce::File ShaderProgramCache::getFolder()
+{
+    if (!folderFromConfig)
+    {
+        return folder;
+    }
+
+    // the config is only known once the app is configured, which may come after the context creation
+    juce::SharedResourcePointer<Config> sharedConfig;
+    if (sharedConfig->isInvalid() || sharedConfig->getConfigFolderPath().empty())
+    {
+        return juce::File();
+    }
+    return juce::File(sharedConfig->getConfigFolderPath()).getChildFile(SHADER_CACHE_FOLDER);
+}
+
+bool ShaderProgramCache::buildProgram(juce::OpenGLShaderProgram &program, const std::string &name,
+                                      const std::string &vertexShader, const std::string &fragmentShader)
+{
+    double startMs = juce::Time::getMillisecondCounterHiRes();
+    builtPrograms++;
+
+    juce::File cacheFolder = getFolder();
+    bool useCache = cacheFolder != juce::File() && binariesSupported();
+    juce::File file;
+    if (useCache)
+    {
+        file = cacheFolder.getChildFile(name + "-" + getProgramKey(vertexShader, fragmentShader) + ".bin");
+        if (file.existsAsFile())
+        {
+            if (loadProgram(program, file))
+            {
+                loadedPrograms++;
+                buildMs += juce::Time::getMillisecondCounterHiRes() - startMs;
+                return true;
+            }
+
+            // the driver may refuse binaries for reasons its version doesn't tell, build from source instead
+            std::cerr << "Stored shader program " << file.getFileName() << " was rejected, compiling it again"
+                      << std::endl;
+            file.deleteFile();
+            program.release();
+        }
+    }
+
+    if (!program.addVertexShader(vertexShader) || !program.addFragmentShader(fragmentShader))
+    {
+        return false;
+    }
+    if (useCache)
+    {
+        // must be set before linking for the driver to keep the binary around
+        glProgramParameteri(program.getProgramID(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    if (!program.link())
+    {
+        return false;
+    }
+
+    double compileMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+    if (useCache)
+    {
+        saveProgram(program, file, float(compileMs));
+        deleteStaleBinaries(name, file);
+    }
+    buildMs += juce::Time::getMillisecondCounterHiRes() - startMs;
+    return true;
+}
+
+bool ShaderProgramCache::binariesSupported()
+{
+    if (glGetProgramBinary == nullptr || glProgramBinary == nullptr || glProgramParameteri == nullptr)
+    {
+        return false;
+    }
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    // drivers without program binaries may raise an error on the query, which is taken here and only here
+    // so that the errors of other code are left for the error logger
+    GLenum error = glGetError();
+    return error == GL_NO_ERROR && numFormats > 0;
+}
+
+std::string ShaderProgramCache::getProgramKey(const std::string &vertexShader, const std::string &fragmentShader)
+{
+    std::string keyData;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        const GLubyte *value = glGetString(name);
+        keyData += std::string(value != nullptr ? (const char *)value : "") + "\n";
+    }
+    keyData += vertexShader + "\n" + fragmentShader;
+
+    unsigned char hash[SHA_DIGEST_LENGTH];
+    size_t hashlen;
+    EVP_Q_digest(nullptr, "SHA1", nullptr, keyData.data(), keyData.size(), hash, &hashlen);
+    if (hashlen != SHA_DIGEST_LENGTH)
+    {
+        throw std::runtime_error("Unexpected size of sha digest received !");
+    }
+
+    std::stringstream ss;
+    for (int i = 0; i < SHA_DIGEST_LENGTH; i++)
+    {
+        // bytes must be printed as numbers and not as characters
+        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    }
+    return ss.str();
+}
+
+bool ShaderProgramCache::loadProgram(juce::OpenGLShaderProgram &program, const juce::File &file)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data) || data.getSize() <= SHADER_CACHE_HEADER_BYTES)
+    {
+        return false;
+    }
+
+    juce::int32 format;
+    float compileMs;
+    data.copyTo(&format, 0, sizeof(format));
+    data.copyTo(&compileMs, sizeof(format), sizeof(compileMs));
+
+    GLuint programId = program.getProgramID();
+    glProgramBinary(programId, (GLenum)format, data.begin() + SHADER_CACHE_HEADER_BYTES,
+                    (GLsizei)(data.getSize() - SHADER_CACHE_HEADER_BYTES));
+    // unknown formats are reported as an error on top of the link status
+    GLenum error = glGetError();
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(programId, GL_LINK_STATUS, &linked);
+    if (error != GL_NO_ERROR || linked == GL_FALSE)
+    {
+        return false;
+    }
+
+    compileMsOfLoadedPrograms += compileMs;
+    return true;
+}
+
+void ShaderProgramCache::saveProgram(juce::OpenGLShaderProgram &program, const juce::File &file, float compileMs)
+{
+    GLuint programId = program.getProgramID();
+    GLint binaryLength = 0;
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        return;
+    }
+
+    juce::MemoryBlock data(SHADER_CACHE_HEADER_BYTES + (size_t)binaryLength);
+    GLenum format = 0;
+    GLsizei writtenLength = 0;
+    glGetProgramBinary(programId, binaryLength, &writtenLength, &format, data.begin() + SHADER_CACHE_HEADER_BYTES);
+    if (writtenLength <= 0)
+    {
+        std::cerr << "Unable to get the binary of a shader program" << std::endl;
+        return;
+    }
+
+    juce::int32 storedFormat = (juce::int32)format;
+    data.copyFrom(&storedFormat, 0, sizeof(storedFormat));
+    data.copyFrom(&compileMs, sizeof(storedFormat), sizeof(compileMs));
+    data.setSize(SHADER_CACHE_HEADER_BYTES + (size_t)writtenLength);
+
+    if (file.getParentDirectory().createDirectory().failed() || !file.replaceWithData(data.getData(), data.getSize()))
+    {
+        std::cerr << "Unable to store a shader program in " << file.getParentDirectory().getFullPathName()
+                  << std::endl;
+    }
+}
+
+void ShaderProgramCache::deleteStaleBinaries(const std::string &name, const juce::File &storedFile)
+{
+    if (!storedFile.existsAsFile())
+    {
+        return;
+    }
+
+    for (auto &binary : storedFile.getParentDirectory().findChildFiles(juce::File::findFiles, false, "*.bin"))
+    {
+        bool sameProgram =
+            binary.getFileNameWithoutExtension().upToLastOccurrenceOf("-", false, false).toStdString() == name;
+        if (sameProgram && binary != storedFile && !binary.deleteFile())
+        {
+            std::cerr << "Unable to delete the stale shader program " << binary.getFullPathName() << std::endl;
+        }
+    }
+}
+
+void ShaderProgramCache::resetStats()
+{
+    builtPrograms = 0;
+    loadedPrograms = 0;
+    buildMs = 0;
+    compileMsOfLoadedPrograms = 0;
+}
+
+int ShaderProgramCache::getBuiltProgramsCount() const
+{
+    return builtPrograms;
+}
+
+int ShaderProgramCache::getLoadedProgramsCount() const
+{
+    return loadedPrograms;
+}
+
+double ShaderProgramCache::getBuildMs() const
+{
+    return buildMs;
+}
+
+double ShaderProgramCache::getCompileMsOfLoadedPrograms() const
+{
+    return compileMsOfLoadedPrograms;
+}
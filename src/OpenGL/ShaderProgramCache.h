@@ -0,0 +1,114 @@
+#ifndef DEF_SHADER_PROGRAM_CACHE_HPP
+#define DEF_SHADER_PROGRAM_CACHE_HPP
+
+#include "juce_opengl/opengl/juce_gl.h"
+#include <juce_opengl/juce_opengl.h>
+#include <string>
+
+/**< Folder of the config folder where the linked shader programs are stored */
+#define SHADER_CACHE_FOLDER "shader_cache"
+
+/**
+ * @brief      Builds shader programs from their sources, or from the program binary the driver
+ *             gave back the last time the same sources were linked, which skips the compilation.
+ *             Binaries are stored in a file per program named after the program and the SHA1
+ *             digest of the driver vendor, renderer and version and of the shader sources, so
+ *             that a driver update or a shader change never loads a stale binary. Storing a
+ *             binary deletes the other binaries of the same program. When the driver can't
+ *             save binaries or refuses a stored one, the program is built from its sources.
+ *             Must be used from the OpenGL thread.
+ */
+class ShaderProgramCache
+{
+  public:
+    /**
+     * @brief      Creates a cache storing the binaries in the shader cache folder of the config folder.
+     *             Programs are built from source while the app is not configured.
+     */
+    ShaderProgramCache();
+
+    /**
+     * @brief      Creates a cache storing the binaries in a folder, created if needed.
+     */
+    ShaderProgramCache(const juce::File &folder);
+
+    /**
+     * @brief      Loads the program from the cache, or compiles and links it and stores it in the cache.
+     *
+     * @param      program         The program, with no shader added yet
+     * @param[in]  name            The name of the program, unique among the programs of the cache and without dashes
+     * @param[in]  vertexShader    The vertex shader source
+     * @param[in]  fragmentShader  The fragment shader source
+     *
+     * @return     true if the program is linked.
+     */
+    bool buildProgram(juce::OpenGLShaderProgram &program, const std::string &name, const std::string &vertexShader,
+                      const std::string &fragmentShader);
+
+    /**
+     * @brief      Resets the build statistics.
+     */
+    void resetStats();
+
+    /**
+     * @brief      Gets the number of programs built, and how many of them came from the cache,
+     *             since the statistics were reset.
+     */
+    int getBuiltProgramsCount() const;
+    int getLoadedProgramsCount() const;
+
+    /**
+     * @brief      Gets the time spent building programs since the statistics were reset.
+     */
+    double getBuildMs() const;
+
+    /**
+     * @brief      Gets the time the programs loaded from the cache took to compile and link when they
+     *             were stored, since the statistics were reset.
+     */
+    double getCompileMsOfLoadedPrograms() const;
+
+  private:
+    /**
+     * @brief      Gets the folder of the binaries, or a default file if there is none yet.
+     */
+    juce::File getFolder();
+
+    /**
+     * @brief      Tells if the driver can give back and load program binaries.
+     */
+    bool binariesSupported();
+
+    /**
+     * @brief      Gets the name of the file of the program binary, from the driver and the sources.
+     */
+    std::string getProgramKey(const std::string &vertexShader, const std::string &fragmentShader);
+
+    /**
+     * @brief      Loads a program binary stored by saveProgram.
+     *
+     * @return     true if the driver accepted the binary.
+     */
+    bool loadProgram(juce::OpenGLShaderProgram &program, const juce::File &file);
+
+    /**
+     * @brief      Stores the binary of a linked program, with the time it took to compile and link.
+     */
+    void saveProgram(juce::OpenGLShaderProgram &program, const juce::File &file, float compileMs);
+
+    /**
+     * @brief      Deletes the binaries of a program other than the one just stored, as their key
+     *             belongs to an older driver or older shader sources.
+     */
+    void deleteStaleBinaries(const std::string &name, const juce::File &storedFile);
+
+    juce::File folder;
+    bool folderFromConfig;
+
+    int builtPrograms;
+    int loadedPrograms;
+    double buildMs;
+    double compileMsOfLoadedPrograms;
+};
+
+#endif // DEF_SHADER_PROGRAM_CACHE_HPP
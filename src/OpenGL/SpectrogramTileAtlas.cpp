@@ -0,0 +1,665 @@
+#include "SpectrogramTileAtlas.h"
+
+#include "../Audio/UnitConverter.h"
+#include "../Config.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+using namespace juce::gl;
+
+// number of tiles over the height of a spectrogram (both channels)
+#define SPECTROGRAM_TILES_Y ((2 * FFT_STORAGE_SCOPE_SIZE) / SPECTROGRAM_TILE_HEIGHT)
+
+// number of tiles in each atlas layer
+#define SPECTROGRAM_ATLAS_LAYER_TILES (SPECTROGRAM_ATLAS_LAYER_TILES_X * SPECTROGRAM_ATLAS_LAYER_TILES_Y)
+
+// values of the tile slots of tiles that are not in the atlas
+#define SPECTROGRAM_TILE_MISSING -1
+#define SPECTROGRAM_TILE_BUILDING -2
+
+// converts a float to the bits of a half float, rounding to nearest and flushing
+// numbers too small for half floats to zero.
+static uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = int((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+    if (exponent <= 0)
+    {
+        return (uint16_t)sign;
+    }
+    if (exponent >= 31)
+    {
+        return (uint16_t)(sign | 0x7c00);
+    }
+    // a rounding carry goes into the exponent, which is still the right result
+    return (uint16_t)(sign | (((uint32_t)exponent << 10) + ((mantissa + 0x1000) >> 13)));
+}
+
+SpectrogramTileAtlas::SpectrogramTileAtlas()
+    : atlasTexture(0), atlasCreated(false),
+      numLayers((int)(((size_t)SPECTROGRAM_DEFAULT_GPU_MEMORY_MB << 20) / SPECTROGRAM_ATLAS_LAYER_BYTES)),
+      nextUploadBuffer(0), pageTablesBuffer(0), pageTablesTexture(0),
+      pageTablesGpuCapacity(0), firstDirtyEntry(-1), lastDirtyEntry(-1), nextSpectrogramId(1), frameCounter(0),
+      pendingTiles(false), uploadedBytes(0), jobsInFlight(0), stopBuilders(false)
+{
+    for (int i = 0; i < SPECTROGRAM_TILE_BUILDER_THREADS; i++)
+    {
+        builderThreads.emplace_back(std::thread(&SpectrogramTileAtlas::tileBuilderLoop, this));
+    }
+}
+
+SpectrogramTileAtlas::~SpectrogramTileAtlas()
+{
+    {
+        std::scoped_lock<std::mutex> lock(jobsMutex);
+        stopBuilders = true;
+    }
+
+    jobsCondition.notify_all();
+
+    for (size_t i = 0; i < builderThreads.size(); i++)
+    {
+        builderThreads[i].join();
+    }
+    builderThreads.clear();
+}
+
+void SpectrogramTileAtlas::setMemoryBudget(size_t bytes)
+{
+    int layers = juce::jmax(1, (int)(bytes / SPECTROGRAM_ATLAS_LAYER_BYTES));
+    if (atlasCreated && layers != numLayers)
+    {
+        std::cerr << "The spectrogram GPU memory budget will only change after a restart" << std::endl;
+        return;
+    }
+    numLayers = layers;
+}
+
+size_t SpectrogramTileAtlas::getMemoryBudget() const
+{
+    return (size_t)numLayers * SPECTROGRAM_ATLAS_LAYER_BYTES;
+}
+
+size_t SpectrogramTileAtlas::getUsedMemory() const
+{
+    size_t usedSlots = (size_t)std::count_if(slots.begin(), slots.end(), [](const AtlasSlot &s) { return s.used; });
+    return usedSlots * (SPECTROGRAM_ATLAS_LAYER_BYTES / SPECTROGRAM_ATLAS_LAYER_TILES);
+}
+
+void SpectrogramTileAtlas::createAtlasTexture()
+{
+    // the drivers have a maximum number of layers per texture array
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (maxLayers > 0 && numLayers > maxLayers)
+    {
+        std::cerr << "Spectrogram GPU memory budget reduced to the " << maxLayers << " texture layers the driver allows"
+                  << std::endl;
+        numLayers = maxLayers;
+    }
+
+    AtlasSlot freeSlot = {false, 0, 0, 0, 0, 0};
+    slots.resize((size_t)(numLayers * SPECTROGRAM_ATLAS_LAYER_TILES), freeSlot);
+
+    glGenTextures(1, &atlasTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // allocate all the layers without uploading anything, tiles are written as they are needed
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R16F, SPECTROGRAM_ATLAS_LAYER_TILES_X * SPECTROGRAM_TILE_WIDTH,
+                 SPECTROGRAM_ATLAS_LAYER_TILES_Y * SPECTROGRAM_TILE_HEIGHT, numLayers, 0, GL_RED, GL_FLOAT,
+                 nullptr);
+
+    GLenum err;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        std::cerr << "got following open gl error after allocating the spectrogram atlas: " << err << std::endl;
+    }
+
+    // tiles are sent through pixel buffers so that glTexSubImage3D returns without waiting for the copy
+    glGenBuffers(SPECTROGRAM_TILE_UPLOADS_PER_FRAME, uploadBuffers);
+
+    // all the page tables live in one buffer texture
+    glGenBuffers(1, &pageTablesBuffer);
+    glGenTextures(1, &pageTablesTexture);
+
+    atlasCreated = true;
+    std::cout << "Allocated spectrogram atlas of " << slots.size() << " tiles taking " << (getMemoryBudget() >> 20)
+              << " MB of GPU memory" << std::endl;
+}
+
+int SpectrogramTileAtlas::getNumTilesX(int numFfts, int level)
+{
+    int fftsPerTile = SPECTROGRAM_TILE_WIDTH << level;
+    return juce::jmax(1, (numFfts + fftsPerTile - 1) / fftsPerTile);
+}
+
+GLuint SpectrogramTileAtlas::registerSpectrogram(std::shared_ptr<std::vector<float>> ffts, int numFfts,
+                                                 int numChannels)
+{
+    if (!atlasCreated)
+    {
+        createAtlasTexture();
+    }
+
+    Spectrogram spectrogram;
+    spectrogram.ffts = ffts;
+    spectrogram.numFfts = numFfts;
+    spectrogram.numChannels = numChannels;
+    for (int level = 0; level < SPECTROGRAM_TILE_LEVELS; level++)
+    {
+        spectrogram.tileSlots[level].assign((size_t)(getNumTilesX(numFfts, level) * SPECTROGRAM_TILES_Y),
+                                            SPECTROGRAM_TILE_MISSING);
+    }
+    // the page table has one entry per level 0 tile
+    spectrogram.pageTableWidth = getNumTilesX(numFfts, 0);
+    spectrogram.pageTableOffset = allocatePageTable(spectrogram.pageTableWidth * SPECTROGRAM_TILES_Y);
+
+    size_t tileBytes = SPECTROGRAM_TILE_WIDTH * SPECTROGRAM_TILE_HEIGHT * TEXTURE_GPU_TEXEL_BYTES;
+    size_t fullTextureBytes = (size_t)numFfts * 2 * FFT_STORAGE_SCOPE_SIZE * TEXTURE_GPU_TEXEL_BYTES;
+    std::cout << "Registered spectrogram of " << numFfts << " ffts as " << spectrogram.tileSlots[0].size()
+              << " tiles of " << tileBytes / 1024 << " KB streamed on demand instead of a "
+              << fullTextureBytes / 1024 << " KB texture" << std::endl;
+
+    GLuint spectrogramId = nextSpectrogramId++;
+    spectrograms[spectrogramId] = spectrogram;
+    return spectrogramId;
+}
+
+void SpectrogramTileAtlas::releaseSpectrogram(GLuint spectrogramId)
+{
+    auto spectrogramIterator = spectrograms.find(spectrogramId);
+    if (spectrogramIterator == spectrograms.end())
+    {
+        throw std::runtime_error("trying to release a spectrogram that doesn't exists");
+    }
+
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (slots[i].used && slots[i].spectrogramId == spectrogramId)
+        {
+            slots[i].used = false;
+        }
+    }
+
+    freePageTable(spectrogramIterator->second.pageTableOffset,
+                  spectrogramIterator->second.pageTableWidth * SPECTROGRAM_TILES_Y);
+    spectrograms.erase(spectrogramIterator);
+}
+
+int SpectrogramTileAtlas::allocatePageTable(int numEntries)
+{
+    // first fit in the free ranges
+    for (auto range = freePageTableRanges.begin(); range != freePageTableRanges.end(); range++)
+    {
+        if (range->second >= numEntries)
+        {
+            int offset = range->first;
+            int remainingEntries = range->second - numEntries;
+            freePageTableRanges.erase(range);
+            if (remainingEntries > 0)
+            {
+                freePageTableRanges[offset + numEntries] = remainingEntries;
+            }
+            return offset;
+        }
+    }
+
+    // grow the buffer, the new space being merged with a free range at its end
+    int previousCapacity = (int)(pageTables.size() / 4);
+    int capacity = juce::jmax(SPECTROGRAM_PAGE_TABLES_INITIAL_CAPACITY, previousCapacity * 2);
+    int freeEnd = previousCapacity;
+    auto lastRange = freePageTableRanges.empty() ? freePageTableRanges.end() : std::prev(freePageTableRanges.end());
+    if (lastRange != freePageTableRanges.end() && lastRange->first + lastRange->second == previousCapacity)
+    {
+        freeEnd = lastRange->first;
+        freePageTableRanges.erase(lastRange);
+    }
+    while (capacity - freeEnd < numEntries)
+    {
+        capacity *= 2;
+    }
+    pageTables.resize((size_t)capacity * 4, -1.0f);
+    if (capacity - freeEnd > numEntries)
+    {
+        freePageTableRanges[freeEnd + numEntries] = capacity - freeEnd - numEntries;
+    }
+    return freeEnd;
+}
+
+void SpectrogramTileAtlas::freePageTable(int offset, int numEntries)
+{
+    std::fill(pageTables.begin() + (long)offset * 4, pageTables.begin() + (long)(offset + numEntries) * 4, -1.0f);
+
+    // merge with the neighbouring free ranges
+    auto next = freePageTableRanges.lower_bound(offset);
+    if (next != freePageTableRanges.end() && next->first == offset + numEntries)
+    {
+        numEntries += next->second;
+        next = freePageTableRanges.erase(next);
+    }
+    if (next != freePageTableRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            previous->second += numEntries;
+            return;
+        }
+    }
+    freePageTableRanges[offset] = numEntries;
+}
+
+int SpectrogramTileAtlas::getPageTableOffset(GLuint spectrogramId) const
+{
+    auto spectrogramIterator = spectrograms.find(spectrogramId);
+    return spectrogramIterator == spectrograms.end() ? -1 : spectrogramIterator->second.pageTableOffset;
+}
+
+int SpectrogramTileAtlas::getPageTableWidth(GLuint spectrogramId) const
+{
+    auto spectrogramIterator = spectrograms.find(spectrogramId);
+    return spectrogramIterator == spectrograms.end() ? 0 : spectrogramIterator->second.pageTableWidth;
+}
+
+void SpectrogramTileAtlas::beginFrame()
+{
+    frameCounter++;
+    pendingTiles = false;
+}
+
+bool SpectrogramTileAtlas::hasPendingTiles() const
+{
+    return pendingTiles;
+}
+
+size_t SpectrogramTileAtlas::takeUploadedBytes()
+{
+    size_t bytes = uploadedBytes;
+    uploadedBytes = 0;
+    return bytes;
+}
+
+void SpectrogramTileAtlas::requestTiles(GLuint spectrogramId, float firstFft, float lastFft, float fftsPerPixel)
+{
+    auto spectrogramIterator = spectrograms.find(spectrogramId);
+    if (spectrogramIterator == spectrograms.end())
+    {
+        return;
+    }
+
+    // pick the level with the most ffts per texel that is still under one texel per pixel
+    int level = 0;
+    while (level < SPECTROGRAM_TILE_LEVELS - 1 && fftsPerPixel >= float(2 << level))
+    {
+        level++;
+    }
+
+    // the coarsest level comes first, so something is displayed while the detailed tiles stream in
+    if (level != SPECTROGRAM_TILE_LEVELS - 1)
+    {
+        requestLevelTiles(spectrogramId, spectrogramIterator->second, SPECTROGRAM_TILE_LEVELS - 1, firstFft,
+                          lastFft);
+    }
+    requestLevelTiles(spectrogramId, spectrogramIterator->second, level, firstFft, lastFft);
+}
+
+void SpectrogramTileAtlas::requestLevelTiles(GLuint spectrogramId, Spectrogram &spectrogram, int level,
+                                             float firstFft, float lastFft)
+{
+    int fftsPerTile = SPECTROGRAM_TILE_WIDTH << level;
+    int lastTileX = getNumTilesX(spectrogram.numFfts, level) - 1;
+    int firstVisibleTileX = juce::jlimit(0, lastTileX, int(firstFft) / fftsPerTile);
+    int lastVisibleTileX = juce::jlimit(0, lastTileX, int(lastFft) / fftsPerTile);
+
+    for (int tileX = firstVisibleTileX; tileX <= lastVisibleTileX; tileX++)
+    {
+        for (int tileY = 0; tileY < SPECTROGRAM_TILES_Y; tileY++)
+        {
+            int &slotIndex = spectrogram.tileSlots[level][(size_t)(tileX * SPECTROGRAM_TILES_Y + tileY)];
+            if (slotIndex >= 0)
+            {
+                slots[(size_t)slotIndex].lastUsedFrame = frameCounter;
+                continue;
+            }
+
+            pendingTiles = true;
+            if (slotIndex == SPECTROGRAM_TILE_BUILDING || jobsInFlight >= SPECTROGRAM_TILE_BUILDS_IN_FLIGHT)
+            {
+                continue;
+            }
+
+            // send the tile to the workers, it is uploaded in a later frame
+            auto job = std::make_shared<TileJob>();
+            job->ffts = spectrogram.ffts;
+            job->numFfts = spectrogram.numFfts;
+            job->numChannels = spectrogram.numChannels;
+            job->spectrogramId = spectrogramId;
+            job->level = level;
+            job->tileX = tileX;
+            job->tileY = tileY;
+            {
+                std::scoped_lock<std::mutex> lock(jobsMutex);
+                queuedJobs.push_back(job);
+            }
+            jobsCondition.notify_one();
+            jobsInFlight++;
+            slotIndex = SPECTROGRAM_TILE_BUILDING;
+        }
+    }
+}
+
+void SpectrogramTileAtlas::tileBuilderLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<TileJob> job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsCondition.wait(lock, [this] { return stopBuilders || !queuedJobs.empty(); });
+            if (stopBuilders)
+            {
+                return;
+            }
+            job = queuedJobs.front();
+            queuedJobs.pop_front();
+        }
+
+        buildTile(*job);
+
+        std::scoped_lock<std::mutex> lock(jobsMutex);
+        builtJobs.push_back(job);
+    }
+}
+
+void SpectrogramTileAtlas::uploadBuiltTiles()
+{
+    int uploadsLeft = SPECTROGRAM_TILE_UPLOADS_PER_FRAME;
+    while (uploadsLeft > 0)
+    {
+        std::shared_ptr<TileJob> job;
+        {
+            std::scoped_lock<std::mutex> lock(jobsMutex);
+            if (builtJobs.empty())
+            {
+                return;
+            }
+            job = builtJobs.front();
+            builtJobs.pop_front();
+        }
+        jobsInFlight--;
+
+        // the spectrogram may have been released while its tile was built
+        auto spectrogramIterator = spectrograms.find(job->spectrogramId);
+        if (spectrogramIterator == spectrograms.end())
+        {
+            continue;
+        }
+        Spectrogram &spectrogram = spectrogramIterator->second;
+        size_t tileIndex = (size_t)(job->tileX * SPECTROGRAM_TILES_Y + job->tileY);
+
+        int slotIndex = acquireSlot();
+        if (slotIndex < 0)
+        {
+            // the atlas is full of tiles drawn in this frame, it will be requested again
+            spectrogram.tileSlots[job->level][tileIndex] = SPECTROGRAM_TILE_MISSING;
+            continue;
+        }
+
+        uploadTile(*job, slotIndex);
+        spectrogram.tileSlots[job->level][tileIndex] = slotIndex;
+        slots[(size_t)slotIndex] = {true, job->spectrogramId, job->level, job->tileX, job->tileY, frameCounter};
+        refreshPageTable(spectrogram, job->level, job->tileX, job->tileY);
+        uploadsLeft--;
+    }
+}
+
+int SpectrogramTileAtlas::acquireSlot()
+{
+    // tiles of the coarsest level are only evicted when no finer tile can be, so that spectrograms
+    // out of view keep a placeholder that is displayed at once when they scroll back
+    int leastRecentlyUsed = -1;
+    int leastRecentlyUsedPlaceholder = -1;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (!slots[i].used)
+        {
+            return (int)i;
+        }
+        if (slots[i].lastUsedFrame == frameCounter)
+        {
+            continue;
+        }
+        int &candidate =
+            slots[i].level == SPECTROGRAM_TILE_LEVELS - 1 ? leastRecentlyUsedPlaceholder : leastRecentlyUsed;
+        if (candidate < 0 || slots[i].lastUsedFrame < slots[(size_t)candidate].lastUsedFrame)
+        {
+            candidate = (int)i;
+        }
+    }
+
+    if (leastRecentlyUsed < 0)
+    {
+        leastRecentlyUsed = leastRecentlyUsedPlaceholder;
+    }
+
+    if (leastRecentlyUsed < 0)
+    {
+        return -1;
+    }
+
+    // evict the tile from its spectrogram
+    AtlasSlot &evicted = slots[(size_t)leastRecentlyUsed];
+    auto owner = spectrograms.find(evicted.spectrogramId);
+    if (owner != spectrograms.end())
+    {
+        owner->second
+            .tileSlots[evicted.level][(size_t)(evicted.tileX * SPECTROGRAM_TILES_Y + evicted.tileY)] =
+            SPECTROGRAM_TILE_MISSING;
+        refreshPageTable(owner->second, evicted.level, evicted.tileX, evicted.tileY);
+    }
+    evicted.used = false;
+
+    return leastRecentlyUsed;
+}
+
+int SpectrogramTileAtlas::getRowFftDataIndex(int row, int numFfts, int numChannels)
+{
+    int freqiZoomed;
+    if (row < FFT_STORAGE_SCOPE_SIZE)
+    {
+        // we apply our polynomial lens freqi transformation to zoom in a bit, and
+        // as the frequencies in the ffts goes from low to high, we have to flip it
+        freqiZoomed = (int)UnitConverter::magnifyTextureFrequencyIndexAt(row);
+        return FFT_STORAGE_SCOPE_SIZE - (freqiZoomed + 1);
+    }
+
+    // the other channel is on the upper part (if not exists, show the first channel instead)
+    int freqi = row - FFT_STORAGE_SCOPE_SIZE;
+    freqiZoomed = (int)UnitConverter::magnifyTextureFrequencyIndexAt(FFT_STORAGE_SCOPE_SIZE - (freqi + 1));
+    int channelFftsShift = numChannels == 2 ? numFfts * FFT_STORAGE_SCOPE_SIZE : 0;
+    return channelFftsShift + FFT_STORAGE_SCOPE_SIZE - (freqiZoomed + 1);
+}
+
+int SpectrogramTileAtlas::getStorageRowFftDataIndex(int row, int numFfts, int numChannels)
+{
+    if (row < FFT_STORAGE_SCOPE_SIZE)
+    {
+        return row;
+    }
+
+    // the other channel is on the upper part (if not exists, show the first channel instead)
+    int channelFftsShift = numChannels == 2 ? numFfts * FFT_STORAGE_SCOPE_SIZE : 0;
+    return channelFftsShift + row - FFT_STORAGE_SCOPE_SIZE;
+}
+
+float SpectrogramTileAtlas::getTexelIntensity(const SpectrogramHitGrid &hitGrid, int numFfts, int numChannels,
+                                              int row, int fftIndex, float minDb, float maxDb)
+{
+    float db = hitGrid.getMaxDb(getRowFftDataIndex(row, numFfts, numChannels), fftIndex);
+    // same mapping as the end of spectrogramIntensity in the fragment shader
+    return juce::jlimit(0.0f, 1.0f, (db - minDb) / (maxDb - minDb));
+}
+
+void SpectrogramTileAtlas::buildTile(TileJob &job)
+{
+    const std::vector<float> &ffts = *job.ffts;
+    int fftsPerTexel = 1 << job.level;
+    int firstFft = job.tileX * SPECTROGRAM_TILE_WIDTH * fftsPerTexel;
+
+    std::vector<int> tileRowIndexes(SPECTROGRAM_TILE_HEIGHT);
+    for (int rowi = 0; rowi < SPECTROGRAM_TILE_HEIGHT; rowi++)
+    {
+        tileRowIndexes[(size_t)rowi] =
+            getStorageRowFftDataIndex((job.tileY * SPECTROGRAM_TILE_HEIGHT) + rowi, job.numFfts, job.numChannels);
+    }
+
+    // NOTE: the texture data start from the bottom left corner and fill the rows
+    // left to right, then all the rows above.
+    job.texels.resize(SPECTROGRAM_TILE_WIDTH * SPECTROGRAM_TILE_HEIGHT);
+    for (int texeli = 0; texeli < SPECTROGRAM_TILE_WIDTH; texeli++)
+    {
+        int texelFirstFft = firstFft + (texeli * fftsPerTexel);
+        int texelLastFft = juce::jmin(texelFirstFft + fftsPerTexel, job.numFfts);
+
+        for (int rowi = 0; rowi < SPECTROGRAM_TILE_HEIGHT; rowi++)
+        {
+            // the columns of coarse levels keep the loudest of their ffts, so that short events stay visible
+            float intensity = MIN_DB;
+            for (int ffti = texelFirstFft; ffti < texelLastFft; ffti++)
+            {
+                size_t index = (size_t)tileRowIndexes[(size_t)rowi] + ((size_t)ffti * FFT_STORAGE_SCOPE_SIZE);
+                intensity = std::max(intensity, ffts[index]);
+            }
+            // the decibels are mapped to intensities by the shader, so that the display range can change
+            job.texels[(size_t)(rowi * SPECTROGRAM_TILE_WIDTH + texeli)] = floatToHalf(intensity);
+        }
+    }
+}
+
+void SpectrogramTileAtlas::uploadTile(TileJob &job, int slotIndex)
+{
+    int layer = slotIndex / SPECTROGRAM_ATLAS_LAYER_TILES;
+    int slotX = (slotIndex % SPECTROGRAM_ATLAS_LAYER_TILES) % SPECTROGRAM_ATLAS_LAYER_TILES_X;
+    int slotY = (slotIndex % SPECTROGRAM_ATLAS_LAYER_TILES) / SPECTROGRAM_ATLAS_LAYER_TILES_X;
+    long tileBytes = (long)(job.texels.size() * sizeof(uint16_t));
+
+    // orphan the previous content of the pixel buffer so that we never wait for the GPU to read it
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffers[nextUploadBuffer]);
+    nextUploadBuffer = (nextUploadBuffer + 1) % SPECTROGRAM_TILE_UPLOADS_PER_FRAME;
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, tileBytes, nullptr, GL_STREAM_DRAW);
+    void *pixelBuffer =
+        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, tileBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (pixelBuffer != nullptr)
+    {
+        std::memcpy(pixelBuffer, job.texels.data(), (size_t)tileBytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        // with a pixel buffer bound, the data pointer is an offset in it
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, slotX * SPECTROGRAM_TILE_WIDTH, slotY * SPECTROGRAM_TILE_HEIGHT,
+                        layer, SPECTROGRAM_TILE_WIDTH, SPECTROGRAM_TILE_HEIGHT, 1, GL_RED, GL_HALF_FLOAT, nullptr);
+        uploadedBytes += (size_t)tileBytes;
+    }
+    else
+    {
+        std::cerr << "unable to map a spectrogram tile pixel buffer" << std::endl;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    GLenum err;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        std::cerr << "got following open gl error after uploading a spectrogram tile: " << err << std::endl;
+    }
+}
+
+void SpectrogramTileAtlas::refreshPageTable(Spectrogram &spectrogram, int level, int tileX, int tileY)
+{
+    int firstPageX = tileX << level;
+    int lastPageX = juce::jmin((tileX + 1) << level, spectrogram.pageTableWidth);
+    if (firstPageX >= lastPageX)
+    {
+        return;
+    }
+
+    for (int pageX = firstPageX; pageX < lastPageX; pageX++)
+    {
+        int entryIndex = spectrogram.pageTableOffset + (tileY * spectrogram.pageTableWidth) + pageX;
+        float *entry = &pageTables[(size_t)entryIndex * 4];
+        entry[0] = entry[1] = entry[2] = entry[3] = -1.0f;
+
+        // the finest resident level wins
+        for (int residentLevel = 0; residentLevel < SPECTROGRAM_TILE_LEVELS; residentLevel++)
+        {
+            size_t tileIndex = (size_t)((pageX >> residentLevel) * SPECTROGRAM_TILES_Y + tileY);
+            int slotIndex = spectrogram.tileSlots[residentLevel][tileIndex];
+            if (slotIndex >= 0)
+            {
+                entry[0] = float(slotIndex / SPECTROGRAM_ATLAS_LAYER_TILES);
+                entry[1] = float((slotIndex % SPECTROGRAM_ATLAS_LAYER_TILES) % SPECTROGRAM_ATLAS_LAYER_TILES_X);
+                entry[2] = float((slotIndex % SPECTROGRAM_ATLAS_LAYER_TILES) / SPECTROGRAM_ATLAS_LAYER_TILES_X);
+                entry[3] = float(residentLevel);
+                break;
+            }
+        }
+    }
+
+    int firstEntry = spectrogram.pageTableOffset + (tileY * spectrogram.pageTableWidth) + firstPageX;
+    int lastEntry = spectrogram.pageTableOffset + (tileY * spectrogram.pageTableWidth) + lastPageX - 1;
+    firstDirtyEntry = firstDirtyEntry < 0 ? firstEntry : juce::jmin(firstDirtyEntry, firstEntry);
+    lastDirtyEntry = juce::jmax(lastDirtyEntry, lastEntry);
+}
+
+void SpectrogramTileAtlas::bindTextures()
+{
+    if (!atlasCreated)
+    {
+        return;
+    }
+
+    uploadBuiltTiles();
+
+    glBindBuffer(GL_TEXTURE_BUFFER, pageTablesBuffer);
+    // reallocate the page tables buffer if it grew, otherwise only send the entries that changed
+    if (pageTablesGpuCapacity != (int)(pageTables.size() / 4))
+    {
+        pageTablesGpuCapacity = (int)(pageTables.size() / 4);
+        glBufferData(GL_TEXTURE_BUFFER, (long)(sizeof(float) * pageTables.size()), pageTables.data(),
+                     GL_DYNAMIC_DRAW);
+        uploadedBytes += sizeof(float) * pageTables.size();
+        glBindTexture(GL_TEXTURE_BUFFER, pageTablesTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, pageTablesBuffer);
+    }
+    else if (firstDirtyEntry >= 0)
+    {
+        glBufferSubData(GL_TEXTURE_BUFFER, (long)(sizeof(float) * (size_t)firstDirtyEntry * 4),
+                        (long)(sizeof(float) * (size_t)(lastDirtyEntry - firstDirtyEntry + 1) * 4),
+                        &pageTables[(size_t)firstDirtyEntry * 4]);
+        uploadedBytes += sizeof(float) * (size_t)(lastDirtyEntry - firstDirtyEntry + 1) * 4;
+    }
+    firstDirtyEntry = -1;
+    lastDirtyEntry = -1;
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    GLenum err;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        std::cerr << "got following open gl error after uploading the spectrogram page tables: " << err << std::endl;
+    }
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, pageTablesTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+}
@@ -0,0 +1,312 @@
+#ifndef DEF_SPECTROGRAM_TILE_ATLAS_HPP
+#define DEF_SPECTROGRAM_TILE_ATLAS_HPP
+
+#include "../Audio/SpectrogramHitGrid.h"
+#include "juce_opengl/opengl/juce_gl.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <atomic>
+#include <juce_opengl/juce_opengl.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**< Bytes per texel of the single channel half float textures sent to the GPU. Texels are decibels. */
+#define TEXTURE_GPU_TEXEL_BYTES 2
+
+/**< Number of ffts in the width of a tile. Always choose a power of two! */
+#define SPECTROGRAM_TILE_WIDTH 128
+
+/**< Number of texture rows in the height of a tile. It must divide 2 * FFT_STORAGE_SCOPE_SIZE. */
+#define SPECTROGRAM_TILE_HEIGHT 1024
+
+/**< Number of tiles in the width and height of each atlas layer */
+#define SPECTROGRAM_ATLAS_LAYER_TILES_X 16
+#define SPECTROGRAM_ATLAS_LAYER_TILES_Y 2
+
+/**< Bytes of GPU memory taken by each layer of the atlas, 8MB with the default sizes */
+#define SPECTROGRAM_ATLAS_LAYER_BYTES                                                                                  \
+    ((size_t)SPECTROGRAM_ATLAS_LAYER_TILES_X * SPECTROGRAM_TILE_WIDTH * SPECTROGRAM_ATLAS_LAYER_TILES_Y *              \
+     SPECTROGRAM_TILE_HEIGHT * TEXTURE_GPU_TEXEL_BYTES)
+
+/**< Number of detail levels. Each level has half the time resolution of the previous one. */
+#define SPECTROGRAM_TILE_LEVELS 3
+
+/**< How many built tiles are uploaded at most in each frame. Each one has its own pixel buffer. */
+#define SPECTROGRAM_TILE_UPLOADS_PER_FRAME 8
+
+/**< Number of worker threads building the tiles from the ffts */
+#define SPECTROGRAM_TILE_BUILDER_THREADS 2
+
+/**< How many tiles can be waiting to be built or uploaded at the same time */
+#define SPECTROGRAM_TILE_BUILDS_IN_FLIGHT 32
+
+/**< How many page table entries the page tables buffer can hold before it is first grown */
+#define SPECTROGRAM_PAGE_TABLES_INITIAL_CAPACITY 16384
+
+/**
+ * @brief      A texture atlas shared by all sample spectrograms, made of fixed size tiles.
+ *             Each spectrogram is a virtual texture of decibels, with one row per stored frequency
+ *             and one column per fft, that is never allocated in full. Its tiles are built from the
+ *             fft data when they are first seen in the viewport, with a per frame upload budget, and
+ *             the least recently drawn tiles are evicted when the atlas, sized by the GPU memory
+ *             budget, is full. The coarsest tiles are evicted last so that they remain as
+ *             placeholders of the spectrograms that scroll back into view. Tiles are built by
+ *             worker threads and uploaded through pixel buffer objects, so that the OpenGL thread
+ *             never waits for them. A page table per spectrogram tells the fragment shader where
+ *             each tile lives. All page tables share one buffer texture so that all samples can be
+ *             drawn at once.
+ *             All functions except getTexelIntensity and setMemoryBudget must be called from the
+ *             OpenGL thread.
+ */
+class SpectrogramTileAtlas
+{
+  public:
+    SpectrogramTileAtlas();
+    ~SpectrogramTileAtlas();
+
+    /**
+     * @brief      Sets how much GPU memory the atlas takes. It is rounded down to whole atlas
+     *             layers, with at least one layer. Can be called from any thread, but only
+     *             applies if the atlas was not allocated yet.
+     *
+     * @param[in]  bytes  The GPU memory budget in bytes
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief      Gets the GPU memory the atlas takes or will take once allocated, in bytes.
+     */
+    size_t getMemoryBudget() const;
+
+    /**
+     * @brief      Gets the GPU memory used by the tiles currently in the atlas, in bytes.
+     */
+    size_t getUsedMemory() const;
+
+    /**
+     * @brief      Declares a spectrogram. Its tiles are only built once they are requested.
+     *
+     * @param[in]  ffts         The stored ffts of the sample, as computed by FftRunner.
+     * @param[in]  numFfts      The number of ffts per channel.
+     * @param[in]  numChannels  The number of channels of the sample.
+     *
+     * @return     The identifier of the spectrogram.
+     */
+    GLuint registerSpectrogram(std::shared_ptr<std::vector<float>> ffts, int numFfts, int numChannels);
+
+    /**
+     * @brief      Frees the tiles and page table of a spectrogram.
+     */
+    void releaseSpectrogram(GLuint spectrogramId);
+
+    /**
+     * @brief      Starts a new frame and resets the tile upload budget.
+     */
+    void beginFrame();
+
+    /**
+     * @brief      Makes the tiles of a spectrogram range resident, at the detail level that
+     *             fits the zoom and with the coarsest level as placeholder while they stream in.
+     *
+     * @param[in]  spectrogramId  The spectrogram identifier
+     * @param[in]  firstFft       The first visible fft
+     * @param[in]  lastFft        The last visible fft
+     * @param[in]  fftsPerPixel   How many ffts are displayed in each screen pixel
+     */
+    void requestTiles(GLuint spectrogramId, float firstFft, float lastFft, float fftsPerPixel);
+
+    /**
+     * @brief      Uploads the tiles the workers built since last frame and the page tables that
+     *             changed, and binds the atlas on the first texture unit and the page tables on
+     *             the third one.
+     */
+    void bindTextures();
+
+    /**
+     * @brief      Gets the index of the first entry of a spectrogram page table in the page tables
+     *             buffer. Entries are stored row by row, one row per tile over the spectrogram height.
+     */
+    int getPageTableOffset(GLuint spectrogramId) const;
+
+    /**
+     * @brief      Gets the number of entries of each row of a spectrogram page table.
+     */
+    int getPageTableWidth(GLuint spectrogramId) const;
+
+    /**
+     * @brief      Tells if some requested tiles are not in the atlas yet because they are still
+     *             being built or were left for the next frames.
+     */
+    bool hasPendingTiles() const;
+
+    /**
+     * @brief      Gets the bytes of tiles and page tables sent to the GPU since the last call.
+     */
+    size_t takeUploadedBytes();
+
+    /**
+     * @brief      Gets the loudest displayed intensity around a spectrogram texel, as the fragment shader
+     *             draws it with the same display range.
+     *
+     * @param[in]  hitGrid      The hit grid of the stored ffts
+     * @param[in]  numFfts      The number of ffts per channel
+     * @param[in]  numChannels  The number of channels
+     * @param[in]  row          The texture row, the first channel being in the lower half
+     * @param[in]  fftIndex     The fft index
+     * @param[in]  minDb        The decibels displayed as fully transparent (the shader dbRange.x)
+     * @param[in]  maxDb        The decibels displayed as fully opaque (the shader dbRange.y)
+     *
+     * @return     The intensity between 0 and 1.
+     */
+    static float getTexelIntensity(const SpectrogramHitGrid &hitGrid, int numFfts, int numChannels, int row,
+                                   int fftIndex, float minDb, float maxDb);
+
+  private:
+    struct Spectrogram
+    {
+        std::shared_ptr<std::vector<float>> ffts;
+        int numFfts;
+        int numChannels;
+        // atlas slot of each tile of each level (negative if not in the atlas), indexed by tileX * tilesY + tileY
+        std::vector<int> tileSlots[SPECTROGRAM_TILE_LEVELS];
+        // location of the page table in the page tables buffer
+        int pageTableOffset;
+        int pageTableWidth;
+    };
+
+    struct TileJob
+    {
+        std::shared_ptr<std::vector<float>> ffts;
+        int numFfts;
+        int numChannels;
+        GLuint spectrogramId;
+        int level;
+        int tileX;
+        int tileY;
+        // half floats, filled by the worker threads
+        std::vector<uint16_t> texels;
+    };
+
+    struct AtlasSlot
+    {
+        bool used;
+        GLuint spectrogramId;
+        int level;
+        int tileX;
+        int tileY;
+        uint64_t lastUsedFrame;
+    };
+
+    /**
+     * @brief      Creates the atlas texture the first time it is needed.
+     */
+    void createAtlasTexture();
+
+    /**
+     * @brief      Makes the tiles of one level resident over a range of ffts.
+     */
+    void requestLevelTiles(GLuint spectrogramId, Spectrogram &spectrogram, int level, float firstFft,
+                           float lastFft);
+
+    /**
+     * @brief      Loop of the worker threads building tiles.
+     */
+    void tileBuilderLoop();
+
+    /**
+     * @brief      Builds the half float texels of a tile from the fft data.
+     */
+    static void buildTile(TileJob &job);
+
+    /**
+     * @brief      Uploads the built tiles into atlas slots, within the frame upload budget.
+     */
+    void uploadBuiltTiles();
+
+    /**
+     * @brief      Finds a free slot, or evicts the least recently used tile not drawn in this frame.
+     *
+     * @return     The slot index, or -1 if every tile was drawn in this frame.
+     */
+    int acquireSlot();
+
+    /**
+     * @brief      Sends a built tile to an atlas slot through one of the pixel buffers.
+     */
+    void uploadTile(TileJob &job, int slotIndex);
+
+    /**
+     * @brief      Updates the page table entries of the level 0 tiles a tile covers.
+     */
+    void refreshPageTable(Spectrogram &spectrogram, int level, int tileX, int tileY);
+
+    /**
+     * @brief      Reserves a range of entries in the page tables buffer, growing it if needed.
+     *
+     * @return     The first entry of the range.
+     */
+    int allocatePageTable(int numEntries);
+
+    /**
+     * @brief      Gives back a range of entries of the page tables buffer.
+     */
+    void freePageTable(int offset, int numEntries);
+
+    /**
+     * @brief      Gets the index of a displayed row frequency in the stored ffts of the first fft.
+     *             Displayed rows have the frequency lens applied.
+     */
+    static int getRowFftDataIndex(int row, int numFfts, int numChannels);
+
+    /**
+     * @brief      Gets the index of a tile row frequency in the stored ffts of the first fft.
+     *             Tile rows hold the frequencies of each channel in storage order, the lens
+     *             being applied by the fragment shader.
+     */
+    static int getStorageRowFftDataIndex(int row, int numFfts, int numChannels);
+
+    static int getNumTilesX(int numFfts, int level);
+
+    GLuint atlasTexture;
+    std::atomic<bool> atlasCreated;
+    // number of layers of the atlas, from the memory budget
+    std::atomic<int> numLayers;
+    GLuint uploadBuffers[SPECTROGRAM_TILE_UPLOADS_PER_FRAME];
+    int nextUploadBuffer;
+
+    GLuint pageTablesBuffer;
+    GLuint pageTablesTexture;
+    // layer, slot column, slot row and level of the finest resident tile covering
+    // each level 0 tile of all spectrograms (all -1 if none)
+    std::vector<float> pageTables;
+    // free ranges of page table entries, by first entry
+    std::map<int, int> freePageTableRanges;
+    // number of entries the GPU buffer was allocated for
+    int pageTablesGpuCapacity;
+    // range of entries changed since last upload
+    int firstDirtyEntry;
+    int lastDirtyEntry;
+
+    GLuint nextSpectrogramId;
+    std::map<GLuint, Spectrogram> spectrograms;
+    std::vector<AtlasSlot> slots;
+
+    uint64_t frameCounter;
+    bool pendingTiles;
+    size_t uploadedBytes;
+
+    // tiles waiting for a worker, and tiles built and waiting for upload
+    std::deque<std::shared_ptr<TileJob>> queuedJobs;
+    std::deque<std::shared_ptr<TileJob>> builtJobs;
+    int jobsInFlight;
+    bool stopBuilders;
+    std::mutex jobsMutex;
+    std::condition_variable jobsCondition;
+    std::vector<std::thread> builderThreads;
+};
+
+#endif // DEF_SPECTROGRAM_TILE_ATLAS_HPP
@@ -1,54 +1,38 @@
 #include "TextureManager.h"
-#include <limits>
 #include <memory>
 #include <stdexcept>
 
 juce::Optional<GLuint> TextureManager::getTextureIdentifier(std::shared_ptr<SamplePlayer> sp)
 {
-    AudioFileBufferRef buffer = sp->getBufferRef();
-
     // if opengl context to free textures was not set, throw an error
     if (!glContext.has_value())
     {
         throw std::runtime_error("Called a texture manager function before setting opengl context");
     }
 
-    // if length is unique, directly return nothing
-    if (texturesLengthCount.find(buffer.data->getNumSamples()) == texturesLengthCount.end())
+    if (!sp->getBufferRef().hasAudio())
     {
         return juce::Optional<GLuint>();
     }
 
-    // compute hash
-    int hashingLength = juce::jmin(buffer.data->getNumSamples(), TEXTURE_MANAGER_HASH_LENGTH);
-    size_t hash = hashAudioChannel(buffer.data->getReadPointer(0), hashingLength);
-
-    // if no items for this hash, return nothing
-    auto foundHash = texturesPerHash.find(hash);
-    if (foundHash == texturesPerHash.end())
+    auto foundTexture = texturesPerKey.find(getTextureKey(sp));
+    if (foundTexture == texturesPerKey.end())
     {
         return juce::Optional<GLuint>();
     }
 
-    std::vector<GLuint> audioBufferIdentifiersBucket = foundHash->second;
+    return foundTexture->second;
+}
 
-    // for each hash item iterate and test full equality
-    for (size_t i = 0; i < audioBufferIdentifiersBucket.size(); i++)
-    {
-        AudioFileBufferRef bucketAudioBuffer = getAudioBufferFromTextureId(audioBufferIdentifiersBucket[i]);
-        if (bucketAudioBuffer.data == nullptr)
-        {
-            throw std::runtime_error(
-                "a TextureManager hash bucket had a GLuint texture identifier for which no audio was found");
-        }
-
-        if (areAudioBufferEqual(*buffer.data, *bucketAudioBuffer.data))
-        {
-            return audioBufferIdentifiersBucket[i];
-        }
-    }
+std::string TextureManager::getTextureKey(std::shared_ptr<SamplePlayer> sp)
+{
+    AudioFileBufferRef buffer = sp->getBufferRef();
 
-    return juce::Optional<GLuint>();
+    // the digest covers all the channels of the audio, whether it is kept compressed or not
+    std::string key((const char *)buffer.hash, SHA_DIGEST_LENGTH);
+    key += ":" + std::to_string(buffer.getNumChannels()) + ":" + std::to_string(buffer.getNumSamples()) + ":" +
+           std::to_string(sp->getNumFft()) + ":" + std::to_string(FFT_STORAGE_SCOPE_SIZE);
+    return key;
 }
 
 void TextureManager::setOpenGlContext(juce::OpenGLContext *gl)
@@ -56,35 +40,6 @@ void TextureManager::setOpenGlContext(juce::OpenGLContext *gl)
     glContext = gl;
 }
 
-bool TextureManager::areAudioBufferEqual(juce::AudioBuffer<float> &a, juce::AudioBuffer<float> &b)
-{
-    if (a.getNumChannels() != b.getNumChannels())
-    {
-        return false;
-    }
-
-    if (a.getNumSamples() != b.getNumSamples())
-    {
-        return false;
-    }
-
-    for (size_t chan = 0; chan < (size_t)a.getNumChannels(); chan++)
-    {
-        auto aData = a.getReadPointer(chan);
-        auto bData = b.getReadPointer(chan);
-
-        for (size_t sample = 0; sample < (size_t)a.getNumSamples(); sample++)
-        {
-            if (std::abs(aData[sample] - bData[sample]) > std::numeric_limits<float>::epsilon())
-            {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
 AudioFileBufferRef TextureManager::getAudioBufferFromTextureId(GLuint id)
 {
     auto textureSearchIterator = audioBufferTextureData.find(id);
@@ -98,48 +53,6 @@ AudioFileBufferRef TextureManager::getAudioBufferFromTextureId(GLuint id)
     return textureSearchIterator->second->audioData;
 }
 
-std::shared_ptr<std::vector<float>> TextureManager::getTextureDataFromId(GLuint identifier)
-{
-    auto textureSearchIterator = audioBufferTextureData.find(identifier);
-
-    if (textureSearchIterator == audioBufferTextureData.end())
-    {
-        return nullptr;
-    }
-
-    return textureSearchIterator->second->textureData;
-}
-
-size_t TextureManager::hashAudioChannel(const float *data, int length)
-{
-    // should not possibly happen
-    if (length == 0)
-    {
-        return 0;
-    }
-
-    std::hash<float> hasher;
-
-    if (length == 1)
-    {
-        return hasher(data[0]);
-    }
-
-    // note: I'm not sure hashing a float makes sense, as in some (most)
-    // implementations size_t would be the same size as a float.
-
-    // inspired by boost implementation of combined hash,
-    // stolen from stack overflow here: https://stackoverflow.com/questions/2590677/how-do-i-combine-hash-values-in-c0x
-    // lots of discussion detailing what it does and why on Stackoverflow
-    size_t seed = 0;
-    for (size_t i = 0; i < (size_t)length; i++)
-    {
-        seed ^= hasher(data[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    }
-
-    return seed;
-}
-
 void TextureManager::decrementUsageCount(GLuint id)
 {
     // if opengl context to free textures was not set, throw an error
@@ -190,47 +103,15 @@ void TextureManager::clearTextureData(GLuint textureId)
         throw std::runtime_error("trying to clear a texture id that doesn't exists");
     }
 
-    // first we need to remove the texture count per audio buffer length
-    auto audioBuffer = textureSearchIterator->second->audioData;
-    auto sampleLength = audioBuffer.data->getNumSamples();
-    if (texturesLengthCount.find(sampleLength) == texturesLengthCount.end())
+    // we remove the texture key, unless another texture of the same audio took it
+    auto foundTexture = texturesPerKey.find(textureSearchIterator->second->key);
+    if (foundTexture == texturesPerKey.end())
     {
-        throw std::runtime_error("texture to delete had no corresponding length count");
+        throw std::runtime_error("A texture to delete had no corresponding texture key!");
     }
-    texturesLengthCount[sampleLength] = texturesLengthCount[sampleLength] - 1;
-    if (texturesLengthCount[sampleLength] <= 0)
+    if (foundTexture->second == textureId)
     {
-        texturesLengthCount.erase(sampleLength);
-    }
-
-    // then we remove the glint from the bucket corresponding to the hash
-    int hashingLength = juce::jmin(audioBuffer.data->getNumSamples(), TEXTURE_MANAGER_HASH_LENGTH);
-    size_t hash = hashAudioChannel(audioBuffer.data->getReadPointer(0), hashingLength);
-    // if no items for this hash, this sucks really hard
-    auto foundHash = texturesPerHash.find(hash);
-    if (foundHash == texturesPerHash.end())
-    {
-        throw std::runtime_error("A texture to delete had no corresponding hash bucket!");
-    }
-    else
-    {
-        bool clearedIdFromBucket = false;
-        std::vector<GLuint> audioBufferIdentifiersBucket = foundHash->second;
-        for (size_t i = 0; i < audioBufferIdentifiersBucket.size(); i++)
-        {
-            if (audioBufferIdentifiersBucket[i] == textureId)
-            {
-                audioBufferIdentifiersBucket.erase(audioBufferIdentifiersBucket.begin() + (long)i);
-                clearedIdFromBucket = true;
-                // as we modify the copy, we need to copy it back!
-                texturesPerHash[hash] = audioBufferIdentifiersBucket;
-                break;
-            }
-        }
-        if (!clearedIdFromBucket)
-        {
-            throw std::runtime_error("A texture to delete was not found in its hash bucket !!");
-        }
+        texturesPerKey.erase(foundTexture);
     }
 
     // we remove the structure with the texture data (note we already checked id exists in there)
@@ -238,14 +119,17 @@ void TextureManager::clearTextureData(GLuint textureId)
 
 // we only proceed to call opengl if we are not in testing mode
 #ifndef WITH_TESTING
-    // and we execute a call on the openGlThread to free the texture
+    // and we execute a call on the openGlThread to free the texture tiles and page table
     glContext.value()->executeOnGLThread(
-        [textureId](juce::OpenGLContext &) { juce::gl::glDeleteTextures(1, &textureId); }, true);
+        [textureId](juce::OpenGLContext &) {
+            juce::SharedResourcePointer<SpectrogramTileAtlas> tileAtlas;
+            tileAtlas->releaseSpectrogram(textureId);
+        },
+        true);
 #endif
 }
 
-void TextureManager::setTexture(GLuint textureId, std::shared_ptr<SamplePlayer> sp,
-                                std::shared_ptr<std::vector<float>> textureData)
+void TextureManager::setTexture(GLuint textureId, std::shared_ptr<SamplePlayer> sp)
 {
     std::cout << "Storing texture for GLuint " << textureId << std::endl;
 
@@ -255,38 +139,14 @@ void TextureManager::setTexture(GLuint textureId, std::shared_ptr<SamplePlayer>
         throw std::runtime_error("Called a texture manager function before setting opengl context");
     }
 
-    // increments textureLength count
-    int length = sp->getBufferRef().data->getNumSamples();
-    if (texturesLengthCount.find(length) == texturesLengthCount.end())
-    {
-        texturesLengthCount[length] = 1;
-    }
-    else
-    {
-        texturesLengthCount[length]++;
-    }
-
-    // add texture identifier to audio hash bucket
-    int hashingLength = juce::jmin(sp->getBufferRef().data->getNumSamples(), TEXTURE_MANAGER_HASH_LENGTH);
-    size_t hash = hashAudioChannel(sp->getBufferRef().data->getReadPointer(0), hashingLength);
-    // if no items for this hash, create a bucket
-    auto foundHash = texturesPerHash.find(hash);
-    if (foundHash == texturesPerHash.end())
-    {
-        std::vector<GLuint> bucket;
-        bucket.push_back(textureId);
-        texturesPerHash[hash] = bucket;
-    }
-    // if a bucket exists, append to it
-    else
-    {
-        foundHash->second.push_back(textureId);
-    }
+    // identical audio is expected to reuse the texture, so a key only keeps its first texture
+    std::string key = getTextureKey(sp);
+    texturesPerKey.insert(std::pair<std::string, GLuint>(key, textureId));
 
     // populate the struct with texture data and save it
     auto newTextureData = std::make_shared<AudioBufferTextureData>();
     newTextureData->audioData = sp->getBufferRef();
-    newTextureData->textureData = textureData;
+    newTextureData->key = key;
     newTextureData->useCount = 1;
 
     audioBufferTextureData.insert(
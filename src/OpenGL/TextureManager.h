@@ -2,17 +2,17 @@
 #define DEF_TEXTURE_MANAGER_HPP
 
 #include "../Audio/SamplePlayer.h"
+#include "SpectrogramTileAtlas.h"
 #include "juce_opengl/opengl/juce_gl.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_opengl/juce_opengl.h>
 #include <memory>
-
-#define TEXTURE_MANAGER_HASH_LENGTH 1024
+#include <unordered_map>
 
 struct AudioBufferTextureData
 {
-    std::shared_ptr<std::vector<float>> textureData;
     AudioFileBufferRef audioData;
+    std::string key;
     int useCount;
 };
 
@@ -57,25 +57,15 @@ class TextureManager
      */
     AudioFileBufferRef getAudioBufferFromTextureId(GLuint id);
 
-    /**
-     * @brief      Gets the texture data from identifier.
-     *
-     * @param[in]  id the open gl id that was return by getTextureIdentifier or passed to setTextureIdentifier
-     *
-     * @return     The texture data from identifier.
-     */
-    std::shared_ptr<std::vector<float>> getTextureDataFromId(GLuint);
-
     /**
      * @brief      Te be called when a texture was registered to openGL, will save the texture
-     *             identifier to share it, as well as raw texture data and sample audio for
-     *             identification purpose of forthcoming duplicated that needs to reuse the texture.
+     *             identifier to share it, as well as the sample audio for identification
+     *             purpose of forthcoming duplicated that needs to reuse the texture.
      *
      * @param[in]  index        Texture index assigned by openGL
      * @param[in]  sp           Pointer for the displayed SamplePlayer
-     * @param[in]  textureData  The texture data (RGBA one that is sent to GPU)
      */
-    void setTexture(GLuint index, std::shared_ptr<SamplePlayer> sp, std::shared_ptr<std::vector<float>> textureData);
+    void setTexture(GLuint index, std::shared_ptr<SamplePlayer> sp);
 
     /**
      * @brief      Declares that a texture id was used in a new opengl object.
@@ -121,21 +111,14 @@ class TextureManager
     void freeTextureIdResources(GLuint id);
 
     /**
-     * @brief      Generate a hash of the data provided up to length.
+     * @brief      Gets the key identifying the texture of a sample: the SHA1 digest of its audio
+     *             followed by the parameters the texture data depends on.
      *
-     * @param[in]  data    The data
-     * @param[in]  length  The length
+     * @param[in]  sp    The sample player
      *
-     * @return     a hash of the first length samples of the floats at data
+     * @return     The texture key.
      */
-    size_t hashAudioChannel(const float *data, int length);
-
-    /**
-     * @brief      test if two audio buffer are equal on all channels
-     *
-     * @return     true if equal, false if not
-     */
-    bool areAudioBufferEqual(juce::AudioBuffer<float> &, juce::AudioBuffer<float> &);
+    std::string getTextureKey(std::shared_ptr<SamplePlayer> sp);
 
     /**
      * @brief      Clear all data for this texture id. To be called after
@@ -145,14 +128,10 @@ class TextureManager
      */
     void clearTextureData(GLuint textureId);
 
-    // tells how many textures audio have that length. Used to quickly rule out
-    // that some sample is already stored here.
-    std::map<int, int> texturesLengthCount;
-
     std::set<GLuint> lockedTextures; /**< texture for which count was incremented (eg "locked") */
 
-    // bucket of textures based on their audio left channel hash
-    std::map<size_t, std::vector<GLuint>> texturesPerHash;
+    // texture of each texture key, so that duplicated audio is found without reading it
+    std::unordered_map<std::string, GLuint> texturesPerKey;
 
     std::optional<juce::OpenGLContext *> glContext; /**< A reference to the opengl context where to free textures*/
 
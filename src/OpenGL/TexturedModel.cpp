@@ -17,56 +17,22 @@ void TexturedModel::registerGlObjects()
         return;
     }
 
-    // generate objects
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao);
-
-    // register and upload the vertices data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-    // register and upload indices of the vertices to form the triangles
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * triangleIds.size(), triangleIds.data(),
-                 GL_STATIC_DRAW);
-
-    // register the vertex attribute format
-
-    // position
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-    // color
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // texture
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    GLenum err;
-    while ((err = glGetError()) != GL_NO_ERROR)
-    {
-        std::cerr << "got following open gl error after registering vertices data: " << err << std::endl;
-    }
+    // the vertices go to a slot of the buffers shared by all the samples
+    meshSlot = meshBatch->allocateMesh((int)vertices.size(), (int)triangleIds.size());
+    meshBatch->setMeshVertices(meshSlot, vertices, triangleIds);
 
     if (!reuseTexture)
     {
-        // register the texture
-        glGenTextures(1, &tbo);
-        glBindTexture(GL_TEXTURE_2D, tbo);
-        // set the texture wrapping
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        // set the filtering parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // send the texture to the gpu
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_FLOAT,
-                     texture->data());
-        textureManager->setTexture(tbo, displayedSample, texture);
+        // register the texture, its tiles are only uploaded once they get visible
+        tbo = tileAtlas->registerSpectrogram(texture, textureWidth, textureChannels);
+        textureManager->setTexture(tbo, displayedSample);
     }
+    // the atlas keeps the ffts it builds tiles from, they are not needed here anymore
+    texture = nullptr;
+    meshBatch->setMeshSpectrogram(meshSlot, textureWidth, tileAtlas->getPageTableOffset(tbo),
+                                  tileAtlas->getPageTableWidth(tbo));
 
+    GLenum err;
     while ((err = glGetError()) != GL_NO_ERROR)
     {
         std::cerr << "got following open gl error after uploading texture data: " << err << std::endl;
@@ -75,9 +41,10 @@ void TexturedModel::registerGlObjects()
     loaded = true;
 }
 
-// drawGlObjects will draw the sample. Watch out, it needs to be called
+// drawGlObjects will draw the sample alone. Watch out, it needs to be called
 // from the openGL drawing function of juce OpenGL context. Make sure
-// to use/bind the right shader before calling this.
+// to use/bind the right shader and the atlas textures before calling this.
+// To draw all samples at once, use the SampleMeshBatch instead.
 void TexturedModel::drawGlObjects()
 {
 
@@ -89,16 +56,7 @@ void TexturedModel::drawGlObjects()
         return;
     }
 
-    glActiveTexture(GL_TEXTURE0); // <- might only be necessary on some GPUs
-    glBindTexture(GL_TEXTURE_2D, tbo);
-
-    glBindVertexArray(vao);
-
-    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glDrawElements(GL_TRIANGLES, triangleIds.size(), GL_UNSIGNED_INT, 0);
-
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    meshBatch->drawMesh(meshSlot);
 }
 
 void TexturedModel::disable()
@@ -107,9 +65,8 @@ void TexturedModel::disable()
     {
         const juce::ScopedLock lock(loadingMutex);
         disabled = true;
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &ebo);
+        meshBatch->releaseMesh(meshSlot);
+        meshSlot = -1;
 
         textureManager->decrementUsageCount(tbo);
     }
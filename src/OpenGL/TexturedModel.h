@@ -2,6 +2,8 @@
 #define DEF_TEXTURED_MODEL
 
 #include "GraphicModel.h"
+#include "SampleMeshBatch.h"
+#include "SpectrogramTileAtlas.h"
 #include "TextureManager.h"
 #include <memory>
 
@@ -25,10 +27,15 @@ class TexturedModel : public GraphicModel
   protected:
     int textureWidth;
     int textureHeight;
+    // number of audio channels displayed in the texture
+    int textureChannels;
+    // the fft data the texture tiles are built from, until it is registered in the atlas
     std::shared_ptr<std::vector<float>> texture;
     std::vector<unsigned char> textureBytes;
-    // texture buffer object identifier
+    // texture buffer object identifier (the spectrogram identifier in the tile atlas)
     GLuint tbo;
+    // slot of the mesh in the shared sample mesh batch (or -1)
+    int meshSlot;
 
     // reference to the sample we want to display
     std::shared_ptr<SamplePlayer> displayedSample;
@@ -38,6 +45,12 @@ class TexturedModel : public GraphicModel
     // a shared reference to an object that helps reusing textures so that duplicates
     // or same-file reimport share the same texture.
     juce::SharedResourcePointer<TextureManager> textureManager;
+
+    // the atlas that streams in the tiles of the displayed part of textures
+    juce::SharedResourcePointer<SpectrogramTileAtlas> tileAtlas;
+
+    // the buffers all the samples meshes are drawn from
+    juce::SharedResourcePointer<SampleMeshBatch> meshBatch;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "TimeRangeIndex.h"
+
+#include <algorithm>
+
+TimeRangeIndex::TimeRangeIndex() : numRanges(0)
+{
+}
+
+void TimeRangeIndex::setRange(int id, float start, float end)
+{
+    if (id < 0)
+    {
+        return;
+    }
+
+    if (id >= (int)rangesById.size())
+    {
+        rangesById.resize((size_t)id + 1, {0.0f, 0.0f, 0});
+        presentIds.resize((size_t)id + 1, false);
+    }
+
+    Range &range = rangesById[(size_t)id];
+    bool wasPresent = presentIds[(size_t)id];
+    if (wasPresent && range.start == start && range.end == end)
+    {
+        return;
+    }
+
+    // the highest ends move along with their range so that the unchanged ones can be detected
+    size_t oldIndex = sortedRanges.size();
+    float oldHighestEnd = 0.0f;
+    if (wasPresent)
+    {
+        oldIndex = findSortedIndex(range);
+        oldHighestEnd = highestEnds[oldIndex];
+        sortedRanges.erase(sortedRanges.begin() + (long)oldIndex);
+        highestEnds.erase(highestEnds.begin() + (long)oldIndex);
+    }
+    else
+    {
+        presentIds[(size_t)id] = true;
+        numRanges++;
+    }
+
+    range = {start, end, id};
+    size_t newIndex = findSortedIndex(range);
+    sortedRanges.insert(sortedRanges.begin() + (long)newIndex, range);
+    highestEnds.insert(highestEnds.begin() + (long)newIndex, oldHighestEnd);
+
+    // ranges between the old and the new place gained or lost this one before them
+    size_t firstUnchanged = (wasPresent ? std::max(oldIndex, newIndex) : newIndex) + 1;
+    updateHighestEnds(std::min(oldIndex, newIndex), firstUnchanged);
+}
+
+void TimeRangeIndex::removeRange(int id)
+{
+    if (id < 0 || id >= (int)presentIds.size() || !presentIds[(size_t)id])
+    {
+        return;
+    }
+
+    size_t index = findSortedIndex(rangesById[(size_t)id]);
+    sortedRanges.erase(sortedRanges.begin() + (long)index);
+    highestEnds.erase(highestEnds.begin() + (long)index);
+    updateHighestEnds(index, index);
+
+    presentIds[(size_t)id] = false;
+    numRanges--;
+}
+
+int TimeRangeIndex::size() const
+{
+    return numRanges;
+}
+
+bool TimeRangeIndex::isSortedBefore(const Range &a, const Range &b)
+{
+    return a.start < b.start || (a.start == b.start && a.id < b.id);
+}
+
+size_t TimeRangeIndex::findSortedIndex(const Range &range) const
+{
+    return (size_t)(std::lower_bound(sortedRanges.begin(), sortedRanges.end(), range, isSortedBefore) -
+                    sortedRanges.begin());
+}
+
+void TimeRangeIndex::updateHighestEnds(size_t from, size_t firstUnchanged)
+{
+    // the highest end never decreases along the sorted ranges, so it can be binary searched
+    for (size_t i = from; i < sortedRanges.size(); i++)
+    {
+        float highestEnd = i == 0 ? sortedRanges[i].end : std::max(highestEnds[i - 1], sortedRanges[i].end);
+        // after the modified ranges, the following ones depend only on this value
+        if (i >= firstUnchanged && highestEnds[i] == highestEnd)
+        {
+            return;
+        }
+        highestEnds[i] = highestEnd;
+    }
+}
+
+void TimeRangeIndex::findOverlapping(float start, float end, std::vector<int> &ids)
+{
+    ids.clear();
+
+    // ranges before this one all end before the searched start
+    size_t firstCandidate = (size_t)(std::lower_bound(highestEnds.begin(), highestEnds.end(), start) -
+                                     highestEnds.begin());
+    // ranges from this one all start after the searched end
+    size_t lastCandidate = (size_t)(std::upper_bound(sortedRanges.begin(), sortedRanges.end(), end,
+                                                     [](float value, const Range &r) { return value < r.start; }) -
+                                    sortedRanges.begin());
+
+    for (size_t i = firstCandidate; i < lastCandidate; i++)
+    {
+        if (sortedRanges[i].end >= start)
+        {
+            ids.push_back(sortedRanges[i].id);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef DEF_TIME_RANGE_INDEX_HPP
+#define DEF_TIME_RANGE_INDEX_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief      Finds which of a set of time ranges overlap a given range, without
+ *             looking at all of them. Ranges are kept sorted by start along with the
+ *             highest end of all the ranges before each one, so that a query is two
+ *             binary searches and a scan of the candidates. The sorted arrays are updated
+ *             in place: a change moves one range and recomputes the highest ends only
+ *             until they are the same as before, so that dragging samples stays cheap.
+ *             Ranges are identified by small positive integers, like mesh slots.
+ */
+class TimeRangeIndex
+{
+  public:
+    TimeRangeIndex();
+
+    /**
+     * @brief      Adds a range or moves an existing one.
+     *
+     * @param[in]  id     The range identifier
+     * @param[in]  start  The start of the range
+     * @param[in]  end    The end of the range
+     */
+    void setRange(int id, float start, float end);
+
+    /**
+     * @brief      Removes a range. Does nothing if it doesn't exists.
+     */
+    void removeRange(int id);
+
+    /**
+     * @brief      Lists the ranges overlapping [start, end], bounds included.
+     *
+     * @param[in]  start  The start of the searched range
+     * @param[in]  end    The end of the searched range
+     * @param      ids    The vector the identifiers are written to, in no particular order.
+     */
+    void findOverlapping(float start, float end, std::vector<int> &ids);
+
+    /**
+     * @brief      Gets the number of ranges in the index.
+     */
+    int size() const;
+
+  private:
+    struct Range
+    {
+        float start;
+        float end;
+        int id;
+    };
+
+    /**
+     * @brief      Order of the sorted ranges. The identifier breaks ties so that each range
+     *             has a single place in them.
+     */
+    static bool isSortedBefore(const Range &a, const Range &b);
+
+    /**
+     * @brief      Gets the index of a range of the index in the sorted ranges.
+     */
+    size_t findSortedIndex(const Range &range) const;
+
+    /**
+     * @brief      Recomputes the running highest ends from an index of the sorted ranges.
+     *
+     * @param[in]  from            The first index to recompute
+     * @param[in]  firstUnchanged  The index from which the ranges before each one are the same as before
+     *                             the change, so that we can stop at the first highest end that didn't change.
+     */
+    void updateHighestEnds(size_t from, size_t firstUnchanged);
+
+    // range of each identifier, and if it is in the index
+    std::vector<Range> rangesById;
+    std::vector<bool> presentIds;
+    int numRanges;
+
+    // ranges sorted by start then identifier, and the highest end up to each of them
+    std::vector<Range> sortedRanges;
+    std::vector<float> highestEnds;
+};
+
+#endif // DEF_TIME_RANGE_INDEX_HPP
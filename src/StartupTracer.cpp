@@ -0,0 +1,153 @@
+#include "StartupTracer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+StartupTracer::StartupTracer()
+    : originMs(juce::Time::getMillisecondCounterHiRes()), firstFrameMs(0.0), firstFrameShown(false),
+      startupDoneMs(0.0), startupDone(false)
+{
+}
+
+double StartupTracer::getElapsedMs() const
+{
+    return juce::Time::getMillisecondCounterHiRes() - originMs;
+}
+
+void StartupTracer::addPhase(const std::string &name, double startMs, double endMs)
+{
+    std::scoped_lock<std::mutex> lock(eventsMutex);
+    // later phases, like the ones of a new OpenGL context, are not part of the startup
+    if (startupDone)
+    {
+        return;
+    }
+    events.push_back({name, startMs, endMs - startMs, getThreadIndex()});
+}
+
+void StartupTracer::setTraceFile(const juce::File &file)
+{
+    std::scoped_lock<std::mutex> lock(eventsMutex);
+    traceFile = file;
+}
+
+void StartupTracer::markFirstFrame()
+{
+    std::scoped_lock<std::mutex> lock(eventsMutex);
+    if (firstFrameShown)
+    {
+        return;
+    }
+    firstFrameShown = true;
+    firstFrameMs = getElapsedMs();
+
+    std::cerr << "First frame shown " << firstFrameMs << " ms after startup:" << std::endl;
+    logPhases(0.0, firstFrameMs);
+}
+
+bool StartupTracer::isFirstFrameShown()
+{
+    std::scoped_lock<std::mutex> lock(eventsMutex);
+    return firstFrameShown;
+}
+
+void StartupTracer::markStartupDone()
+{
+    std::scoped_lock<std::mutex> lock(eventsMutex);
+    if (startupDone)
+    {
+        return;
+    }
+    startupDone = true;
+    startupDoneMs = getElapsedMs();
+
+    std::cerr << "Lazy initializations done " << startupDoneMs << " ms after startup:" << std::endl;
+    logPhases(firstFrameMs, startupDoneMs);
+
+    writeTrace();
+}
+
+void StartupTracer::logPhases(double fromMs, double toMs)
+{
+    std::vector<StartupTraceEvent> sortedEvents;
+    std::copy_if(events.begin(), events.end(), std::back_inserter(sortedEvents),
+                 [fromMs, toMs](const StartupTraceEvent &event) {
+                     double endMs = event.startMs + event.durationMs;
+                     return endMs > fromMs && endMs <= toMs;
+                 });
+    std::sort(sortedEvents.begin(), sortedEvents.end(),
+              [](const StartupTraceEvent &a, const StartupTraceEvent &b) { return a.startMs < b.startMs; });
+    for (const StartupTraceEvent &event : sortedEvents)
+    {
+        std::cerr << "    " << event.name << ": " << event.durationMs << " ms (thread " << event.thread << ")"
+                  << std::endl;
+    }
+}
+
+int StartupTracer::getThreadIndex()
+{
+    auto it = std::find(threads.begin(), threads.end(), std::this_thread::get_id());
+    if (it != threads.end())
+    {
+        return int(it - threads.begin());
+    }
+    threads.push_back(std::this_thread::get_id());
+    return int(threads.size() - 1);
+}
+
+void StartupTracer::writeTrace()
+{
+    if (traceFile == juce::File())
+    {
+        return;
+    }
+
+    // see the "Trace Event Format" document for the meaning of the fields, times are in microseconds
+    juce::Array<juce::var> traceEvents;
+    for (const StartupTraceEvent &event : events)
+    {
+        juce::DynamicObject::Ptr traceEvent = new juce::DynamicObject();
+        traceEvent->setProperty("name", juce::String(event.name));
+        traceEvent->setProperty("cat", "startup");
+        traceEvent->setProperty("ph", "X");
+        traceEvent->setProperty("ts", event.startMs * 1000.0);
+        traceEvent->setProperty("dur", event.durationMs * 1000.0);
+        traceEvent->setProperty("pid", 1);
+        traceEvent->setProperty("tid", event.thread);
+        traceEvents.add(juce::var(traceEvent.get()));
+    }
+
+    std::pair<const char *, double> instants[] = {{"first frame", firstFrameMs}, {"startup done", startupDoneMs}};
+    for (auto &instant : instants)
+    {
+        juce::DynamicObject::Ptr instantEvent = new juce::DynamicObject();
+        instantEvent->setProperty("name", instant.first);
+        instantEvent->setProperty("cat", "startup");
+        instantEvent->setProperty("ph", "i");
+        instantEvent->setProperty("s", "g");
+        instantEvent->setProperty("ts", instant.second * 1000.0);
+        instantEvent->setProperty("pid", 1);
+        instantEvent->setProperty("tid", 0);
+        traceEvents.add(juce::var(instantEvent.get()));
+    }
+
+    juce::DynamicObject::Ptr trace = new juce::DynamicObject();
+    trace->setProperty("traceEvents", traceEvents);
+    trace->setProperty("displayTimeUnit", "ms");
+
+    if (traceFile.getParentDirectory().createDirectory().failed() ||
+        !traceFile.replaceWithText(juce::JSON::toString(juce::var(trace.get()))))
+    {
+        std::cerr << "Unable to write the startup trace to " << traceFile.getFullPathName() << std::endl;
+    }
+}
+
+StartupPhase::StartupPhase(std::string n) : name(std::move(n)), startMs(tracer->getElapsedMs())
+{
+}
+
+StartupPhase::~StartupPhase()
+{
+    tracer->addPhase(name, startMs, tracer->getElapsedMs());
+}
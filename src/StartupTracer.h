@@ -0,0 +1,116 @@
+#ifndef DEF_STARTUP_TRACER_HPP
+#define DEF_STARTUP_TRACER_HPP
+
+#include <juce_core/juce_core.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**< Name of the startup trace file in the config folder */
+#define STARTUP_TRACE_FILE "startup_trace.json"
+
+/**
+ * @brief A phase of the startup, with its times in milliseconds since the tracer was created.
+ */
+struct StartupTraceEvent
+{
+    std::string name;
+    double startMs;
+    double durationMs;
+    int thread; /**< index of the thread in the order threads recorded their first phase */
+};
+
+/**
+ * @brief Records how long each phase of the startup takes, from the app creation up to the
+ *        first frame shown and the subsystems initialized lazily after it.
+ *        The phases are written to a trace file in the Chrome trace event format, that
+ *        chrome://tracing or https://ui.perfetto.dev can open. The file is written once, when
+ *        the lazy initializations are done, and no phase is recorded after that.
+ *        It is meant to be used as a global static instance through juce::SharedResourcePointer,
+ *        and can be used from any thread.
+ */
+class StartupTracer
+{
+  public:
+    StartupTracer();
+
+    /**
+     * @brief Gets the time elapsed since the tracer was created.
+     */
+    double getElapsedMs() const;
+
+    /**
+     * @brief Records a phase of the calling thread.
+     *
+     * @param name     The name displayed for the phase
+     * @param startMs  The start of the phase, from getElapsedMs
+     * @param endMs    The end of the phase, from getElapsedMs
+     */
+    void addPhase(const std::string &name, double startMs, double endMs);
+
+    /**
+     * @brief Sets the file the trace is written to. Nothing is written while it's not set.
+     */
+    void setTraceFile(const juce::File &file);
+
+    /**
+     * @brief Records that the first frame was shown and logs how long each phase took.
+     *        Only the first call does something.
+     */
+    void markFirstFrame();
+    bool isFirstFrameShown();
+
+    /**
+     * @brief Records that the lazy initializations are done, logs how long they took, writes the trace
+     *        and stops recording phases. Only the first call does something.
+     */
+    void markStartupDone();
+
+  private:
+    /**
+     * @brief Gets the index of the calling thread. eventsMutex must be held.
+     */
+    int getThreadIndex();
+
+    /**
+     * @brief Logs the phases that ended in a time range, by start time. eventsMutex must be held.
+     */
+    void logPhases(double fromMs, double toMs);
+
+    /**
+     * @brief Writes the trace file. eventsMutex must be held.
+     */
+    void writeTrace();
+
+    double originMs;
+    std::vector<StartupTraceEvent> events;
+    std::vector<std::thread::id> threads;
+    double firstFrameMs;
+    bool firstFrameShown;
+    double startupDoneMs;
+    bool startupDone;
+    juce::File traceFile;
+    std::mutex eventsMutex;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StartupTracer)
+};
+
+/**
+ * @brief Records a startup phase that lasts as long as the object lives.
+ */
+class StartupPhase
+{
+  public:
+    explicit StartupPhase(std::string name);
+    ~StartupPhase();
+
+  private:
+    juce::SharedResourcePointer<StartupTracer> tracer;
+    std::string name;
+    double startMs;
+
+    JUCE_DECLARE_NON_COPYABLE(StartupPhase)
+};
+
+#endif // DEF_STARTUP_TRACER_HPP
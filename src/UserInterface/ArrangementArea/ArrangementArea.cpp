@@ -10,6 +10,7 @@
 
 #include "../../Arrangement/ColorPalette.h"
 #include "../../Arrangement/NumericInputId.h"
+#include "../../LazyInit.h"
 #include "../../OpenGL/FreqviewShaders.h"
 #include "../../OpenGL/GLInfoLogger.h"
 #include "juce_opengl/opengl/juce_gl.h"
@@ -41,10 +42,31 @@ ArrangementArea::ArrangementArea(MixingBus &mb, ActivityManager &am)
 
     shadersCompiled = false;
 
+    sceneUniformsChanged = true;
+
+    spectrogramMinDb = MIN_DB;
+    spectrogramMaxDb = MAX_DB;
+    spectrogramColormap = false;
+
+    renderStatsFrames = 0;
+    renderStatsSampleLayerFrames = 0;
+    renderStatsMs = 0;
+    perfOverlayVisible = false;
+    firstFrameRendered = false;
+
+    labelsLayoutValid = false;
+    labelsViewPosition = 0;
+    labelsViewScale = 0;
+    labelsViewWidth = 0;
+    labelsViewHeight = 0;
+
     // Indicates that no part of this Component is transparent.
     setOpaque(true);
 
     openGLContext.setRenderer(this);
+    // only render when something changed: component repaints (play cursor, selection, labels...),
+    // and work sent with executeOnGLThread (view, vertices and texture updates) all trigger a frame.
+    openGLContext.setContinuousRepainting(false);
     openGLContext.attachTo(*this);
 
     textureManager->setOpenGlContext(&openGLContext);
@@ -76,6 +98,11 @@ void ArrangementArea::resetArrangement()
     copyAndBroadcastSelection(true);
 
     samples.clear();
+    {
+        const juce::ScopedLock lock(sampleSpatialIndexMutex);
+        sampleSpatialIndex.clear();
+    }
+    labelsLayoutValid = false;
 }
 
 void ArrangementArea::viewPositionUpdateCallback()
@@ -110,7 +137,7 @@ void ArrangementArea::paint(juce::Graphics &g)
 
 void ArrangementArea::paintOverChildren(juce::Graphics &g)
 {
-    paintLabels(g);
+    updateLabels();
     paintSelectionArea(g);
     paintPlayCursor(g);
 }
@@ -162,6 +189,9 @@ void ArrangementArea::paintSelection(juce::Graphics &g)
 
 bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
 {
+    // tasks can rename, recolor or move samples
+    labelsLayoutValid = false;
+
     std::shared_ptr<SampleDisplayTask> sc = std::dynamic_pointer_cast<SampleDisplayTask>(task);
     if (sc != nullptr && !sc->isCompleted() && !sc->hasFailed())
     {
@@ -173,6 +203,10 @@ bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
     if (disableTask != nullptr && !disableTask->isCompleted() && !disableTask->hasFailed())
     {
         samples[(size_t)disableTask->id]->disable();
+        {
+            const juce::ScopedLock lock(sampleSpatialIndexMutex);
+            sampleSpatialIndex.removeSample(disableTask->id);
+        }
 
         if (selectedTracks.find((size_t)disableTask->id) != selectedTracks.end())
         {
@@ -198,6 +232,7 @@ bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
         openGLContext.executeOnGLThread(
             [this, restoreTask](juce::OpenGLContext &) { samples[(size_t)restoreTask->id]->registerGlObjects(); },
             true);
+        updateSampleSpatialIndex(restoreTask->id);
 
         // we will repaint to display the sample again
         repaint();
@@ -213,6 +248,7 @@ bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
                 samples[(size_t)updateTask->id]->reloadSampleData(updateTask->sample);
             },
             true);
+        updateSampleSpatialIndex(updateTask->id);
 
         updateTask->setCompleted(true);
         updateTask->setFailed(false);
@@ -258,6 +294,7 @@ bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
                 samples[(size_t)fadeChange->sampleId]->reloadSampleData(mixingBus.getTrack(fadeChange->sampleId));
             },
             true);
+        updateSampleSpatialIndex(fadeChange->sampleId);
 
         return false;
     }
@@ -272,6 +309,7 @@ bool ArrangementArea::taskHandler(std::shared_ptr<Task> task)
                     mixingBus.getTrack(filterRepChange->sampleId));
             },
             true);
+        updateSampleSpatialIndex(filterRepChange->sampleId);
 
         return false;
     }
@@ -448,7 +486,37 @@ juce::Optional<SampleBorder> ArrangementArea::mouseOverSelectionBorder()
     return juce::Optional<SampleBorder>(juce::nullopt);
 }
 
-void ArrangementArea::paintLabels(juce::Graphics &g)
+void ArrangementArea::updateLabels()
+{
+    int viewPosition = viewPositionManager->getViewPosition();
+    int viewScale = viewPositionManager->getViewScale();
+
+    bool viewChanged = viewPosition != labelsViewPosition || viewScale != labelsViewScale ||
+                       bounds.getWidth() != labelsViewWidth || bounds.getHeight() != labelsViewHeight;
+    if (!labelsLayoutValid || viewChanged)
+    {
+        placeLabels();
+        labelsLayoutValid = true;
+        labelsViewPosition = viewPosition;
+        labelsViewScale = viewScale;
+        labelsViewWidth = bounds.getWidth();
+        labelsViewHeight = bounds.getHeight();
+    }
+
+    // the selection and colors are cheap to follow, so the labels are rebuilt each time but only sent
+    // to the GPU when they changed
+    labelBatch.clear();
+    for (size_t i = 0; i < onScreenLabelsPixelsCoords.size(); i++)
+    {
+        addSampleLabel(onScreenLabelsPixelsCoords[i], onScreenLabelsPixelsCoords[i].getSampleIndex());
+    }
+    if (labelBatch.submit())
+    {
+        openGLContext.triggerRepaint();
+    }
+}
+
+void ArrangementArea::placeLabels()
 {
     // prefix notes:
     // Frame: coordinates in global audio frames position
@@ -456,8 +524,7 @@ void ArrangementArea::paintLabels(juce::Graphics &g)
 
     // clear the list of previous labels (to be later swapped)
     onScreenLabelsPixelsCoordsBuffer.clear();
-
-    SampleAreaRectangle currentLabelPixelsCoords;
+    labelRows.clear();
 
     int currentSampleLeftSideFrame, currentSampleRightSideFrame;
 
@@ -467,8 +534,12 @@ void ArrangementArea::paintLabels(juce::Graphics &g)
     int viewLeftMostFrame = viewPosition;
     int viewRightMostFrame = viewPosition + (bounds.getWidth() * viewScale);
 
-    for (size_t i = 0; i < samples.size(); i++)
+    sampleSpatialIndex.findSamples(float(viewLeftMostFrame), float(viewRightMostFrame), spatialQueryIds);
+
+    for (size_t k = 0; k < spatialQueryIds.size(); k++)
     {
+        size_t i = (size_t)spatialQueryIds[k];
+
         if (samples[i]->isDisabled())
         {
             continue;
@@ -490,13 +561,9 @@ void ArrangementArea::paintLabels(juce::Graphics &g)
             }
 
             // translate into pixel coordinates and prevent position conflicts
-            currentLabelPixelsCoords = addLabelAndPreventOverlaps(
-                onScreenLabelsPixelsCoordsBuffer, (currentSampleLeftSideFrame - viewPosition) / viewScale,
-                (currentSampleRightSideFrame - viewPosition) / viewScale, i);
-            if (currentLabelPixelsCoords.getSampleIndex() != -1)
-            {
-                paintSampleLabel(g, currentLabelPixelsCoords, i);
-            }
+            addLabelAndPreventOverlaps(onScreenLabelsPixelsCoordsBuffer,
+                                       (currentSampleLeftSideFrame - viewPosition) / viewScale,
+                                       (currentSampleRightSideFrame - viewPosition) / viewScale, i);
         }
     }
 
@@ -516,7 +583,7 @@ SampleAreaRectangle ArrangementArea::addLabelAndPreventOverlaps(std::vector<Samp
     pixelLabelRect.setHeight(FREQVIEW_LABEL_HEIGHT);
 
     // reduce the width if there's unused space
-    int textPixelWidth = juce::Font().getStringWidth(taxonomyManager.getSampleName(sampleIndex));
+    float textPixelWidth = labelBatch.getTextWidth(juce::String(taxonomyManager.getSampleName(sampleIndex)));
     if (pixelLabelRect.getWidth() > textPixelWidth + FREQVIEW_LABELS_MARGINS * 2 + pixelLabelRect.getHeight())
     {
         pixelLabelRect.setWidth(textPixelWidth + FREQVIEW_LABELS_MARGINS * 2 + pixelLabelRect.getHeight());
@@ -526,19 +593,24 @@ SampleAreaRectangle ArrangementArea::addLabelAndPreventOverlaps(std::vector<Samp
 
     // we will keep moving it untill there's no overlap to other labels
     // and it lies over its samples area
+    // labels are placed in rows of their height going away from the middle of the view, so
+    // they can only overlap the ones of the same row
     float origin = float(bounds.getHeight() >> 1);
+    int row = 0;
     pixelLabelRect.setY(origin - (FREQVIEW_LABEL_HEIGHT >> 1));
     int trials = 0;
-    while (rectangleIntersects(pixelLabelRect, existingLabels) || !overlapSampleArea(pixelLabelRect, sampleIndex, 4))
+    while (labelRowIntersects(row, pixelLabelRect.getX(), pixelLabelRect.getRight()) ||
+           !overlapSampleArea(pixelLabelRect, sampleIndex, 4))
     {
         if (trials % 2 == 0)
         {
-            pixelLabelRect.setY(origin + ((trials >> 1) + 1) * FREQVIEW_LABEL_HEIGHT - (FREQVIEW_LABEL_HEIGHT >> 1));
+            row = (trials >> 1) + 1;
         }
         else
         {
-            pixelLabelRect.setY(origin - ((trials >> 1) + 1) * FREQVIEW_LABEL_HEIGHT - (FREQVIEW_LABEL_HEIGHT >> 1));
+            row = -((trials >> 1) + 1);
         }
+        pixelLabelRect.setY(origin + row * FREQVIEW_LABEL_HEIGHT - (FREQVIEW_LABEL_HEIGHT >> 1));
         trials++;
 
         if (trials >= maxTrials)
@@ -557,19 +629,26 @@ SampleAreaRectangle ArrangementArea::addLabelAndPreventOverlaps(std::vector<Samp
     // add and return new label with no overlap
     pixelLabelRect.setSampleIndex(sampleIndex);
     existingLabels.push_back(pixelLabelRect);
+    labelRows[row][pixelLabelRect.getX()] = pixelLabelRect.getRight();
     return pixelLabelRect;
 }
 
-bool ArrangementArea::rectangleIntersects(SampleAreaRectangle &target, std::vector<SampleAreaRectangle> &rectangles)
+bool ArrangementArea::labelRowIntersects(int row, float left, float right)
 {
-    for (size_t i = 0; i < rectangles.size(); i++)
+    auto rowLabels = labelRows.find(row);
+    if (rowLabels == labelRows.end() || right <= left)
     {
-        if (target.intersects(rectangles[i]))
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+
+    // labels of a row don't overlap, so only the last one starting before the right side can
+    auto previousLabel = rowLabels->second.lower_bound(right);
+    if (previousLabel == rowLabels->second.begin())
+    {
+        return false;
+    }
+    previousLabel--;
+    return previousLabel->second > left;
 }
 
 bool ArrangementArea::overlapSampleArea(SampleAreaRectangle &rect, int sampleIndex, int margin)
@@ -590,43 +669,32 @@ bool ArrangementArea::overlapSampleArea(SampleAreaRectangle &rect, int sampleInd
     return false;
 }
 
-void ArrangementArea::paintSampleLabel(juce::Graphics &g, juce::Rectangle<float> &box, int index)
+void ArrangementArea::addSampleLabel(juce::Rectangle<float> &box, int index)
 {
     bool selected = selectedTracks.find((size_t)index) != selectedTracks.end();
 
     // different border width depending on if selected or not
     if (selected)
     {
-        g.setColour(juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.75f));
-        g.fillRoundedRectangle(box, FREQVIEW_LABELS_CORNER_ROUNDING);
-        g.setColour(COLOR_LABELS_BORDER);
-        g.drawRoundedRectangle(box, FREQVIEW_LABELS_CORNER_ROUNDING, FREQVIEW_LABELS_BORDER_THICKNESS);
+        labelBatch.addBox(box, juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.75f), FREQVIEW_LABELS_CORNER_ROUNDING);
+        labelBatch.addBorder(box, COLOR_LABELS_BORDER, FREQVIEW_LABELS_CORNER_ROUNDING,
+                             FREQVIEW_LABELS_BORDER_THICKNESS);
     }
     else
     {
-        g.setColour(juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.55f));
-        g.fillRoundedRectangle(box, FREQVIEW_LABELS_CORNER_ROUNDING);
-        g.setColour(COLOR_LABELS_BORDER.withAlpha(0.8f));
-        g.drawRoundedRectangle(box, FREQVIEW_LABELS_CORNER_ROUNDING, FREQVIEW_LABELS_BORDER_THICKNESS / 2.0f);
+        labelBatch.addBox(box, juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.55f), FREQVIEW_LABELS_CORNER_ROUNDING);
+        labelBatch.addBorder(box, COLOR_LABELS_BORDER.withAlpha(0.8f), FREQVIEW_LABELS_CORNER_ROUNDING,
+                             FREQVIEW_LABELS_BORDER_THICKNESS / 2.0f);
     }
 
     auto reducedBox = box.reduced(FREQVIEW_LABELS_MARGINS, FREQVIEW_LABELS_MARGINS);
 
-    g.setColour(taxonomyManager.getSampleColor(index));
-    g.fillRect(reducedBox.withWidth(box.getHeight() - FREQVIEW_LABELS_MARGINS));
+    labelBatch.addBox(reducedBox.withWidth(box.getHeight() - FREQVIEW_LABELS_MARGINS),
+                      taxonomyManager.getSampleColor(index), 0.0f);
 
-    if (selected)
-    {
-        g.setColour(COLOR_LABELS_BORDER);
-    }
-    else
-    {
-        g.setColour(COLOR_LABELS_BORDER.withAlpha(0.8f));
-    }
-
-    g.drawText(taxonomyManager.getSampleName(index),
-               reducedBox.translated(box.getHeight(), 0).withWidth(reducedBox.getWidth() - box.getHeight()),
-               juce::Justification::centredLeft, true);
+    labelBatch.addText(juce::String(taxonomyManager.getSampleName(index)),
+                       reducedBox.translated(box.getHeight(), 0).withWidth(reducedBox.getWidth() - box.getHeight()),
+                       selected ? COLOR_LABELS_BORDER : COLOR_LABELS_BORDER.withAlpha(0.8f));
 }
 
 void ArrangementArea::resized()
@@ -644,20 +712,45 @@ void ArrangementArea::resized()
 
 void ArrangementArea::newOpenGLContextCreated()
 {
+    StartupPhase phase("OpenGL context creation");
     std::cerr << "Initializing OpenGL context..." << std::endl;
     // Instanciate an instance of OpenGLShaderProgram
     texturedPositionedShader.reset(new juce::OpenGLShaderProgram(openGLContext));
     backgroundGridShader.reset(new juce::OpenGLShaderProgram(openGLContext));
+    labelShader.reset(new juce::OpenGLShaderProgram(openGLContext));
     // Compile and link the shader
-    if (buildAllShaders())
+    shaderProgramCache.resetStats();
+    bool shadersBuilt;
+    {
+        StartupPhase shadersPhase("shaders build");
+        shadersBuilt = buildAllShaders();
+    }
+    if (shadersBuilt)
     {
         shadersCompiled = true;
 
-        std::cerr << "Sucessfully compiled OpenGL shaders" << std::endl;
+        std::cerr << "Sucessfully built " << shaderProgramCache.getBuiltProgramsCount() << " OpenGL shader programs in "
+                  << shaderProgramCache.getBuildMs() << " ms, " << shaderProgramCache.getLoadedProgramsCount()
+                  << " of them loaded from the binary cache instead of being compiled in "
+                  << shaderProgramCache.getCompileMsOfLoadedPrograms() << " ms" << std::endl;
 
         texturedPositionedShader->use();
         texturedPositionedShader->setUniform("ourTexture", 0);
         texturedPositionedShader->setUniform("alphaMask", 1);
+        texturedPositionedShader->setUniform("pageTables", 2);
+        texturedPositionedShader->setUniform("meshData", 3);
+        texturedPositionedShader->setUniform("colormap", 4);
+        texturedPositionedShader->setUniform("tileSize", (GLfloat)SPECTROGRAM_TILE_WIDTH,
+                                             (GLfloat)SPECTROGRAM_TILE_HEIGHT);
+        texturedPositionedShader->setUniform("spectrogramRows", (GLfloat)(2 * FFT_STORAGE_SCOPE_SIZE));
+        // the shader applies UnitConverter::zoomInRangeInv, so the knee goes from the output to the input ratio
+        texturedPositionedShader->setUniform("lensKnee", POLYLENS_KNEE_OUTPUT, POLYLENS_KNEE_INPUT);
+        updateShadersDisplayUniforms();
+        meshBatch->setVerticesPerMeshUniformLocation(
+            texturedPositionedShader->getUniformIDFromName("verticesPerMesh"));
+
+        labelShader->use();
+        labelShader->setUniform("glyphAtlas", 5);
 
         shaderUniformUpdateThreadWrapper(true);
 
@@ -669,6 +762,7 @@ void ArrangementArea::newOpenGLContextCreated()
 
         // load the alpha mask texture into the main shader
         alphaMaskTextureLoader.loadTexture();
+        colormapTextureLoader.loadTexture();
 
         // initialize background openGL objects
         backgroundGrid.registerGlObjects();
@@ -682,26 +776,33 @@ void ArrangementArea::newOpenGLContextCreated()
 
 bool ArrangementArea::buildAllShaders()
 {
-    bool builtTexturedShader = buildShader(texturedPositionedShader, sampleVertexShader, sampleFragmentShader);
+    bool builtTexturedShader =
+        buildShader(texturedPositionedShader, "sample", sampleVertexShader, sampleFragmentShader);
     if (!builtTexturedShader)
     {
         std::cerr << "Failed to build textured positioned shaders" << std::endl;
         return false;
     }
     bool builtColoredShader =
-        buildShader(backgroundGridShader, gridBackgroundVertexShader, gridBackgroundFragmentShader);
+        buildShader(backgroundGridShader, "grid", gridBackgroundVertexShader, gridBackgroundFragmentShader);
     if (!builtColoredShader)
     {
         std::cerr << "Failed to build coloured positioned shaders" << std::endl;
         return false;
     }
+    bool builtLabelShader = buildShader(labelShader, "label", labelVertexShader, labelFragmentShader);
+    if (!builtLabelShader)
+    {
+        std::cerr << "Failed to build label shaders" << std::endl;
+        return false;
+    }
     return true;
 }
 
-bool ArrangementArea::buildShader(std::unique_ptr<juce::OpenGLShaderProgram> &sh, std::string vertexShader,
-                                  std::string fragmentShader)
+bool ArrangementArea::buildShader(std::unique_ptr<juce::OpenGLShaderProgram> &sh, std::string name,
+                                  std::string vertexShader, std::string fragmentShader)
 {
-    return sh->addVertexShader(vertexShader) && sh->addFragmentShader(fragmentShader) && sh->link();
+    return shaderProgramCache.buildProgram(*sh, name, vertexShader, fragmentShader);
 }
 
 void ArrangementArea::shaderUniformUpdateThreadWrapper(bool fromGlThread)
@@ -740,6 +841,30 @@ void ArrangementArea::updateShadersViewAndGridUniforms()
     backgroundGridShader->setUniform("grid2PixelWidth", (GLfloat)grid2PixelWidth);
 
     backgroundGridShader->setUniform("viewHeightPixels", (GLfloat)(bounds.getHeight()));
+
+    sceneUniformsChanged = true;
+}
+
+void ArrangementArea::updateShadersDisplayUniforms()
+{
+    texturedPositionedShader->use();
+    texturedPositionedShader->setUniform("dbRange", (GLfloat)spectrogramMinDb, (GLfloat)spectrogramMaxDb);
+    texturedPositionedShader->setUniform("useColormap", (GLint)(spectrogramColormap ? 1 : 0));
+
+    sceneUniformsChanged = true;
+}
+
+void ArrangementArea::setSpectrogramDisplay(float minDb, float maxDb, bool colormap)
+{
+    spectrogramMinDb = minDb;
+    spectrogramMaxDb = maxDb;
+    spectrogramColormap = colormap;
+
+    // if the context is not created yet, the settings are sent once it is
+    if (shadersCompiled)
+    {
+        openGLContext.executeOnGLThread([this](juce::OpenGLContext &) { updateShadersDisplayUniforms(); }, false);
+    }
 }
 
 void ArrangementArea::computeShadersGridUniformsVars()
@@ -764,6 +889,109 @@ void ArrangementArea::computeShadersGridUniformsVars()
 }
 
 void ArrangementArea::renderOpenGL()
+{
+    double renderStartMs = juce::Time::getMillisecondCounterHiRes();
+    frameProfiler.beginFrame();
+
+    int layerWidth = juce::roundToInt(openGLContext.getRenderingScale() * getWidth());
+    int layerHeight = juce::roundToInt(openGLContext.getRenderingScale() * getHeight());
+
+    // the sample layer is only rendered again when what it shows changed, so that frames where only the
+    // components painted on top changed (like the play cursor) don't depend on the number of samples.
+    bool layerResized = !sampleLayer.isValid() || sampleLayer.getWidth() != layerWidth ||
+                        sampleLayer.getHeight() != layerHeight;
+    if (layerResized)
+    {
+        sampleLayer.release();
+        if (!sampleLayer.initialise(openGLContext, layerWidth, layerHeight))
+        {
+            std::cerr << "Unable to allocate the sample layer framebuffer" << std::endl;
+        }
+    }
+
+    bool sampleLayerRendered = false;
+    if (layerResized || sceneUniformsChanged || meshBatch->hasPendingChanges() || tileAtlas->hasPendingTiles())
+    {
+        sampleLayer.makeCurrentRenderingTarget();
+        renderSampleLayer();
+        sampleLayer.releaseAsRenderingTarget();
+        sceneUniformsChanged = false;
+        sampleLayerRendered = true;
+    }
+
+    // copy the sample layer to the screen, the components are composited on top of it afterwards
+    frameProfiler.beginPass(FRAME_PASS_OVERLAYS);
+    GLint screenFrameBuffer = 0;
+    juce::gl::glGetIntegerv(juce::gl::GL_DRAW_FRAMEBUFFER_BINDING, &screenFrameBuffer);
+    juce::gl::glBindFramebuffer(juce::gl::GL_READ_FRAMEBUFFER, sampleLayer.getFrameBufferID());
+    juce::gl::glBlitFramebuffer(0, 0, layerWidth, layerHeight, 0, 0, layerWidth, layerHeight,
+                                juce::gl::GL_COLOR_BUFFER_BIT, juce::gl::GL_NEAREST);
+    juce::gl::glBindFramebuffer(juce::gl::GL_FRAMEBUFFER, (GLuint)screenFrameBuffer);
+    juce::gl::glViewport(0, 0, layerWidth, layerHeight);
+
+    // the labels are drawn over the sample layer, and under the components
+    juce::gl::glEnable(juce::gl::GL_BLEND);
+    juce::gl::glBlendFunc(juce::gl::GL_SRC_ALPHA, juce::gl::GL_ONE_MINUS_SRC_ALPHA);
+    labelShader->use();
+    labelBatch.draw(*labelShader, getWidth(), getHeight());
+    int drawCalls = labelBatch.getLastDrawCallsCount();
+    if (perfOverlayVisible)
+    {
+        drawPerfOverlay();
+        drawCalls += perfOverlayBatch.getLastDrawCallsCount();
+    }
+    frameProfiler.endPass();
+
+    // keep rendering while the visible tiles are streamed in
+    if (tileAtlas->hasPendingTiles())
+    {
+        openGLContext.triggerRepaint();
+    }
+
+    // NOTE: this is the CPU time spent submitting the frame, the GPU work is not waited for
+    double renderMs = juce::Time::getMillisecondCounterHiRes() - renderStartMs;
+    size_t uploadedBytes = meshBatch->takeUploadedBytes() + tileAtlas->takeUploadedBytes() +
+                           labelBatch.takeUploadedBytes() + perfOverlayBatch.takeUploadedBytes();
+    if (frameProfiler.isEnabled())
+    {
+        if (sampleLayerRendered)
+        {
+            // the background grid and the samples
+            drawCalls += 1 + meshBatch->getLastDrawCallsCount();
+        }
+        frameProfiler.endFrame(renderMs, drawCalls, tileAtlas->getUsedMemory(), uploadedBytes);
+
+        // the rendering statistics are only logged while profiling
+        renderStatsMs += renderMs;
+        renderStatsFrames++;
+        if (sampleLayerRendered)
+        {
+            renderStatsSampleLayerFrames++;
+        }
+        if (renderStatsFrames == FREQVIEW_RENDER_STATS_LOG_INTERVAL)
+        {
+            std::cout << "Rendered " << meshBatch->getLastDrawnMeshesCount() << " of " << meshBatch->getMeshesCount()
+                      << " samples in " << meshBatch->getLastDrawCallsCount()
+                      << " draw ranges, sample layer redrawn in " << renderStatsSampleLayerFrames << " of "
+                      << renderStatsFrames << " frames, average frame time " << renderStatsMs / renderStatsFrames
+                      << " ms, spectrogram tiles use " << (tileAtlas->getUsedMemory() >> 20) << " of "
+                      << (tileAtlas->getMemoryBudget() >> 20) << " MB" << std::endl;
+            renderStatsFrames = 0;
+            renderStatsSampleLayerFrames = 0;
+            renderStatsMs = 0;
+        }
+    }
+
+    if (!firstFrameRendered)
+    {
+        // what was not needed to show the window can now be initialized
+        firstFrameRendered = true;
+        sharedStartupTracer->markFirstFrame();
+        LazyInit::runPendingInits();
+    }
+}
+
+void ArrangementArea::renderSampleLayer()
 {
     // enable the damn blending
     juce::gl::glEnable(juce::gl::GL_BLEND);
@@ -772,20 +1000,107 @@ void ArrangementArea::renderOpenGL()
     juce::gl::glClearColor(0.078f, 0.078f, 0.078f, 1.0f);
     juce::gl::glClear(juce::gl::GL_COLOR_BUFFER_BIT);
 
+    frameProfiler.beginPass(FRAME_PASS_GRID);
     backgroundGridShader->use();
     backgroundGrid.drawGlObjects();
+    frameProfiler.endPass();
+
+    frameProfiler.beginPass(FRAME_PASS_SAMPLES);
 
     alphaMaskTextureLoader.bindTexture();
+    colormapTextureLoader.bindTexture();
     texturedPositionedShader->use();
 
-    for (size_t i = 0; i < samples.size(); i++)
+    // request the spectrogram tiles of the visible part of the samples in view
+    float framesPerPixel = float(viewPositionManager->getViewScale());
+    float viewStartFrame = float(viewPositionManager->getViewPosition());
+    float viewEndFrame = viewStartFrame + (float(bounds.getWidth()) * framesPerPixel);
+    tileAtlas->beginFrame();
+
+    {
+        const juce::ScopedLock lock(sampleSpatialIndexMutex);
+        sampleSpatialIndex.findSamples(viewStartFrame, viewEndFrame, tileRequestIds);
+    }
+    for (size_t k = 0; k < tileRequestIds.size(); k++)
+    {
+        size_t i = (size_t)tileRequestIds[k];
+        if (i < samples.size())
+        {
+            samples[i]->requestVisibleTiles(viewStartFrame, viewEndFrame, framesPerPixel);
+        }
+    }
+
+    // then draw the samples in view at once
+    tileAtlas->bindTextures();
+    meshBatch->drawVisible(viewStartFrame, viewEndFrame);
+    frameProfiler.endPass();
+}
+
+void ArrangementArea::drawPerfOverlay()
+{
+    FrameProfile profile = frameProfiler.getAverageProfile();
+    double gpuMs = profile.gpuMs[FRAME_PASS_GRID] + profile.gpuMs[FRAME_PASS_SAMPLES] +
+                   profile.gpuMs[FRAME_PASS_OVERLAYS];
+
+    juce::StringArray lines;
+    lines.add("frame " + juce::String((juce::int64)profile.frame) + ", average of last " +
+              juce::String(FRAME_PROFILER_AVERAGED_FRAMES));
+    lines.add("cpu " + juce::String(profile.cpuMs, 3) + " ms, gpu " + juce::String(gpuMs, 3) + " ms");
+    lines.add("gpu grid " + juce::String(profile.gpuMs[FRAME_PASS_GRID], 3) + " samples " +
+              juce::String(profile.gpuMs[FRAME_PASS_SAMPLES], 3) + " overlays " +
+              juce::String(profile.gpuMs[FRAME_PASS_OVERLAYS], 3));
+    lines.add("draw calls " + juce::String(profile.drawCalls));
+    lines.add("textures " + juce::String(double(profile.residentTextureBytes) / double(1 << 20), 1) + " of " +
+              juce::String(double(tileAtlas->getMemoryBudget()) / double(1 << 20), 1) + " MB");
+    lines.add("uploads " + juce::String(double(profile.uploadedBytes) / 1024.0, 1) + " KB/frame");
+    if (frameProfiler.isWritingCsv())
+    {
+        lines.add("writing csv");
+    }
+
+    float lineHeight = FREQVIEW_LABEL_HEIGHT - FREQVIEW_LABELS_MARGINS;
+    float width = 0.0f;
+    for (const juce::String &line : lines)
     {
-        samples[i]->drawGlObjects();
+        // one more pixel than the text needs so that rounding never cuts the longest line
+        width = juce::jmax(width, perfOverlayBatch.getTextWidth(line) + (2 * FREQVIEW_LABELS_MARGINS) + 1.0f);
+    }
+    juce::Rectangle<float> box(float(getWidth()) - width - FREQVIEW_LABELS_MARGINS, FREQVIEW_LABELS_MARGINS, width,
+                               lineHeight * float(lines.size()));
+
+    perfOverlayBatch.clear();
+    perfOverlayBatch.addBox(box, juce::Colour::fromFloatRGBA(0.0f, 0.0f, 0.0f, 0.75f), FREQVIEW_LABELS_CORNER_ROUNDING);
+    for (int i = 0; i < lines.size(); i++)
+    {
+        perfOverlayBatch.addText(lines[i],
+                                 box.withY(box.getY() + (lineHeight * float(i)))
+                                     .withHeight(lineHeight)
+                                     .reduced(FREQVIEW_LABELS_MARGINS, 0.0f),
+                                 juce::Colours::white);
+    }
+    perfOverlayBatch.submit();
+    perfOverlayBatch.draw(*labelShader, getWidth(), getHeight());
+}
+
+void ArrangementArea::togglePerfCsv()
+{
+    if (frameProfiler.isWritingCsv())
+    {
+        frameProfiler.stopCsv();
+    }
+    else
+    {
+        juce::SharedResourcePointer<Config> sharedConfig;
+        juce::File folder = juce::File(sharedConfig->getDataFolderPath()).getChildFile(FREQVIEW_PERF_CSV_FOLDER);
+        juce::String fileName = juce::Time::getCurrentTime().formatted("frames-%Y%m%d-%H%M%S.csv");
+        frameProfiler.startCsv(folder.getChildFile(fileName).getNonexistentSibling());
     }
 }
 
 void ArrangementArea::openGLContextClosing()
 {
+    frameProfiler.releaseGlObjects();
+    sampleLayer.release();
 }
 
 void ArrangementArea::createNewSampleMeshAndTaxonomy(std::shared_ptr<SamplePlayer> sp,
@@ -819,6 +1134,7 @@ void ArrangementArea::createNewSampleMeshAndTaxonomy(std::shared_ptr<SamplePlaye
         // send the data to the GPUs from the OpenGL thread
         openGLContext.executeOnGLThread(
             [this, task](juce::OpenGLContext &) { samples[(size_t)task->newIndex]->registerGlObjects(); }, true);
+        updateSampleSpatialIndex(task->newIndex);
         // if it's a copy, set the group and update the color
         if (task->isDuplication())
         {
@@ -1049,7 +1365,6 @@ void ArrangementArea::saveInitialSelectionGainRamps()
 
 int ArrangementArea::getSampleIdUnderCursor()
 {
-    size_t nTracks = samples.size();
     int64_t trackPosition;
 
     int bestTrackIndex = -1;
@@ -1068,9 +1383,14 @@ int ArrangementArea::getSampleIdUnderCursor()
     int viewPosition = viewPositionManager->getViewPosition();
     int viewScale = viewPositionManager->getViewScale();
 
-    // for each track
-    for (size_t i = 0; i < nTracks; i++)
+    // only look at the samples around the cursor frame, the fade out areas of the filters
+    // are not in the index frequency bounds so the y position is checked below for each one.
+    findSamplesAroundCursor(viewPosition, viewScale);
+
+    for (size_t k = 0; k < spatialQueryIds.size(); k++)
     {
+        size_t i = (size_t)spatialQueryIds[k];
+
         // skip nullptr in tracks list
         if (samples[i]->isDisabled())
         {
@@ -1086,7 +1406,7 @@ int ArrangementArea::getSampleIdUnderCursor()
 
             float y = float(lastMouseY) / bounds.getHeight();
 
-            currentIntensity = samples[i]->textureIntensity(x, y);
+            currentIntensity = samples[i]->textureIntensity(x, y, spectrogramMinDb, spectrogramMaxDb);
 
             if (bestTrackIndex == -1 || currentIntensity > bestTrackIntensity)
             {
@@ -1109,25 +1429,27 @@ int ArrangementArea::getSampleIdUnderCursor()
 
 float ArrangementArea::getTextureIntensityUnderCursor()
 {
-    size_t nTracks = samples.size();
     int64_t trackPosition;
 
     int bestTrackIndex = -1;
     float bestTrackIntensity = 0.0f;
     float currentIntensity;
 
-    // for each track
-    for (size_t i = 0; i < nTracks; i++)
+    int viewPosition = viewPositionManager->getViewPosition();
+    int viewScale = viewPositionManager->getViewScale();
+
+    findSamplesAroundCursor(viewPosition, viewScale);
+
+    for (size_t k = 0; k < spatialQueryIds.size(); k++)
     {
+        size_t i = (size_t)spatialQueryIds[k];
+
         // skip nullptr in tracks list
         if (samples[i]->isDisabled())
         {
             continue;
         }
 
-        int viewPosition = viewPositionManager->getViewPosition();
-        int viewScale = viewPositionManager->getViewScale();
-
         trackPosition = (samples[i]->getFramePosition() - viewPosition) / viewScale;
 
         // if it's inbound, return the index
@@ -1137,7 +1459,7 @@ float ArrangementArea::getTextureIntensityUnderCursor()
 
             float y = float(lastMouseY) / bounds.getHeight();
 
-            currentIntensity = samples[i]->textureIntensity(x, y);
+            currentIntensity = samples[i]->textureIntensity(x, y, spectrogramMinDb, spectrogramMaxDb);
 
             if (bestTrackIndex == -1 || currentIntensity > bestTrackIntensity)
             {
@@ -1150,6 +1472,13 @@ float ArrangementArea::getTextureIntensityUnderCursor()
     return bestTrackIntensity;
 }
 
+void ArrangementArea::findSamplesAroundCursor(int viewPosition, int viewScale)
+{
+    // the pixel positions of the samples are rounded, so we look one pixel around the cursor
+    float cursorFrame = float(viewPosition) + (float(lastMouseX) * float(viewScale));
+    sampleSpatialIndex.findSamples(cursorFrame - float(viewScale), cursorFrame + float(viewScale), spatialQueryIds);
+}
+
 void ArrangementArea::initSelectedTracksDrag()
 {
     std::set<size_t>::iterator itr;
@@ -1163,14 +1492,15 @@ void ArrangementArea::updateSelectedTracksDrag(int pixelShift)
 {
     int viewScale = viewPositionManager->getViewScale();
 
+    // dragging only changes the offset of the samples meshes, which doesn't need the OpenGL thread.
+    // The OpenGL thread requests the tiles of the samples the index has in view, so it must not see
+    // a moved mesh before the index is updated.
+    const juce::ScopedLock lock(sampleSpatialIndexMutex);
     std::set<size_t>::iterator itr;
     for (itr = selectedTracks.begin(); itr != selectedTracks.end(); itr++)
     {
-        openGLContext.executeOnGLThread(
-            [this, itr, viewScale, pixelShift](juce::OpenGLContext &) {
-                samples[*itr]->updateDrag(pixelShift * viewScale);
-            },
-            true);
+        samples[*itr]->updateDrag(pixelShift * viewScale);
+        updateSampleSpatialIndex((int)*itr);
     }
 }
 
@@ -1378,9 +1708,39 @@ void ArrangementArea::addToSelectionFromSelectionArea()
 
     int viewPosition = viewPositionManager->getViewPosition();
     int viewScale = viewPositionManager->getViewScale();
+    float viewHeight = float(bounds.getHeight());
+
+    // frames covered by the selection area, with one pixel of margin for rounding
+    float startFrame = float(viewPosition) + ((currentSelectionRect.getX() - 1.0f) * float(viewScale));
+    float endFrame = float(viewPosition) + ((currentSelectionRect.getRight() + 1.0f) * float(viewScale));
+
+    // frequency position ratios covered by the selection area in the top (left channel)
+    // and bottom (right channel) halves of the view. As the two ranges are merged,
+    // some of the candidates can still be out of the area and are checked below.
+    float halfHeight = viewHeight / 2.0f;
+    float pixelRatio = 1.0f / halfHeight;
+    float top = currentSelectionRect.getY();
+    float bottom = currentSelectionRect.getBottom();
+    float lowestRatio = 1.0f;
+    float highestRatio = 0.0f;
+    if (top < halfHeight)
+    {
+        lowestRatio = juce::jmin(lowestRatio, 1.0f - (juce::jmin(bottom, halfHeight) / halfHeight));
+        highestRatio = juce::jmax(highestRatio, 1.0f - (top / halfHeight));
+    }
+    if (bottom > halfHeight)
+    {
+        lowestRatio = juce::jmin(lowestRatio, (juce::jmax(top, halfHeight) - halfHeight) / halfHeight);
+        highestRatio = juce::jmax(highestRatio, (bottom - halfHeight) / halfHeight);
+    }
+
+    sampleSpatialIndex.findSamples(startFrame, endFrame, lowestRatio - pixelRatio, highestRatio + pixelRatio,
+                                   spatialQueryIds);
 
-    for (size_t i = 0; i < samples.size(); i++)
+    for (size_t k = 0; k < spatialQueryIds.size(); k++)
     {
+        size_t i = (size_t)spatialQueryIds[k];
+
         if (samples[i] == nullptr || samples[i]->isDisabled())
         {
             continue;
@@ -1447,7 +1807,7 @@ void ArrangementArea::cropSelectedSamplesFreqs(bool innerBorders)
 
     std::shared_ptr<SamplePlayer> currentSample;
 
-    bool changedSomething = false;
+    std::vector<int> changedSamples;
 
     for (itr = selectedTracks.begin(); itr != selectedTracks.end(); itr++)
     {
@@ -1472,7 +1832,6 @@ void ArrangementArea::cropSelectedSamplesFreqs(bool innerBorders)
                 initFiltersFreqs[*itr] = freq;
             }
 
-            changedSomething = true;
             if (innerBorders)
             {
                 currentSample->setHighPassFreq(filterFreq);
@@ -1481,12 +1840,26 @@ void ArrangementArea::cropSelectedSamplesFreqs(bool innerBorders)
             {
                 currentSample->setLowPassFreq(filterFreq);
             }
-            refreshSampleOpenGlView(*itr);
+            changedSamples.push_back((int)*itr);
         }
     }
 
-    if (changedSomething)
+    if (!changedSamples.empty())
     {
+        // update all the meshes in a single trip to the OpenGL thread
+        openGLContext.executeOnGLThread(
+            [this, &changedSamples](juce::OpenGLContext &) {
+                for (size_t i = 0; i < changedSamples.size(); i++)
+                {
+                    samples[(size_t)changedSamples[i]]->reloadSampleData(mixingBus.getTrack(changedSamples[i]));
+                }
+            },
+            true);
+
+        for (size_t i = 0; i < changedSamples.size(); i++)
+        {
+            updateSampleSpatialIndex(changedSamples[i]);
+        }
         repaint();
     }
 }
@@ -1500,6 +1873,31 @@ void ArrangementArea::refreshSampleOpenGlView(int index)
     }
     openGLContext.executeOnGLThread(
         [this, index, sp](juce::OpenGLContext &) { samples[(size_t)index]->reloadSampleData(sp); }, true);
+    updateSampleSpatialIndex(index);
+}
+
+void ArrangementArea::updateSampleSpatialIndex(int index)
+{
+    if (index < 0 || (size_t)index >= samples.size())
+    {
+        return;
+    }
+
+    const juce::ScopedLock lock(sampleSpatialIndexMutex);
+
+    std::shared_ptr<SampleGraphicModel> sample = samples[(size_t)index];
+    if (sample == nullptr || sample->isDisabled())
+    {
+        sampleSpatialIndex.removeSample(index);
+        labelsLayoutValid = false;
+        return;
+    }
+
+    labelsLayoutValid = false;
+
+    float startFrame = float(sample->getFramePosition());
+    sampleSpatialIndex.setSample(index, startFrame, startFrame + float(sample->getFrameLength()),
+                                 sample->getHighPassPositionRatio(), sample->getLowPassPositionRatio());
 }
 
 bool ArrangementArea::updateViewResizing(juce::Point<int> &newPosition)
@@ -1592,7 +1990,8 @@ void ArrangementArea::emitPositionTip()
     }
 
     float intensity = getTextureIntensityUnderCursor();
-    float intensityDB = UnitConverter::magnifyIntensityInv(intensity);
+    // the intensity is mapped from the displayed decibels range
+    float intensityDB = juce::jmap(intensity, spectrogramMinDb, spectrogramMaxDb);
     posTip += "     |    " + std::to_string(intensityDB) + " dB";
 
     sharedTips->setPositionStatus(posTip);
@@ -1832,6 +2231,13 @@ bool ArrangementArea::keyPressed(const juce::KeyPress &key)
             activityManager.getAppState().setUiState(UI_STATE_DISPLAY_TIME_SPLIT_LOCATION);
         }
     }
+    else if (key == juce::KeyPress::createFromDescription(KEYMAP_TOGGLE_LINEAR_PHASE))
+    {
+        if (activityManager.getAppState().getUiState() == UI_STATE_DEFAULT && !selectedTracks.empty())
+        {
+            toggleSelectionLinearPhase();
+        }
+    }
     else if (key == juce::KeyPress::createFromDescription(KEYMAP_UNDO))
     {
         if (activityManager.getAppState().getUiState() == UI_STATE_DEFAULT)
@@ -1848,6 +2254,18 @@ bool ArrangementArea::keyPressed(const juce::KeyPress &key)
             repaint();
         }
     }
+    else if (key == juce::KeyPress::createFromDescription(KEYMAP_TOGGLE_PERF_OVERLAY))
+    {
+        perfOverlayVisible = !perfOverlayVisible;
+        frameProfiler.setEnabled(perfOverlayVisible || frameProfiler.isWritingCsv());
+        openGLContext.triggerRepaint();
+    }
+    else if (key == juce::KeyPress::createFromDescription(KEYMAP_TOGGLE_PERF_CSV))
+    {
+        togglePerfCsv();
+        frameProfiler.setEnabled(perfOverlayVisible || frameProfiler.isWritingCsv());
+        openGLContext.triggerRepaint();
+    }
     // do not intercept the signal and pass it around
     return false;
 }
@@ -1917,6 +2335,39 @@ void ArrangementArea::deleteSelectedTracks()
     repaint();
 }
 
+void ArrangementArea::toggleSelectionLinearPhase()
+{
+    bool allLinearPhase = true;
+    std::set<size_t>::iterator it;
+    for (it = selectedTracks.begin(); it != selectedTracks.end(); it++)
+    {
+        auto sp = mixingBus.getTrack(*it);
+        if (sp != nullptr && !sp->isLinearPhaseFiltering())
+        {
+            allLinearPhase = false;
+        }
+    }
+
+    std::vector<std::shared_ptr<Task>> tasksToBroadcast;
+    int taskGroupId = Task::getNewTaskGroupIndex();
+    for (it = selectedTracks.begin(); it != selectedTracks.end(); it++)
+    {
+        auto sp = mixingBus.getTrack(*it);
+        if (sp != nullptr)
+        {
+            auto task = std::make_shared<SampleLinearPhaseChange>(*it, sp->isLinearPhaseFiltering(), !allLinearPhase);
+            task->setTaskGroupIndex(taskGroupId);
+            tasksToBroadcast.push_back(task);
+        }
+    }
+
+    // separetely broadcast to prevent altering selection set during iteration
+    for (size_t i = 0; i < tasksToBroadcast.size(); i++)
+    {
+        activityManager.broadcastTask(tasksToBroadcast[i]);
+    }
+}
+
 bool ArrangementArea::keyStateChanged(bool)
 {
     int viewScale = viewPositionManager->getViewScale();
@@ -4,18 +4,25 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_opengl/juce_opengl.h>
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "../../Arrangement/ActivityManager.h"
 #include "../../Arrangement/SampleAreaRectangle.h"
+#include "../../Arrangement/SampleSpatialIndex.h"
 #include "../../Arrangement/TaxonomyManager.h"
 #include "../../Audio/MixingBus.h"
 #include "../../Config.h"
 #include "../../OpenGL/AlphaMaskTextureLoader.h"
 #include "../../OpenGL/BackgroundModel.h"
+#include "../../OpenGL/ColormapTextureLoader.h"
+#include "../../OpenGL/FrameProfiler.h"
+#include "../../OpenGL/LabelBatch.h"
 #include "../../OpenGL/SampleGraphicModel.h"
+#include "../../OpenGL/ShaderProgramCache.h"
+#include "../../StartupTracer.h"
 #include "../StatusTips.h"
 #include "../ViewPosition.h"
 #include "FrequencyGrid.h"
@@ -186,6 +193,22 @@ class ArrangementArea : public juce::Component,
      */
     void openGLContextClosing() override;
 
+    /**
+     * @brief      Renders the background grid and the samples in the currently bound framebuffer.
+     */
+    void renderSampleLayer();
+
+    /**
+     * @brief      Draws the averaged frame costs in the upper right corner. To be called from
+     *             the OpenGL thread with the label shader in use.
+     */
+    void drawPerfOverlay();
+
+    /**
+     * @brief      Starts writing the frame costs to a new CSV file in the data folder, or stops if it was.
+     */
+    void togglePerfCsv();
+
     /**
      * @brief      Dump a JSON formatted string representing UI state
      *
@@ -208,6 +231,16 @@ class ArrangementArea : public juce::Component,
      */
     void viewPositionUpdateCallback() override;
 
+    /**
+     * @brief      Sets how the spectrograms decibels are displayed. Only the shader
+     *             uniforms change, the spectrogram textures are kept as is.
+     *
+     * @param[in]  minDb     The decibels displayed fully transparent
+     * @param[in]  maxDb     The decibels displayed fully opaque
+     * @param[in]  colormap  True to color by intensity instead of using the sample color
+     */
+    void setSpectrogramDisplay(float minDb, float maxDb, bool colormap);
+
   private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ArrangementArea)
@@ -224,12 +257,32 @@ class ArrangementArea : public juce::Component,
     // used as a sample alpha mask texture (ie add grain / stars)
     AlphaMaskTextureLoader alphaMaskTextureLoader;
 
+    // object that loads the lookup texture coloring the spectrograms by intensity
+    ColormapTextureLoader colormapTextureLoader;
+
+    // decibels range and coloring of the spectrograms, applied by the fragment shader
+    float spectrogramMinDb;
+    float spectrogramMaxDb;
+    bool spectrogramColormap;
+
     // NOTE: we will draw each sample fft in OpenGL
     // with a rectangle on which we map a texture.
     std::vector<std::shared_ptr<SampleGraphicModel>> samples;
+    // time and frequency bounds of the enabled samples, for hit testing and selection
+    SampleSpatialIndex sampleSpatialIndex;
+    // reused by the spatial index queries to avoid allocations
+    std::vector<int> spatialQueryIds;
+    // held when the message thread changes the spatial index, and when the OpenGL thread reads it
+    juce::CriticalSection sampleSpatialIndexMutex;
+    // samples in view whose spectrogram tiles are requested, reused by the OpenGL thread
+    std::vector<int> tileRequestIds;
     BackgroundModel backgroundGrid;
     std::unique_ptr<juce::OpenGLShaderProgram> texturedPositionedShader;
     std::unique_ptr<juce::OpenGLShaderProgram> backgroundGridShader;
+    std::unique_ptr<juce::OpenGLShaderProgram> labelShader;
+    // linked shader programs saved from the previous runs, as the context is recreated
+    // each time the window moves to another screen
+    ShaderProgramCache shaderProgramCache;
     bool shadersCompiled;
 
     float grid0PixelWidth;
@@ -280,6 +333,13 @@ class ArrangementArea : public juce::Component,
     // buffer and vector for the labels on screen (to be swapped after
     // update)
     std::vector<SampleAreaRectangle> onScreenLabelsPixelsCoordsBuffer, onScreenLabelsPixelsCoords;
+    // horizontal extent of the labels placed in each row, by left side, as rows are all the same height
+    std::map<int, std::map<float, float>> labelRows;
+    // the labels are only placed again when the view or the samples changed
+    bool labelsLayoutValid;
+    int labelsViewPosition, labelsViewScale, labelsViewWidth, labelsViewHeight;
+    // draws the labels boxes and texts in OpenGL
+    LabelBatch labelBatch;
     // buffer and vector for the coordinates of the selected samples on screen
     std::vector<SampleAreaRectangle> selectedSamplesCoordsBuffer, cropSelectedSamplesPosition;
 
@@ -290,13 +350,45 @@ class ArrangementArea : public juce::Component,
 
     juce::SharedResourcePointer<TextureManager> textureManager;
 
+    // streams the visible tiles of the samples spectrograms to the GPU
+    juce::SharedResourcePointer<SpectrogramTileAtlas> tileAtlas;
+
+    // holds the meshes of all samples so that they are drawn in one call
+    juce::SharedResourcePointer<SampleMeshBatch> meshBatch;
+
+    // offscreen copy of the background grid and samples, reused until they change
+    juce::OpenGLFrameBuffer sampleLayer;
+    // set when the view or grid uniforms changed since the sample layer was rendered
+    bool sceneUniformsChanged;
+
+    // frames rendered, frames where the sample layer was rendered and time spent rendering them
+    // since the rendering statistics were last logged
+    int renderStatsFrames;
+    int renderStatsSampleLayerFrames;
+    double renderStatsMs;
+
+    // measures the cost of each frame for the perf overlay and CSV dumps
+    FrameProfiler frameProfiler;
+    std::atomic<bool> perfOverlayVisible;
+    // draws the perf overlay, built and drawn on the OpenGL thread
+    LabelBatch perfOverlayBatch;
+
     juce::SharedResourcePointer<ViewPosition> viewPositionManager;
 
+    // the first frame ends the startup and starts the lazy initializations
+    juce::SharedResourcePointer<StartupTracer> sharedStartupTracer;
+    bool firstFrameRendered;
+
     //==============================================================================
     void paintPlayCursor(juce::Graphics &g);
     void paintSelection(juce::Graphics &g);
-    void paintLabels(juce::Graphics &g);
-    void paintSampleLabel(juce::Graphics &g, juce::Rectangle<float> &, int index);
+    /**
+     * @brief      Place the labels of the samples on screen if the view or the samples changed
+     *             since they were last placed, and send them to the label batch.
+     */
+    void updateLabels();
+    void placeLabels();
+    void addSampleLabel(juce::Rectangle<float> &, int index);
     void paintSplitLocation(juce::Graphics &g);
     void paintSelectionArea(juce::Graphics &g);
 
@@ -315,9 +407,13 @@ class ArrangementArea : public juce::Component,
                                                    int sampleIndex);
 
     /**
-     * @brief      Test if the rectangle intersect with the others.
+     * @brief      Test if a label would overlap the ones already placed in a row.
+     *
+     * @param[in]  row    The row index, from the middle of the view
+     * @param[in]  left   The label left side in pixels
+     * @param[in]  right  The label right side in pixels
      */
-    bool rectangleIntersects(SampleAreaRectangle &, std::vector<SampleAreaRectangle> &);
+    bool labelRowIntersects(int row, float left, float right);
 
     void handleMiddleButterDown(const juce::MouseEvent &);
     void handleLeftButtonDown(const juce::MouseEvent &);
@@ -343,6 +439,12 @@ class ArrangementArea : public juce::Component,
      */
     void deleteSelectedTracks();
 
+    /**
+     * @brief      Switch the selected samples to linear phase filters, or back to the IIR
+     *             filters if they all use linear phase filters already.
+     */
+    void toggleSelectionLinearPhase();
+
     /**
      * @brief      Create the sample on the openGL model side and against the taxonomy.
      *
@@ -366,15 +468,16 @@ class ArrangementArea : public juce::Component,
     bool buildAllShaders();
 
     /**
-     * @brief      Builds a shader. Called by buildAllShaders
+     * @brief      Builds a shader, from the shader program cache if possible. Called by buildAllShaders
      *
      * @param      shader             The shader
+     * @param[in]  name               The name of the shader program in the cache
      * @param[in]  vertexShaderTxt    The vertex shader source code text
      * @param[in]  fragmentShaderTxt  The fragment shader source code text
      *
      * @return     True on sucess.
      */
-    bool buildShader(std::unique_ptr<juce::OpenGLShaderProgram> &shader, std::string vertexShaderTxt,
+    bool buildShader(std::unique_ptr<juce::OpenGLShaderProgram> &shader, std::string name, std::string vertexShaderTxt,
                      std::string fragmentShaderTxt);
 
     /**
@@ -390,6 +493,11 @@ class ArrangementArea : public juce::Component,
      */
     void updateShadersViewAndGridUniforms();
 
+    /**
+     * @brief      Sends the spectrogram display settings to the sample shader. Must be called from the OpenGL thread.
+     */
+    void updateShadersDisplayUniforms();
+
     /**
      * @brief      Calculates the shaders grid uniforms variables.
      */
@@ -497,6 +605,23 @@ class ArrangementArea : public juce::Component,
      */
     void refreshSampleOpenGlView(int index);
 
+    /**
+     * @brief      Update the time and frequency bounds of a sample in the spatial index
+     *             from its openGL model, or remove it if it's disabled.
+     *
+     * @param[in]  index  The sample index
+     */
+    void updateSampleSpatialIndex(int index);
+
+    /**
+     * @brief      Fill spatialQueryIds with the samples that have a part in the column of pixels
+     *             under the mouse cursor, whatever their frequencies.
+     *
+     * @param[in]  viewPosition  The view position
+     * @param[in]  viewScale     The view scale
+     */
+    void findSamplesAroundCursor(int viewPosition, int viewScale);
+
     /**
      * @brief      Called when a task is received to recolor a group. It will get all the group sample ids
      *             and call the function that pulls the taxonomy color in the openGL mesh.
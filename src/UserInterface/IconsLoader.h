@@ -1,29 +1,55 @@
 #ifndef DEF_ICONS_LOADER_HPP
 #define DEF_ICONS_LOADER_HPP
 
+#include "../LazyInit.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <memory>
 
+/**
+ * @brief An svg icon that is only parsed the first time it's drawn, or once
+ *        the app window is shown. Must be used from the message thread.
+ */
+class LazyIcon
+{
+  public:
+    /**
+     * @brief Registers an icon to parse later.
+     *
+     * @param name       The name of the icon, for the startup trace
+     * @param svgData    The svg data, that must outlive the icon
+     * @param svgSize    The size of the svg data
+     * @param colour     The colour the white of the svg is replaced with
+     */
+    LazyIcon(const std::string &name, const char *svgData, int svgSize,
+             juce::Colour colour = juce::Colours::white);
+
+    juce::Drawable *operator->();
+
+  private:
+    std::unique_ptr<juce::Drawable> drawable;
+    LazyInit parsing;
+};
+
 struct IconsLoader
 {
     IconsLoader();
 
-    std::unique_ptr<juce::Drawable> playIcon;
-    std::unique_ptr<juce::Drawable> pauseIcon;
-    std::unique_ptr<juce::Drawable> startIcon;
-    std::unique_ptr<juce::Drawable> loopIcon;
-    std::unique_ptr<juce::Drawable> unloopIcon;
-    std::unique_ptr<juce::Drawable> moveIcon;
-    std::unique_ptr<juce::Drawable> resizeHorizontalIcon;
-    std::unique_ptr<juce::Drawable> searchIcon;
-    std::unique_ptr<juce::Drawable> folderIcon;
-    std::unique_ptr<juce::Drawable> fileIcon;
-    std::unique_ptr<juce::Drawable> audioIcon;
-    std::unique_ptr<juce::Drawable> closedCaret;
-    std::unique_ptr<juce::Drawable> openedCaret;
+    LazyIcon playIcon;
+    LazyIcon pauseIcon;
+    LazyIcon startIcon;
+    LazyIcon loopIcon;
+    LazyIcon unloopIcon;
+    LazyIcon moveIcon;
+    LazyIcon resizeHorizontalIcon;
+    LazyIcon searchIcon;
+    LazyIcon folderIcon;
+    LazyIcon fileIcon;
+    LazyIcon audioIcon;
+    LazyIcon closedCaret;
+    LazyIcon openedCaret;
 
   private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IconsLoader)
 };
 
-#endif // DEF_ICONS_LOADER_HPP
\ No newline at end of file
+#endif // DEF_ICONS_LOADER_HPP
@@ -14,7 +14,10 @@ MainComponent::MainComponent()
 
     activityManager.registerTaskListener(this);
 
-    configureLookAndFeel();
+    {
+        StartupPhase phase("look and feel");
+        configureLookAndFeel();
+    }
 
     activityManager.registerTaskListener(&mixingBus);
     activityManager.registerTaskListener(&topbarArea);
@@ -22,7 +25,10 @@ MainComponent::MainComponent()
     activityManager.registerTaskListener(&notifArea);
 
     // initialize audio app with two outputs
-    setAudioChannels(0, 2);
+    {
+        StartupPhase phase("audio device opening");
+        setAudioChannels(0, 2);
+    }
 
     printAudioDeviceSettings();
 
@@ -76,6 +82,14 @@ void MainComponent::printAudioDeviceSettings()
     std::cerr << "Output Device: " << deviceManager.getAudioDeviceSetup().outputDeviceName << std::endl;
     std::cerr << "Buffer size: " << deviceManager.getAudioDeviceSetup().bufferSize << std::endl;
     std::cerr << "Sample Rate: " << deviceManager.getAudioDeviceSetup().sampleRate << std::endl;
+    // the time the mixbus has to compute each buffer (see the audio engine load sidebar section)
+    if (deviceManager.getAudioDeviceSetup().sampleRate > 0.0)
+    {
+        std::cerr << "Buffer deadline: "
+                  << (1000.0 * deviceManager.getAudioDeviceSetup().bufferSize) /
+                         deviceManager.getAudioDeviceSetup().sampleRate
+                  << " ms" << std::endl;
+    }
 }
 
 MainComponent::~MainComponent()
@@ -147,10 +161,18 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo &buffer
 
 void MainComponent::configureApp(Config &conf)
 {
+    StartupPhase phase("app configuration");
+
+    if (!conf.isInvalid() && !conf.getConfigFolderPath().empty())
+    {
+        sharedStartupTracer->setTraceFile(juce::File(conf.getConfigFolderPath()).getChildFile(STARTUP_TRACE_FILE));
+    }
+
     audioLibraryTab.initAudioLibrary(conf);
 
     if (conf.getBufferSize() != 0)
     {
+        StartupPhase bufferSizePhase("audio buffer size setup");
         auto oldSetup = deviceManager.getAudioDeviceSetup();
         oldSetup.bufferSize = conf.getBufferSize();
 
@@ -160,6 +182,15 @@ void MainComponent::configureApp(Config &conf)
         printAudioDeviceSettings();
     }
 
+    sharedAudioFileBuffers->setInMemoryCompression(conf.isInMemoryCompressionEnabled());
+
+    mixingBus.setFreezeMemoryBudget((size_t)conf.getFreezeMemoryMb() << 20);
+
+    sharedTileAtlas->setMemoryBudget((size_t)conf.getSpectrogramGpuMemoryMb() << 20);
+
+    arrangementArea.setSpectrogramDisplay(conf.getSpectrogramMinDb(), conf.getSpectrogramMaxDb(),
+                                          conf.isSpectrogramColormapEnabled());
+
     sharedConfig.get() = conf;
 }
 
@@ -11,6 +11,7 @@
 
 #include "../Arrangement/UserInterfaceState.h"
 #include "../Audio/MixingBus.h"
+#include "../StartupTracer.h"
 #include "./ArrangementArea/ArrangementArea.h"
 #include "KholorsLookAndFeel.h"
 #include "LayerBar.h"
@@ -83,6 +84,11 @@ class MainComponent : public juce::AudioAppComponent, public juce::DragAndDropCo
     NotificationOverlay notifArea;
 
     juce::SharedResourcePointer<Config> sharedConfig;
+    juce::SharedResourcePointer<AudioFilesBufferStore>
+        sharedAudioFileBuffers; /**< object managing audio buffers read from files */
+    juce::SharedResourcePointer<SpectrogramTileAtlas>
+        sharedTileAtlas; /**< object streaming the samples spectrograms to the GPU */
+    juce::SharedResourcePointer<StartupTracer> sharedStartupTracer; /**< where the startup phases are recorded */
 
     KholorsLookAndFeel appLookAndFeel;
     void configureLookAndFeel();
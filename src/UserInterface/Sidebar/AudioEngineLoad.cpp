@@ -0,0 +1,131 @@
+#include "AudioEngineLoad.h"
+
+#include "../../Config.h"
+#include "../Section.h"
+
+#include <iomanip>
+#include <sstream>
+
+// load percentages above which values are displayed as risky
+#define AUDIO_ENGINE_LOAD_WARN_PERCENT 50.0f
+#define AUDIO_ENGINE_LOAD_OVER_PERCENT 80.0f
+// horizontal space between histogram bars
+#define AUDIO_ENGINE_LOAD_BAR_PADDING 1.0f
+
+AudioEngineLoad::AudioEngineLoad()
+{
+}
+
+void AudioEngineLoad::setDataSource(std::shared_ptr<AudioLoadDataSource> ds)
+{
+    dataSource = ds;
+}
+
+int AudioEngineLoad::getIdealHeight()
+{
+    return SECTION_TITLE_HEIGHT + (AUDIO_ENGINE_LOAD_NO_LINES * AUDIO_ENGINE_LOAD_LINE_HEIGHT) +
+           SIDEBAR_WIDGETS_MARGINS + AUDIO_ENGINE_LOAD_HISTOGRAM_HEIGHT;
+}
+
+void AudioEngineLoad::paint(juce::Graphics &g)
+{
+    auto bounds = getLocalBounds();
+    drawSection(g, bounds, "Audio Engine Load");
+
+    if (dataSource != nullptr)
+    {
+        auto load = dataSource->getAudioCallbackLoad();
+        if (load.hasValue())
+        {
+            lastLoad = *load;
+        }
+    }
+
+    bounds.removeFromTop(SECTION_TITLE_HEIGHT);
+
+    g.setFont(sharedFonts->monospaceFont.withHeight(SMALLER_FONT_SIZE));
+
+    paintLine(g, bounds.removeFromTop(AUDIO_ENGINE_LOAD_LINE_HEIGHT), "Load",
+              formatFloat(lastLoad.loadPercent, 1) + " % / peak " + formatFloat(lastLoad.peakLoadPercent, 1) + " %",
+              colorForLoad(lastLoad.peakLoadPercent));
+
+    paintLine(g, bounds.removeFromTop(AUDIO_ENGINE_LOAD_LINE_HEIGHT), "Worst",
+              formatFloat(lastLoad.worstCallbackMicros / 1000.0f, 2) + " ms", colorForLoad(lastLoad.peakLoadPercent));
+
+    paintLine(g, bounds.removeFromTop(AUDIO_ENGINE_LOAD_LINE_HEIGHT), "Xruns", std::to_string(lastLoad.deadlineMisses),
+              lastLoad.deadlineMisses == 0 ? COLOR_AUDIO_ENGINE_LOAD_OK : COLOR_AUDIO_ENGINE_LOAD_OVER);
+
+    std::string heaviest = "-";
+    if (lastLoad.costliestPlayerId >= 0)
+    {
+        heaviest = "#" + std::to_string(lastLoad.costliestPlayerId) + " " +
+                   formatFloat(lastLoad.costliestPlayerMicros, 0) + " us " +
+                   std::to_string(lastLoad.costliestPlayerFilterStages) + " flt";
+    }
+    paintLine(g, bounds.removeFromTop(AUDIO_ENGINE_LOAD_LINE_HEIGHT), "Heaviest", heaviest, COLOR_TEXT_DARKER);
+
+    bounds.removeFromTop(SIDEBAR_WIDGETS_MARGINS);
+    paintHistogram(g, bounds.removeFromTop(AUDIO_ENGINE_LOAD_HISTOGRAM_HEIGHT));
+}
+
+void AudioEngineLoad::paintLine(juce::Graphics &g, juce::Rectangle<int> area, std::string label, std::string value,
+                                juce::Colour valueColor)
+{
+    g.setColour(COLOR_UNITS);
+    g.drawText(label, area.removeFromLeft(AUDIO_ENGINE_LOAD_LABEL_WIDTH), juce::Justification::centredLeft, false);
+    g.setColour(valueColor);
+    g.drawText(value, area, juce::Justification::centredRight, true);
+}
+
+void AudioEngineLoad::paintHistogram(juce::Graphics &g, juce::Rectangle<int> area)
+{
+    g.setColour(COLOR_BACKGROUND);
+    g.fillRect(area);
+
+    // bars are scaled relative to the most populated bucket
+    uint32_t maxCount = 0;
+    for (size_t i = 0; i < AUDIO_LOAD_HISTOGRAM_SIZE; i++)
+    {
+        maxCount = juce::jmax(maxCount, lastLoad.playerCostHistogram[i]);
+    }
+
+    if (maxCount != 0)
+    {
+        float barWidth = float(area.getWidth()) / float(AUDIO_LOAD_HISTOGRAM_SIZE);
+        for (size_t i = 0; i < AUDIO_LOAD_HISTOGRAM_SIZE; i++)
+        {
+            float barHeight = float(area.getHeight()) * float(lastLoad.playerCostHistogram[i]) / float(maxCount);
+            juce::Rectangle<float> bar(float(area.getX()) + (float(i) * barWidth),
+                                       float(area.getBottom()) - barHeight, barWidth, barHeight);
+            bar.reduce(AUDIO_ENGINE_LOAD_BAR_PADDING, 0);
+
+            // the right side buckets are the expensive ones
+            float ratio = float(i) / float(AUDIO_LOAD_HISTOGRAM_SIZE - 1);
+            g.setColour(COLOR_AUDIO_ENGINE_LOAD_OK.interpolatedWith(COLOR_AUDIO_ENGINE_LOAD_OVER, ratio));
+            g.fillRect(bar);
+        }
+    }
+
+    g.setColour(COLOR_SEPARATOR_LINE);
+    g.drawRect(area);
+}
+
+juce::Colour AudioEngineLoad::colorForLoad(float loadPercent)
+{
+    if (loadPercent >= AUDIO_ENGINE_LOAD_OVER_PERCENT)
+    {
+        return COLOR_AUDIO_ENGINE_LOAD_OVER;
+    }
+    if (loadPercent >= AUDIO_ENGINE_LOAD_WARN_PERCENT)
+    {
+        return COLOR_AUDIO_ENGINE_LOAD_WARN;
+    }
+    return COLOR_AUDIO_ENGINE_LOAD_OK;
+}
+
+std::string AudioEngineLoad::formatFloat(float value, int decimals)
+{
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(decimals) << value;
+    return stream.str();
+}
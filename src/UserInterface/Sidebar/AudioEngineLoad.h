@@ -0,0 +1,86 @@
+#ifndef DEF_AUDIO_ENGINE_LOAD_HPP
+#define DEF_AUDIO_ENGINE_LOAD_HPP
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <memory>
+
+#include "../../Audio/DataSource.h"
+#include "../FontsLoader.h"
+
+// height of each of the text lines
+#define AUDIO_ENGINE_LOAD_LINE_HEIGHT 16
+// how many text lines the widget shows
+#define AUDIO_ENGINE_LOAD_NO_LINES 4
+// height of the player cost histogram
+#define AUDIO_ENGINE_LOAD_HISTOGRAM_HEIGHT 28
+// width of the labels on the left of each line
+#define AUDIO_ENGINE_LOAD_LABEL_WIDTH 70
+
+#define COLOR_AUDIO_ENGINE_LOAD_OK juce::Colour(230, 237, 228)
+#define COLOR_AUDIO_ENGINE_LOAD_WARN juce::Colour(240, 174, 129)
+#define COLOR_AUDIO_ENGINE_LOAD_OVER juce::Colour(247, 133, 129)
+
+/**
+ * @brief      Sidebar section showing how close the audio callbacks are
+ *             to their deadline, how many were missed, and how much
+ *             sample players cost to compute.
+ */
+class AudioEngineLoad : public juce::Component
+{
+  public:
+    AudioEngineLoad();
+
+    /**
+     * @brief      Pull the latest values from the data source and paint them.
+     */
+    void paint(juce::Graphics &g) override;
+
+    /**
+     * @brief      Sets the data source to pull the load values from.
+     *
+     * @param[in]  ds    The audio load data source.
+     */
+    void setDataSource(std::shared_ptr<AudioLoadDataSource> ds);
+
+    /**
+     * @brief      Gets the height this section needs.
+     */
+    int getIdealHeight();
+
+  private:
+    // last values fetched from the data source
+    AudioCallbackLoad lastLoad;
+
+    // where we pull values from
+    std::shared_ptr<AudioLoadDataSource> dataSource;
+
+    // shared reference to the loaded custom fonts
+    juce::SharedResourcePointer<FontsLoader> sharedFonts;
+
+    ///////////
+
+    /**
+     * @brief      Paint a line with a label on the left and a value on the right.
+     */
+    void paintLine(juce::Graphics &g, juce::Rectangle<int> area, std::string label, std::string value,
+                   juce::Colour valueColor);
+
+    /**
+     * @brief      Paint the histogram of sample players audio blocks computing time.
+     */
+    void paintHistogram(juce::Graphics &g, juce::Rectangle<int> area);
+
+    /**
+     * @brief      Pick a color reflecting how risky a load percentage is.
+     */
+    juce::Colour colorForLoad(float loadPercent);
+
+    /**
+     * @brief      Format a float with the given number of decimals.
+     */
+    std::string formatFloat(float value, int decimals);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngineLoad)
+};
+
+#endif // DEF_AUDIO_ENGINE_LOAD_HPP
@@ -17,6 +17,7 @@ SidebarArea::SidebarArea(ActivityManager &am)
     addAndMakeVisible(sampleProperties);
     addAndMakeVisible(selectionGainVu);
     addAndMakeVisible(masterGainVu);
+    addAndMakeVisible(audioEngineLoad);
 }
 
 SidebarArea::~SidebarArea()
@@ -28,6 +29,7 @@ void SidebarArea::setDataSource(std::shared_ptr<MixbusDataSource> ds)
     selectionGainVu.setDataSource(ds);
     masterGainVu.setDataSource(ds);
     trackProperties.setDataSource(ds);
+    audioEngineLoad.setDataSource(ds);
 }
 
 bool SidebarArea::taskHandler(std::shared_ptr<Task>)
@@ -77,6 +79,10 @@ void SidebarArea::resized()
     masterGainVu.setBounds(vuMetersSection.removeFromLeft(vuMetersSection.getWidth() >> 1));
     selectionGainVu.setBounds(vuMetersSection);
 
+    // the audio engine load sits right above the vu meters
+    remainingBounds.removeFromBottom(SECTION_COMPONENTS_PADDING);
+    audioEngineLoad.setBounds(remainingBounds.removeFromBottom(audioEngineLoad.getIdealHeight()));
+
     // we finally start adding the main sections
     auto mainArea = remainingBounds;
     mainArea.removeFromTop(SIDEBAR_MAIN_SECTION_TOP_PADDING);
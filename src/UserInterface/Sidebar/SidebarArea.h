@@ -11,6 +11,7 @@
 #include "../../Arrangement/Task.h"
 #include "../LogoDarkPng.h"
 #include "../Widgets/VuMeter.h"
+#include "AudioEngineLoad.h"
 #include "ColorPicker.h"
 #include "LoopButton.h"
 #include "SampleProperties.h"
@@ -75,6 +76,8 @@ class SidebarArea : public juce::AnimatedAppComponent, public TaskListener
     VuMeter selectionGainVu;
     VuMeter masterGainVu;
 
+    AudioEngineLoad audioEngineLoad;
+
     ActivityManager &activityManager;
 
     //==============================================================================
@@ -12,7 +12,8 @@
 #define LENS_ADDITIONAL_LEFT_PADDING 3
 #define TEXT_ENTRY_DISPLACEMENT 1 // used to correct text entry that is misplaced a few pixels vertically
 
-AudioLibraryTab::AudioLibraryTab() : Thread("File Search Thread"), resultList("Results", &resultListContent)
+AudioLibraryTab::AudioLibraryTab()
+    : Thread("File Search Thread"), audioLibraries(nullptr), resultList("Results", &resultListContent)
 {
     startThread();
 
@@ -53,6 +54,12 @@ bool AudioLibraryTab::taskHandler(std::shared_ptr<Task> task)
         // we need to lock the message/gui thread
         const juce::MessageManagerLock mmLock;
 
+        ensureAudioLibrariesLoaded();
+        if (audioLibraries == nullptr)
+        {
+            return true;
+        }
+
         juce::File f(fctask->path);
         while (!isLibraryPath(f.getFullPathName().toStdString()) && f != juce::File("/home") && f != juce::File("/"))
         {
@@ -130,6 +137,9 @@ AudioLibraryTab::~AudioLibraryTab()
     // stop thread with a 4sec timeout to kill it
     stopThread(4000);
 
+    // an initialization that never ran must not run on a half destroyed tab
+    audioLibrariesInit.reset();
+
     treeView.setRootItem(nullptr);
     delete audioLibTreeRoot;
     if (audioLibraries != nullptr)
@@ -139,6 +149,12 @@ AudioLibraryTab::~AudioLibraryTab()
 }
 
 void AudioLibraryTab::initAudioLibrary(Config &conf)
+{
+    // the libraries are not needed to show the window, the config is copied as it's gone by then
+    audioLibrariesInit = std::make_unique<LazyInit>("audio libraries", [this, conf] { loadAudioLibraries(conf); });
+}
+
+void AudioLibraryTab::loadAudioLibraries(const Config &conf)
 {
     audioLibraries = new AudioLibraryManager(conf.getDataFolderPath(), conf.getProfileName());
     for (int i = 0; i < conf.getNumAudioLibs(); i++)
@@ -148,6 +164,14 @@ void AudioLibraryTab::initAudioLibrary(Config &conf)
     updateBestEntries();
 }
 
+void AudioLibraryTab::ensureAudioLibrariesLoaded()
+{
+    if (audioLibrariesInit != nullptr)
+    {
+        audioLibrariesInit->ensure();
+    }
+}
+
 void AudioLibraryTab::addAudioLibrary(std::string path)
 {
     if (audioLibraries != nullptr)
@@ -210,6 +234,9 @@ void AudioLibraryTab::textEditorTextChanged(juce::TextEditor &te)
 
     juce::String txt = te.getText();
 
+    // the search thread only looks for results in loaded libraries
+    ensureAudioLibrariesLoaded();
+
     // if text was just deleted, reset the result list
     if (txt.isEmpty())
     {
@@ -237,6 +264,10 @@ void AudioLibraryTab::textEditorTextChanged(juce::TextEditor &te)
 
 void AudioLibraryTab::updateBestEntries()
 {
+    if (audioLibraries == nullptr)
+    {
+        return;
+    }
     std::vector<std::string> bestEntries = audioLibraries->getTopEntries(100);
     resultListContent.setContent(bestEntries);
     resultList.updateContent();
@@ -251,6 +282,11 @@ void AudioLibraryTab::emptyResultEntries()
 // Reminder: only call from this class background thread
 void AudioLibraryTab::populateSearchContent(std::string txt)
 {
+    if (audioLibraries == nullptr)
+    {
+        return;
+    }
+
     // let's only fetch a few results
     auto res = audioLibraries->getSearchResults(txt, 200);
 
@@ -2,9 +2,11 @@
 #define DEF_AUDIO_LIBRARY_TAB
 
 #include <functional>
+#include <memory>
 
 #include "../../Arrangement/ActivityManager.h"
 #include "../../Config.h"
+#include "../../LazyInit.h"
 #include "../../Library/AudioLibraryManager.h"
 #include "../IconsLoader.h"
 #include "../Section.h"
@@ -23,6 +25,8 @@ class AudioLibraryTab : public juce::Component,
 
     /**
      * Instanciate the audio library manager with the given configuration.
+     * The access counts and the library trees are only loaded once the window
+     * is shown or when the libraries are first used.
      * @param config Config object that tells things like library locations.
      */
     void initAudioLibrary(Config &config);
@@ -64,6 +68,7 @@ class AudioLibraryTab : public juce::Component,
 
   private:
     AudioLibraryManager *audioLibraries;
+    std::unique_ptr<LazyInit> audioLibrariesInit;
     std::vector<std::string> audioLibPathsCopy;
     juce::TreeView treeView;
     AudioLibTreeRoot *audioLibTreeRoot;
@@ -86,6 +91,17 @@ class AudioLibraryTab : public juce::Component,
     juce::Rectangle<int> findLocation;
     juce::Rectangle<int> librariesSectionLocation;
 
+    /**
+     * Loads the access counts and the libraries of the configuration.
+     * @param config Config object that tells things like library locations.
+     */
+    void loadAudioLibraries(const Config &config);
+
+    /**
+     * Loads the audio libraries if they are not yet. Call from the message thread.
+     */
+    void ensureAudioLibrariesLoaded();
+
     /**
      * This add an audio library to the audio library manager.
      * @param path path to audio library on disk
@@ -0,0 +1,182 @@
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include "../src/Audio/AudioFilesBufferStore.h"
+#include "../src/Audio/UnitConverter.h"
+
+int main()
+{
+    juce::SharedResourcePointer<AudioFilesBufferStore> store;
+
+    // make a copy of a test sample under another path
+    juce::File original("../test/TestSamples/rise-up-sine.wav");
+    juce::File copy =
+        juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("kholors-test-store-copy.wav");
+    if (!original.copyFileTo(copy))
+    {
+        std::cerr << "unable to copy the test sample" << std::endl;
+        return 1;
+    }
+
+    std::string originalPath = original.getFullPathName().toStdString();
+    std::string copyPath = copy.getFullPathName().toStdString();
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Identical files must share their audio buffer and FFTs, but keep their own path.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    AudioFileBufferRef originalRef = store->loadSample(originalPath);
+    AudioFileBufferRef copyRef = store->loadSample(copyPath);
+    AudioFileBufferRef otherRef = store->loadSample("../test/TestSamples/A-sines-stereo.wav");
+
+    copy.deleteFile();
+
+    if (originalRef.data == nullptr || originalRef.data != copyRef.data)
+    {
+        std::cerr << "identical files don't share their audio buffer" << std::endl;
+        return 1;
+    }
+
+    if (originalRef.storedFftData == nullptr || originalRef.storedFftData != copyRef.storedFftData)
+    {
+        std::cerr << "identical files don't share their FFTs" << std::endl;
+        return 1;
+    }
+
+    if (originalRef.fileFullPath != originalPath || copyRef.fileFullPath != copyPath)
+    {
+        std::cerr << "buffers don't have the path they were loaded from" << std::endl;
+        return 1;
+    }
+
+    if (otherRef.data == originalRef.data)
+    {
+        std::cerr << "different files share the same audio buffer" << std::endl;
+        return 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The hit grid is shared too, and holds the loudest decibels around each stored value.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    if (otherRef.hitGrid == nullptr || originalRef.hitGrid != copyRef.hitGrid)
+    {
+        std::cerr << "identical files don't share their hit grid" << std::endl;
+        return 1;
+    }
+
+    int numFfts = FftRunner::getNumFftFromNumSamples(otherRef.getNumSamples());
+    int channelSize = numFfts * FFT_STORAGE_SCOPE_SIZE;
+    for (int channel = 0; channel < otherRef.getNumChannels(); channel++)
+    {
+        for (int fft = 0; fft < numFfts; fft++)
+        {
+            for (int freq = 0; freq < FFT_STORAGE_SCOPE_SIZE; freq++)
+            {
+                int fftDataIndex = (channel * channelSize) + freq;
+                float storedDb = (*otherRef.storedFftData)[(size_t)(fftDataIndex + (fft * FFT_STORAGE_SCOPE_SIZE))];
+                if (otherRef.hitGrid->getMaxDb(fftDataIndex, fft) < storedDb)
+                {
+                    std::cerr << "the hit grid is quieter than the ffts it was built from" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    if (otherRef.hitGrid->getNumBytes() * 16 > otherRef.storedFftData->size() * sizeof(float))
+    {
+        std::cerr << "the hit grid is not much smaller than the ffts" << std::endl;
+        return 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The storage format, read with interpolation indexes and weights computed once,
+    //// must be exactly what interpolating each bin of each FFT on its own gives.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    juce::SharedResourcePointer<FftRunner> fftRunner;
+    auto rawFfts = fftRunner->performFft(otherRef.data);
+    auto storedFfts = store->copyRawFFTsToStorageFormat(rawFfts);
+    size_t numRawFfts = rawFfts->size() / FFT_OUTPUT_NO_FREQS;
+    if (storedFfts->size() != numRawFfts * FFT_STORAGE_SCOPE_SIZE)
+    {
+        std::cerr << "the stored ffts don't have the expected size" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < numRawFfts; i++)
+    {
+        for (size_t j = 0; j < FFT_STORAGE_SCOPE_SIZE; j++)
+        {
+            float logIndexFft = UnitConverter::magnifyFftIndex(float(j));
+            size_t belowIndex = juce::jmin((size_t)std::floor(logIndexFft), (size_t)(FFT_OUTPUT_NO_FREQS - 1));
+            size_t aboveIndex = juce::jmin((size_t)std::ceil(logIndexFft), (size_t)(FFT_OUTPUT_NO_FREQS - 1));
+            float interpolationPosition = logIndexFft - std::floor(logIndexFft);
+            float expected = ((*rawFfts)[(i * FFT_OUTPUT_NO_FREQS) + belowIndex] * (1.0f - interpolationPosition)) +
+                             ((*rawFfts)[(i * FFT_OUTPUT_NO_FREQS) + aboveIndex] * interpolationPosition);
+            if ((*storedFfts)[(i * FFT_STORAGE_SCOPE_SIZE) + j] != expected)
+            {
+                std::cerr << "stored fft " << i << " differs from the per bin interpolation at index " << j
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // the copy was deleted, so this must come from the path index
+    AudioFileBufferRef reloadedRef = store->loadSample(copyPath);
+    if (reloadedRef.data != originalRef.data || reloadedRef.fileFullPath != copyPath)
+    {
+        std::cerr << "loading an alias path again didn't reuse the cached buffer" << std::endl;
+        return 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// A shared buffer is released once none of its aliases are referenced anymore.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    std::weak_ptr<juce::AudioSampleBuffer> sharedBuffer = originalRef.data;
+    std::weak_ptr<juce::AudioSampleBuffer> otherBuffer = otherRef.data;
+
+    originalRef = AudioFileBufferRef();
+    store->releaseUnusedBuffers();
+    if (sharedBuffer.expired())
+    {
+        std::cerr << "a buffer was released while an alias still used it" << std::endl;
+        return 1;
+    }
+
+    copyRef = AudioFileBufferRef();
+    reloadedRef = AudioFileBufferRef();
+    store->releaseUnusedBuffers();
+    if (!sharedBuffer.expired())
+    {
+        std::cerr << "an unused shared buffer was not released" << std::endl;
+        return 1;
+    }
+
+    if (otherBuffer.expired())
+    {
+        std::cerr << "a used buffer was released" << std::endl;
+        return 1;
+    }
+
+    // the aliases of released buffers must be forgotten too
+    bool threw = false;
+    try
+    {
+        store->loadSample(copyPath);
+    }
+    catch (std::runtime_error &)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        std::cerr << "the path of a released buffer was still cached" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -79,6 +79,25 @@ int testConfig1()
         return 1;
     }
 
+    if (cfg1.isInMemoryCompressionEnabled() != true)
+    {
+        std::cout << "unable to parse in memory compression setting" << std::endl;
+        return 1;
+    }
+
+    if (cfg1.getFreezeMemoryMb() != 128)
+    {
+        std::cout << "unable to parse freeze memory setting" << std::endl;
+        return 1;
+    }
+
+    if (cfg1.getSpectrogramMinDb() != -48.0f || cfg1.getSpectrogramMaxDb() != MAX_DB ||
+        !cfg1.isSpectrogramColormapEnabled() || cfg1.getSpectrogramGpuMemoryMb() != 256)
+    {
+        std::cout << "unable to parse spectrogram display settings" << std::endl;
+        return 1;
+    }
+
     return 0;
 }
 
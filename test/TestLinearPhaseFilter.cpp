@@ -0,0 +1,241 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include "../src/Audio/LinearPhaseFilter.h"
+#include "../src/Config.h"
+
+// how many seconds of audio the benchmark filters
+#define BENCHMARK_SECONDS 20
+// size of the blocks the benchmark processes, like an audio callback would
+#define BENCHMARK_BLOCK_SIZE 512
+
+/**
+ * @brief      Filter a sine with the filter and return its amplitude in dB once the filter settled.
+ */
+float sineResponseDb(LinearPhaseFilter &filter, float freq)
+{
+    int length = LINEAR_PHASE_FILTER_TAPS * 4;
+    juce::AudioSampleBuffer buffer(2, length);
+    for (int i = 0; i < length; i++)
+    {
+        float value = std::sin(2.0f * float(M_PI) * freq * float(i) / float(AUDIO_FRAMERATE));
+        buffer.setSample(0, i, value);
+        buffer.setSample(1, i, value);
+    }
+
+    filter.reset();
+    filter.processSamples(juce::AudioSourceChannelInfo(&buffer, 0, length));
+
+    // skip the part where the filter history is not full yet
+    int settled = LINEAR_PHASE_FILTER_TAPS + LINEAR_PHASE_FILTER_LATENCY;
+    float peak = buffer.getMagnitude(0, settled, length - settled);
+    return 20.0f * std::log10(juce::jmax(peak, 1e-9f));
+}
+
+int main()
+{
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The filter must let the passband through and cut the stopband as much as the
+    //// IIR cascade with the same repeat count would.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    auto kernel = std::make_shared<const LinearPhaseKernel>(100.0f, SAMPLEPLAYER_MAX_FILTER_REPEAT, 2000.0f,
+                                                            SAMPLEPLAYER_MAX_FILTER_REPEAT);
+    LinearPhaseFilter filter(kernel, 2);
+
+    float passbandDb = sineResponseDb(filter, 500.0f);
+    if (std::abs(passbandDb) > 0.5f)
+    {
+        std::cerr << "passband gain is " << passbandDb << " dB instead of 0 dB" << std::endl;
+        return 1;
+    }
+
+    float stopbandDb = sineResponseDb(filter, 8000.0f);
+    if (stopbandDb > -40.0f)
+    {
+        std::cerr << "stopband gain is only " << stopbandDb << " dB" << std::endl;
+        return 1;
+    }
+
+    float lowStopbandDb = sineResponseDb(filter, 25.0f);
+    if (lowStopbandDb > -40.0f)
+    {
+        std::cerr << "high pass stopband gain is only " << lowStopbandDb << " dB" << std::endl;
+        return 1;
+    }
+    std::cerr << "filter gains: passband " << passbandDb << " dB, stopbands " << lowStopbandDb << " dB and "
+              << stopbandDb << " dB" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The impulse response must be symmetric around the announced latency, which is
+    //// what makes the filter phase linear.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    int impulseLength = LINEAR_PHASE_FILTER_LATENCY * 2 + 1;
+    juce::AudioSampleBuffer impulse(2, impulseLength);
+    impulse.clear();
+    impulse.setSample(0, 0, 1.0f);
+    impulse.setSample(1, 0, 1.0f);
+
+    filter.reset();
+    // use odd sized blocks to check the block bookkeeping
+    for (int start = 0; start < impulseLength; start += 77)
+    {
+        int length = juce::jmin(77, impulseLength - start);
+        filter.processSamples(juce::AudioSourceChannelInfo(&impulse, start, length));
+    }
+
+    int peakPosition = 0;
+    for (int i = 0; i < impulseLength; i++)
+    {
+        if (std::abs(impulse.getSample(0, i)) > std::abs(impulse.getSample(0, peakPosition)))
+        {
+            peakPosition = i;
+        }
+    }
+    if (peakPosition != LINEAR_PHASE_FILTER_LATENCY)
+    {
+        std::cerr << "impulse response peaks at " << peakPosition << " instead of " << LINEAR_PHASE_FILTER_LATENCY
+                  << std::endl;
+        return 1;
+    }
+    for (int i = 1; i < (LINEAR_PHASE_FILTER_TAPS >> 1); i++)
+    {
+        float before = impulse.getSample(0, LINEAR_PHASE_FILTER_LATENCY - i);
+        float after = impulse.getSample(0, LINEAR_PHASE_FILTER_LATENCY + i);
+        if (std::abs(before - after) > 1e-5f)
+        {
+            std::cerr << "impulse response is not symmetric at distance " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cerr << "impulse response is symmetric around " << LINEAR_PHASE_FILTER_LATENCY << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Over many blocks, so that every slot of the spectrum history is written and read,
+    //// the output must be the direct convolution of the input with the impulse response.
+    //// A filter taking over the state of another one must go on with the same output.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    int signalLength = LINEAR_PHASE_FILTER_TAPS * 3;
+    juce::AudioSampleBuffer signal(2, signalLength);
+    juce::Random signalRandom(7);
+    for (int chan = 0; chan < 2; chan++)
+    {
+        for (int i = 0; i < signalLength; i++)
+        {
+            signal.setSample(chan, i, (signalRandom.nextFloat() * 2.0f) - 1.0f);
+        }
+    }
+
+    juce::AudioSampleBuffer filtered(signal);
+    juce::AudioSampleBuffer copyFiltered(signal);
+    LinearPhaseFilter copyFilter(kernel, 2);
+    filter.reset();
+    // the switch happens between two of the 300 frames blocks, in the middle of a filter block
+    int switchPosition = 300 * 20;
+    for (int start = 0; start < signalLength; start += 300)
+    {
+        int length = juce::jmin(300, signalLength - start);
+        if (start == switchPosition)
+        {
+            copyFilter.copyStateFrom(filter);
+        }
+        filter.processSamples(juce::AudioSourceChannelInfo(&filtered, start, length));
+        if (start >= switchPosition)
+        {
+            copyFilter.processSamples(juce::AudioSourceChannelInfo(&copyFiltered, start, length));
+        }
+    }
+
+    for (int i = 0; i < signalLength; i++)
+    {
+        for (int chan = 0; chan < 2; chan++)
+        {
+            double expected = 0.0;
+            for (int k = 0; k < juce::jmin(impulseLength, i + 1); k++)
+            {
+                expected += double(impulse.getSample(0, k)) * double(signal.getSample(chan, i - k));
+            }
+            if (std::abs(float(expected) - filtered.getSample(chan, i)) > 1e-3f)
+            {
+                std::cerr << "filter output differs from the direct convolution in channel " << chan << " at frame "
+                          << i << std::endl;
+                return 1;
+            }
+            if (i >= switchPosition && copyFiltered.getSample(chan, i) != filtered.getSample(chan, i))
+            {
+                std::cerr << "filter with a copied state differs in channel " << chan << " at frame " << i
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cerr << "filter output matches the direct convolution over " << (signalLength / LINEAR_PHASE_FILTER_BLOCK_SIZE)
+              << " blocks" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Benchmark the filter against the SamplePlayer IIR cascade at the same steepness
+    //// (SAMPLEPLAYER_MAX_FILTER_REPEAT high pass and low pass stages per channel).
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    int benchmarkLength = BENCHMARK_SECONDS * AUDIO_FRAMERATE;
+    juce::AudioSampleBuffer noise(2, benchmarkLength);
+    juce::Random random(42);
+    for (int chan = 0; chan < 2; chan++)
+    {
+        for (int i = 0; i < benchmarkLength; i++)
+        {
+            noise.setSample(chan, i, (random.nextFloat() * 2.0f) - 1.0f);
+        }
+    }
+    juce::AudioSampleBuffer work(noise);
+
+    juce::IIRFilter highPassFilters[2][SAMPLEPLAYER_MAX_FILTER_REPEAT];
+    juce::IIRFilter lowPassFilters[2][SAMPLEPLAYER_MAX_FILTER_REPEAT];
+    for (int chan = 0; chan < 2; chan++)
+    {
+        for (int i = 0; i < SAMPLEPLAYER_MAX_FILTER_REPEAT; i++)
+        {
+            highPassFilters[chan][i].setCoefficients(juce::IIRCoefficients::makeHighPass(AUDIO_FRAMERATE, 100.0));
+            lowPassFilters[chan][i].setCoefficients(juce::IIRCoefficients::makeLowPass(AUDIO_FRAMERATE, 2000.0));
+        }
+    }
+
+    auto iirStart = std::chrono::steady_clock::now();
+    for (int start = 0; start < benchmarkLength; start += BENCHMARK_BLOCK_SIZE)
+    {
+        int length = juce::jmin(BENCHMARK_BLOCK_SIZE, benchmarkLength - start);
+        for (int chan = 0; chan < 2; chan++)
+        {
+            float *samples = work.getWritePointer(chan, start);
+            for (int i = 0; i < SAMPLEPLAYER_MAX_FILTER_REPEAT; i++)
+            {
+                highPassFilters[chan][i].processSamples(samples, length);
+            }
+            for (int i = 0; i < SAMPLEPLAYER_MAX_FILTER_REPEAT; i++)
+            {
+                lowPassFilters[chan][i].processSamples(samples, length);
+            }
+        }
+    }
+    float iirMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - iirStart).count();
+
+    work.makeCopyOf(noise);
+    filter.reset();
+    auto fftStart = std::chrono::steady_clock::now();
+    for (int start = 0; start < benchmarkLength; start += BENCHMARK_BLOCK_SIZE)
+    {
+        int length = juce::jmin(BENCHMARK_BLOCK_SIZE, benchmarkLength - start);
+        filter.processSamples(juce::AudioSourceChannelInfo(&work, start, length));
+    }
+    float fftMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - fftStart).count();
+
+    std::cerr << "filtering " << BENCHMARK_SECONDS << "s of stereo audio with " << SAMPLEPLAYER_MAX_FILTER_REPEAT
+              << " stages per filter: IIR cascade " << iirMs << " ms, linear phase FFT " << fftMs << " ms ("
+              << (fftMs / juce::jmax(iirMs, 0.001f)) << "x)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <thread>
+
+#include "../src/Audio/AudioLoadMeter.h"
+#include "../src/Audio/MixbusDataSource.h"
+#include "../src/Audio/TripleBuffer.h"
+#include "../src/Config.h"
+
+int main()
+{
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The triple buffer must give the latest published value and report when nothing
+    //// new was published.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    TripleBuffer<int> channel;
+    if (channel.update())
+    {
+        std::cerr << "triple buffer reported a fresh value before any publish" << std::endl;
+        return 1;
+    }
+    channel.write(1);
+    channel.write(2);
+    channel.write(3);
+    if (channel.read() != 3)
+    {
+        std::cerr << "triple buffer did not return the latest published value" << std::endl;
+        return 1;
+    }
+    if (channel.update() || channel.getReadBuffer() != 3)
+    {
+        std::cerr << "triple buffer lost the read value after a fetch without publish" << std::endl;
+        return 1;
+    }
+    std::cerr << "triple buffer returned latest values" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// A reader on another thread must never see a partially written value.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    TripleBuffer<std::pair<int, int>> pairChannel;
+    std::thread writer([&pairChannel]() {
+        for (int i = 0; i < 1000000; i++)
+        {
+            pairChannel.write(std::pair<int, int>(i, -i));
+        }
+    });
+    int lastRead = 0;
+    for (int i = 0; i < 1000000; i++)
+    {
+        auto value = pairChannel.read();
+        if (value.first != -value.second)
+        {
+            std::cerr << "triple buffer reader saw a torn value" << std::endl;
+            writer.join();
+            return 1;
+        }
+        if (value.first < lastRead)
+        {
+            std::cerr << "triple buffer reader went back in time" << std::endl;
+            writer.join();
+            return 1;
+        }
+        lastRead = value.first;
+    }
+    writer.join();
+    std::cerr << "triple buffer had no torn reads" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Vu meters values published by the audio thread must be readable by the UI.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    MixbusDataSource dataSource;
+    VuMeterData volumes;
+    volumes[VUMETER_ID_MASTER] = std::pair<float, float>(-6.0f, -12.0f);
+    dataSource.publishVuMeterValues(volumes);
+    auto masterVolume = dataSource.getVuMeterValue(VUMETER_ID_MASTER);
+    if (!masterVolume.hasValue() || masterVolume->first != -6.0f || masterVolume->second != -12.0f)
+    {
+        std::cerr << "published vu meter value was not read back" << std::endl;
+        return 1;
+    }
+    std::cerr << "vu meter values went through" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The selected tracks bitmask must follow selection updates.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    std::set<size_t> selection = {0, 63, 64, SAMPLE_MAX_PLAYERS_USED};
+    dataSource.updateSelectedTracks(selection);
+    for (size_t i = 0; i <= SAMPLE_MAX_PLAYERS_USED + 1; i++)
+    {
+        if (dataSource.isTrackSelected(i) != (selection.find(i) != selection.end()))
+        {
+            std::cerr << "wrong selection state for track " << i << std::endl;
+            return 1;
+        }
+    }
+
+    uint64_t generationBeforeUpdate = dataSource.getSelectionGeneration();
+    std::set<size_t> newSelection = {64, 1000};
+    dataSource.updateSelectedTracks(newSelection);
+    if (dataSource.getSelectionGeneration() == generationBeforeUpdate)
+    {
+        std::cerr << "selection generation was not incremented by the update" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i <= SAMPLE_MAX_PLAYERS_USED; i++)
+    {
+        if (dataSource.isTrackSelected(i) != (newSelection.find(i) != newSelection.end()))
+        {
+            std::cerr << "wrong selection state after update for track " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cerr << "selection bitmask followed updates" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// A reader seeing the same even generation before and after reading the bits
+    //// must never see a mix of two selections.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    if (MixbusDataSource::isSelectionBeingUpdated(dataSource.getSelectionGeneration()))
+    {
+        std::cerr << "selection generation is odd while no update is running" << std::endl;
+        return 1;
+    }
+
+    std::set<size_t> firstSelection = {1};
+    std::set<size_t> secondSelection = {2};
+    dataSource.updateSelectedTracks(secondSelection);
+    std::atomic<bool> selectionWriterDone(false);
+    std::thread selectionWriter([&]() {
+        for (int i = 0; i < 100000; i++)
+        {
+            dataSource.updateSelectedTracks(i % 2 == 0 ? firstSelection : secondSelection);
+        }
+        selectionWriterDone = true;
+    });
+
+    int consistentReads = 0;
+    int mixedReads = 0;
+    while (!selectionWriterDone)
+    {
+        uint64_t generation = dataSource.getSelectionGeneration();
+        if (MixbusDataSource::isSelectionBeingUpdated(generation))
+        {
+            continue;
+        }
+        bool firstSelected = dataSource.isTrackSelected(1);
+        bool secondSelected = dataSource.isTrackSelected(2);
+        if (dataSource.getSelectionGeneration() != generation)
+        {
+            continue;
+        }
+        consistentReads++;
+        if (firstSelected == secondSelected)
+        {
+            mixedReads++;
+        }
+    }
+    selectionWriter.join();
+
+    if (mixedReads != 0)
+    {
+        std::cerr << mixedReads << " of " << consistentReads << " selection reads mixed two selections" << std::endl;
+        return 1;
+    }
+    std::cerr << "selection reads were consistent (" << consistentReads << " reads)" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Callbacks longer than the audio they compute must be counted as deadline misses,
+    //// and the count must survive a reset.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    AudioLoadMeter loadMeter;
+    // 441 frames at 44100Hz must be computed in 10ms
+    if (loadMeter.recordCallback(20000.0f, 441, 0.0))
+    {
+        std::cerr << "load recorded without a sample rate" << std::endl;
+        return 1;
+    }
+    loadMeter.recordCallback(5000.0f, 441, 44100.0);
+    if (loadMeter.getLoad().deadlineMisses != 0 || std::abs(loadMeter.getLoad().loadPercent - 50.0f) > 0.01f)
+    {
+        std::cerr << "wrong load for a callback within its deadline" << std::endl;
+        return 1;
+    }
+    loadMeter.recordCallback(15000.0f, 441, 44100.0);
+    loadMeter.recordCallback(10001.0f, 441, 44100.0);
+    loadMeter.recordCallback(9999.0f, 441, 44100.0);
+    if (loadMeter.getLoad().deadlineMisses != 2)
+    {
+        std::cerr << "expected 2 deadline misses, got " << loadMeter.getLoad().deadlineMisses << std::endl;
+        return 1;
+    }
+
+    loadMeter.reset();
+    if (loadMeter.getLoad().deadlineMisses != 2 || loadMeter.getLoad().loadPercent != 0.0f)
+    {
+        std::cerr << "reset must clear the loads and keep the deadline misses" << std::endl;
+        return 1;
+    }
+    std::cerr << "deadline misses were counted" << std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Peak, histogram and costliest player are only published once a window is complete.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    loadMeter.recordPlayerCost(3, 5.0f, 0);
+    loadMeter.recordPlayerCost(7, 100.0f, 4);
+    loadMeter.recordCallback(8000.0f, AUDIO_LOAD_WINDOW_FRAMES / 2, 44100.0);
+    if (loadMeter.getLoad().costliestPlayerId != -1 || loadMeter.getLoad().peakLoadPercent != 0.0f)
+    {
+        std::cerr << "window values were published before the window was complete" << std::endl;
+        return 1;
+    }
+    loadMeter.recordCallback(1000.0f, AUDIO_LOAD_WINDOW_FRAMES / 2, 44100.0);
+    const AudioCallbackLoad &load = loadMeter.getLoad();
+    // 5us goes in the first bucket, 100us in the one up to 128us
+    if (load.costliestPlayerId != 7 || load.costliestPlayerFilterStages != 4 || load.playerCostHistogram[0] != 1 ||
+        load.playerCostHistogram[4] != 1 || load.worstCallbackMicros != 8000.0f)
+    {
+        std::cerr << "wrong window values published" << std::endl;
+        return 1;
+    }
+    std::cerr << "load window values were published" << std::endl;
+
+    return 0;
+}
@@ -102,8 +102,176 @@ int testSamplePlayerWithSample(std::string path, int blockSize, int offset, int
         }
     }
 
+    // now freeze the sample and check that playing the frozen output gives the same audio
+    newSample->freeze();
+    if (newSample->isFreezeStale())
+    {
+        std::cerr << "sample frozen output is stale right after freezing" << std::endl;
+        return 1;
+    }
+
+    juce::AudioBuffer<float> frozenAudioBuffer(2, testBufferSize);
+    frozenAudioBuffer.clear();
+    newSample->setNextReadPosition(0);
+    testReadPosition = 0;
+    while (testReadPosition < bufferSize + offset)
+    {
+        const juce::AudioSourceChannelInfo audioSourceInfo(&frozenAudioBuffer, testReadPosition, blockSize);
+        newSample->getNextAudioBlock(audioSourceInfo);
+        testReadPosition += blockSize;
+    }
+
+    for (int i = 0; i < testBufferSize; i++)
+    {
+        for (int chan = 0; chan < 2; chan++)
+        {
+            float liveAudio = audioBuffer.getReadPointer(chan)[i];
+            float frozenAudio = frozenAudioBuffer.getReadPointer(chan)[i];
+            if (std::abs(liveAudio - frozenAudio) > 0.00001f)
+            {
+                std::cerr << "Frozen audio differ in channel " << chan << " at sample number " << i << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // the memory accounting used for the freeze budget must match the rendered buffer
+    if (newSample->getFrozenBufferBytes() != newSample->getFreezeBytes())
+    {
+        std::cerr << "frozen buffer takes " << newSample->getFrozenBufferBytes() << " bytes, expected "
+                  << newSample->getFreezeBytes() << std::endl;
+        return 1;
+    }
+
+    // an evicted sample must not be frozen again until its parameters change
+    newSample->evictFrozenBuffer();
+    if (!newSample->isFreezeEvicted() || newSample->getFrozenBufferBytes() != 0)
+    {
+        std::cerr << "frozen buffer was not evicted" << std::endl;
+        return 1;
+    }
+
+    // any parameter change must invalidate the frozen output
+    newSample->setLowPassFreq(1000);
+    if (!newSample->isFreezeStale() || newSample->isFreezeEvicted())
+    {
+        std::cerr << "sample frozen output not invalidated by a filter change" << std::endl;
+        return 1;
+    }
+
+    // with linear phase filters, the output after a seek must be the same as when playing continuously
+    newSample->setLinearPhaseFiltering(true);
+    juce::AudioBuffer<float> linearPhaseAudioBuffer(2, testBufferSize);
+    linearPhaseAudioBuffer.clear();
+    newSample->setNextReadPosition(0);
+    testReadPosition = 0;
+    while (testReadPosition < bufferSize + offset)
+    {
+        const juce::AudioSourceChannelInfo audioSourceInfo(&linearPhaseAudioBuffer, testReadPosition, blockSize);
+        newSample->getNextAudioBlock(audioSourceInfo);
+        testReadPosition += blockSize;
+    }
+
+    juce::AudioBuffer<float> seekAudioBuffer(2, blockSize);
+    auto seekBlockMatches = [&](int blockPosition, std::string description) {
+        for (int i = 0; i < blockSize; i++)
+        {
+            for (int chan = 0; chan < 2; chan++)
+            {
+                float continuousAudio = linearPhaseAudioBuffer.getReadPointer(chan)[blockPosition + i];
+                float seekAudio = seekAudioBuffer.getReadPointer(chan)[i];
+                if (std::abs(continuousAudio - seekAudio) > 0.0001f)
+                {
+                    std::cerr << "Linear phase audio after " << description << " differ in channel " << chan
+                              << " at sample number " << i << std::endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // a jump prepared in the background plays the right audio from the first callback
+    int seekPosition = (bufferSize / 2) - ((bufferSize / 2) % blockSize);
+    newSample->prepareLinearPhaseFilterAt(seekPosition);
+    newSample->setNextReadPosition(seekPosition);
+    newSample->getNextAudioBlock(juce::AudioSourceChannelInfo(&seekAudioBuffer, 0, blockSize));
+    if (!seekBlockMatches(seekPosition, "prepared seek"))
+    {
+        return 1;
+    }
+
+    // an unexpected jump is primed over several callbacks that play silence
+    int unpreparedSeekPosition = (bufferSize / 4) - ((bufferSize / 4) % blockSize);
+    newSample->setNextReadPosition(unpreparedSeekPosition);
+    newSample->getNextAudioBlock(juce::AudioSourceChannelInfo(&seekAudioBuffer, 0, blockSize));
+    if (seekAudioBuffer.getMagnitude(0, blockSize) != 0.0f)
+    {
+        std::cerr << "Linear phase filter was primed in a single callback" << std::endl;
+        return 1;
+    }
+    int primingCallbacks = LINEAR_PHASE_FILTER_PRIMING_FRAMES /
+                           (LINEAR_PHASE_FILTER_PRIMING_BLOCKS_PER_CALLBACK * LINEAR_PHASE_FILTER_BLOCK_SIZE);
+    for (int i = 0; i < primingCallbacks; i++)
+    {
+        newSample->getNextAudioBlock(juce::AudioSourceChannelInfo(&seekAudioBuffer, 0, blockSize));
+    }
+    newSample->getNextAudioBlock(juce::AudioSourceChannelInfo(&seekAudioBuffer, 0, blockSize));
+    if (!seekBlockMatches(unpreparedSeekPosition + ((primingCallbacks + 1) * blockSize), "unprepared seek"))
+    {
+        return 1;
+    }
+
+    // changing the filters while playing goes on from the filter history instead of priming again
+    int filterChangePosition = unpreparedSeekPosition + ((primingCallbacks + 2) * blockSize);
+    newSample->setLowPassFreq(2000);
+    newSample->getNextAudioBlock(juce::AudioSourceChannelInfo(&seekAudioBuffer, 0, blockSize));
+    if (linearPhaseAudioBuffer.getMagnitude(0, filterChangePosition, blockSize) > 0.0f &&
+        seekAudioBuffer.getMagnitude(0, blockSize) == 0.0f)
+    {
+        std::cerr << "Linear phase filter was primed again after a filter change" << std::endl;
+        return 1;
+    }
+
     delete newSample;
 
+    // a player reading the same audio kept compressed in memory must output the exact same frames
+    AudioFileBufferRef compressedBuffer(newBuffer);
+    compressedBuffer.compressedData = std::make_shared<const CompressedAudioBuffer>(*newBuffer.data);
+    compressedBuffer.data = nullptr;
+    std::cerr << "compressed audio takes " << compressedBuffer.compressedData->getNumBytes() << " bytes instead of "
+              << (size_t)bufferSize * (size_t)newBuffer.data->getNumChannels() * sizeof(float) << std::endl;
+
+    SamplePlayer *compressedSample = new SamplePlayer(offset);
+    compressedSample->setBuffer(compressedBuffer);
+    compressedSample->setBufferShift(startShift);
+    compressedSample->setGainRamp(0.0f);
+    compressedSample->setNextReadPosition(0);
+
+    juce::AudioBuffer<float> compressedAudioBuffer(2, testBufferSize);
+    compressedAudioBuffer.clear();
+    testReadPosition = 0;
+    while (testReadPosition < bufferSize + offset)
+    {
+        const juce::AudioSourceChannelInfo audioSourceInfo(&compressedAudioBuffer, testReadPosition, blockSize);
+        compressedSample->getNextAudioBlock(audioSourceInfo);
+        testReadPosition += blockSize;
+    }
+
+    for (int i = 0; i < testBufferSize; i++)
+    {
+        for (int chan = 0; chan < 2; chan++)
+        {
+            if (audioBuffer.getReadPointer(chan)[i] != compressedAudioBuffer.getReadPointer(chan)[i])
+            {
+                std::cerr << "Compressed audio differ in channel " << chan << " at sample number " << i << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    delete compressedSample;
+
     return 0;
 }
 
@@ -54,9 +54,13 @@ int main()
     auto sp1 = loadFile("../test/TestSamples/A-sines-stereo.wav");
     auto sp2 = loadFile("../test/TestSamples/rise-up-sine.wav");
     auto sp3 = loadFile("../test/TestSamples/rise-up-sine.wav");
+    auto sp4 = loadFile("../test/TestSamples/rise-up-sine.wav");
 
+    // textures are found by the digest of the audio, so the buffer reference is rebuilt after altering it
     sp3->getBufferRef().data->getWritePointer(0)[1024] = 0.1f;
     sp3->getBufferRef().data->getWritePointer(0)[1025] = 0.3f;
+    AudioFileBufferRef alteredBuffer(sp3->getBufferRef().data, sp3->getBufferRef().fileFullPath, sp3->getFftData());
+    sp3->setBuffer(alteredBuffer);
 
     TextureManager textureManager;
     textureManager.setOpenGlContext(nullptr); /**< set garbage just to avoid exceptions */
@@ -74,8 +78,8 @@ int main()
         return 1;
     }
 
-    textureManager.setTexture(10, sp1, sp1->getFftData());
-    textureManager.setTexture(11, sp2, sp1->getFftData());
+    textureManager.setTexture(10, sp1);
+    textureManager.setTexture(11, sp2);
 
     bool foundSome = textureManager.getTextureIdentifier(sp1).hasValue();
     unsigned int foundId = *textureManager.getTextureIdentifier(sp1);
@@ -91,6 +95,12 @@ int main()
         return 1;
     }
 
+    if (!textureManager.getTextureIdentifier(sp4).hasValue() || *textureManager.getTextureIdentifier(sp4) != 11)
+    {
+        std::cerr << "separately loaded copy of sp2 was not matched to its texture" << std::endl;
+        return 1;
+    }
+
     if (textureManager.getTextureIdentifier(sp3))
     {
         std::cerr << "Altered copy of sp1 was matched to it despise different signal values" << std::endl;
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/Arrangement/SampleSpatialIndex.h"
+#include "../src/Config.h"
+#include "../src/OpenGL/TimeRangeIndex.h"
+
+// number of samples of the stress arrangement
+#define STRESS_SAMPLES 5000
+
+struct TestRange
+{
+    float start;
+    float end;
+    bool present;
+};
+
+std::vector<int> findOverlappingBruteForce(std::vector<TestRange> &ranges, float start, float end)
+{
+    std::vector<int> ids;
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        if (ranges[i].present && ranges[i].start <= end && ranges[i].end >= start)
+        {
+            ids.push_back((int)i);
+        }
+    }
+    return ids;
+}
+
+bool checkQuery(TimeRangeIndex &index, std::vector<TestRange> &ranges, float start, float end)
+{
+    std::vector<int> ids;
+    index.findOverlapping(start, end, ids);
+    std::sort(ids.begin(), ids.end());
+    std::vector<int> expected = findOverlappingBruteForce(ranges, start, end);
+    if (ids != expected)
+    {
+        std::cerr << "wrong overlapping ranges between " << start << " and " << end << ": got " << ids.size()
+                  << " ranges instead of " << expected.size() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937 generator(42);
+    // samples from a few milliseconds to a minute over an hour long arrangement
+    std::uniform_real_distribution<float> positionDistribution(0.0f, 3600.0f * AUDIO_FRAMERATE);
+    std::uniform_real_distribution<float> lengthDistribution(100.0f, 60.0f * AUDIO_FRAMERATE);
+
+    TimeRangeIndex index;
+    std::vector<TestRange> ranges(STRESS_SAMPLES);
+    for (int i = 0; i < STRESS_SAMPLES; i++)
+    {
+        float start = positionDistribution(generator);
+        ranges[(size_t)i] = {start, start + lengthDistribution(generator), true};
+        index.setRange(i, ranges[(size_t)i].start, ranges[(size_t)i].end);
+    }
+
+    // one very long sample must not hide the others
+    ranges[0] = {0.0f, 3700.0f * AUDIO_FRAMERATE, true};
+    index.setRange(0, ranges[0].start, ranges[0].end);
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The index must find the same ranges as a linear scan.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    for (int i = 0; i < 200; i++)
+    {
+        float start = positionDistribution(generator);
+        if (!checkQuery(index, ranges, start, start + (1920.0f * FREQVIEW_MAX_SCALE_FRAME_PER_PIXEL)))
+        {
+            return 1;
+        }
+    }
+
+    // bounds are included
+    if (!checkQuery(index, ranges, ranges[1].end, ranges[1].end) ||
+        !checkQuery(index, ranges, ranges[2].start - 10.0f, ranges[2].start))
+    {
+        return 1;
+    }
+
+    // move and remove some ranges
+    for (int i = 0; i < STRESS_SAMPLES; i += 3)
+    {
+        if (i % 2 == 0)
+        {
+            ranges[(size_t)i].present = false;
+            index.removeRange(i);
+        }
+        else
+        {
+            ranges[(size_t)i].start += 1000.0f;
+            ranges[(size_t)i].end += 1000.0f;
+            index.setRange(i, ranges[(size_t)i].start, ranges[(size_t)i].end);
+        }
+    }
+
+    for (int i = 0; i < 200; i++)
+    {
+        float start = positionDistribution(generator);
+        if (!checkQuery(index, ranges, start, start + (1920.0f * FREQVIEW_MIN_SCALE_FRAME_PER_PIXEL)))
+        {
+            return 1;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Ranges moved step by step like a drag, over and past others and onto the same
+    //// start as others, must be found at their new place after each step.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    std::uniform_int_distribution<int> idDistribution(0, STRESS_SAMPLES - 1);
+    for (int step = 0; step < 300; step++)
+    {
+        int id = idDistribution(generator);
+        int otherId = idDistribution(generator);
+        if (step % 3 == 0)
+        {
+            ranges[(size_t)id].start = ranges[(size_t)otherId].start;
+            ranges[(size_t)id].end = ranges[(size_t)id].start + lengthDistribution(generator);
+        }
+        else
+        {
+            float shift = (step % 3 == 1 ? 1.0f : -1.0f) * lengthDistribution(generator);
+            ranges[(size_t)id].start += shift;
+            ranges[(size_t)id].end += shift;
+        }
+        ranges[(size_t)id].present = true;
+        index.setRange(id, ranges[(size_t)id].start, ranges[(size_t)id].end);
+
+        float start = ranges[(size_t)otherId].start - 1000.0f;
+        if (!checkQuery(index, ranges, start, start + (1920.0f * FREQVIEW_MIN_SCALE_FRAME_PER_PIXEL)) ||
+            !checkQuery(index, ranges, ranges[(size_t)id].start, ranges[(size_t)id].start))
+        {
+            return 1;
+        }
+
+        if (step % 10 == 0)
+        {
+            ranges[(size_t)otherId].present = false;
+            index.removeRange(otherId);
+        }
+    }
+
+    int expectedSize = (int)std::count_if(ranges.begin(), ranges.end(), [](TestRange &r) { return r.present; });
+    if (index.size() != expectedSize)
+    {
+        std::cerr << "wrong number of ranges in index: " << index.size() << " instead of " << expectedSize
+                  << std::endl;
+        return 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// The sample index must rule out the samples found by time whose frequency band
+    //// doesn't overlap the searched one, bounds included.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    std::vector<int> ids;
+    SampleSpatialIndex sampleIndex;
+    // all the samples cover the same time range
+    sampleIndex.setSample(0, 0.0f, 1000.0f, 0.0f, 1.0f);
+    sampleIndex.setSample(1, 0.0f, 1000.0f, 0.0f, 0.3f);
+    sampleIndex.setSample(2, 0.0f, 1000.0f, 0.3f, 0.6f);
+    sampleIndex.setSample(3, 0.0f, 1000.0f, 0.7f, 1.0f);
+    sampleIndex.setSample(4, 2000.0f, 3000.0f, 0.0f, 1.0f);
+
+    struct BandQuery
+    {
+        float lowest;
+        float highest;
+        std::vector<int> expected;
+    };
+    std::vector<BandQuery> bandQueries = {{0.0f, 1.0f, {0, 1, 2, 3}},
+                                          {0.1f, 0.2f, {0, 1}},
+                                          {0.3f, 0.3f, {0, 1, 2}},
+                                          {0.61f, 0.69f, {0}},
+                                          {0.6f, 0.7f, {0, 2, 3}},
+                                          {0.9f, 1.0f, {0, 3}}};
+    for (auto &query : bandQueries)
+    {
+        sampleIndex.findSamples(500.0f, 600.0f, query.lowest, query.highest, ids);
+        if (ids != query.expected)
+        {
+            std::cerr << "wrong samples between frequency ratios " << query.lowest << " and " << query.highest
+                      << ": got " << ids.size() << " samples instead of " << query.expected.size() << std::endl;
+            return 1;
+        }
+    }
+
+    // changing the filters of a sample must move its band
+    sampleIndex.setSample(3, 0.0f, 1000.0f, 0.1f, 0.2f);
+    sampleIndex.findSamples(500.0f, 600.0f, 0.9f, 1.0f, ids);
+    if (ids != std::vector<int>({0}))
+    {
+        std::cerr << "sample frequency band was not updated" << std::endl;
+        return 1;
+    }
+
+    // without a band, all the samples overlapping the time range are found
+    sampleIndex.findSamples(500.0f, 2500.0f, ids);
+    if (ids != std::vector<int>({0, 1, 2, 3, 4}))
+    {
+        std::cerr << "wrong samples without frequency band: got " << ids.size() << " samples instead of 5"
+                  << std::endl;
+        return 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //// Report the culling of the stress arrangement for a full HD view at various zooms.
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    int zooms[] = {FREQVIEW_MIN_SCALE_FRAME_PER_PIXEL, 100, FREQVIEW_MAX_SCALE_FRAME_PER_PIXEL};
+    for (int framesPerPixel : zooms)
+    {
+        size_t totalVisible = 0;
+        auto before = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1000; i++)
+        {
+            // move one sample each frame, like a drag does
+            index.setRange(1, ranges[1].start + float(i), ranges[1].end + float(i));
+            float start = positionDistribution(generator);
+            index.findOverlapping(start, start + float(1920 * framesPerPixel), ids);
+            totalVisible += ids.size();
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before);
+        std::cerr << framesPerPixel << " frames per pixel: " << totalVisible / 1000 << " of " << index.size()
+                  << " samples drawn on average, " << elapsed.count() / 1000.0 << " us per culling" << std::endl;
+    }
+
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <iostream>
 
 #include "../src/Audio/UnitConverter.h"
@@ -107,4 +108,30 @@ int main()
         std::cerr << "fft to texture pipeline has too much diff on freq 4600: " << diff << std::endl;
         return 1;
     }
+
+    // the lookup tables must give what the functions compute, on their whole input range
+    for (int k = 0; k <= FFT_STORAGE_SCOPE_SIZE; k++)
+    {
+        diff = std::abs(UnitConverter::magnifyFftIndexAt(k) - UnitConverter::magnifyFftIndex(k));
+        diff += std::abs(UnitConverter::magnifyTextureFrequencyIndexAt(k) -
+                         UnitConverter::magnifyTextureFrequencyIndex(k));
+        if (diff > 0.001)
+        {
+            std::cerr << "lookup tables differ from the storage index functions at " << k << ": " << diff
+                      << std::endl;
+            return 1;
+        }
+    }
+    // out of the tables, the functions are computed
+    diff = std::abs(UnitConverter::magnifyFftIndexAt(-3) - UnitConverter::magnifyFftIndex(-3));
+    diff += std::abs(UnitConverter::magnifyTextureFrequencyIndexAt(FFT_STORAGE_SCOPE_SIZE + 10) -
+                     UnitConverter::magnifyTextureFrequencyIndex(FFT_STORAGE_SCOPE_SIZE + 10));
+    if (diff > 0.001)
+    {
+        std::cerr << "lookup tables differ from the functions out of their range: " << diff << std::endl;
+        return 1;
+    }
+    std::cerr << "lookup tables matched the functions!" << std::endl;
+
+    return 0;
 }
\ No newline at end of file